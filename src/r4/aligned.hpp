@@ -0,0 +1,202 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "vector.hpp"
+#include "matrix.hpp"
+
+namespace r4{
+
+/**
+ * @brief Size of a cache line in bytes.
+ * The value is typical for x86 and ARM processors.
+ */
+constexpr size_t cache_line_size = 64;
+
+/**
+ * @brief Allocator of over-aligned memory.
+ * Intended for std::vector of numbers or vectors which are processed with SIMD instructions.
+ * Default alignment is the cache line size, so the array starts at a cache line boundary,
+ * and, in case the element size divides the cache line size, no element crosses a cache line boundary.
+ * @tparam T - type of the allocated elements.
+ * @tparam A - alignment in bytes, must be a power of two not less than alignof(T).
+ */
+template <class T, size_t A = cache_line_size> class aligned_allocator{
+	static_assert((A & (A - 1)) == 0, "alignment must be a power of two");
+	static_assert(A >= alignof(T), "alignment must not be less than natural alignment of the type");
+
+public:
+	typedef T value_type;
+
+	/**
+	 * @brief Alignment of the allocated memory.
+	 */
+	static constexpr size_t alignment = A;
+
+	template <class TT> struct rebind{
+		typedef aligned_allocator<TT, A> other;
+	};
+
+	constexpr aligned_allocator()noexcept = default;
+
+	template <class TT> constexpr aligned_allocator(const aligned_allocator<TT, A>&)noexcept{}
+
+	/**
+	 * @brief Allocate memory.
+	 * @param n - number of elements to allocate memory for.
+	 * @return pointer to the allocated memory, aligned to A bytes.
+	 * @throw std::bad_alloc - in case the memory could not be allocated.
+	 */
+	T* allocate(size_t n){
+		if(n > std::numeric_limits<size_t>::max() / sizeof(T)){
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(A)));
+	}
+
+	/**
+	 * @brief Free memory.
+	 * @param p - pointer to the memory previously allocated by allocate().
+	 * @param n - number of elements passed to allocate().
+	 */
+	void deallocate(T* p, size_t n)noexcept{
+		::operator delete(p, n * sizeof(T), std::align_val_t(A));
+	}
+
+	template <class TT> bool operator==(const aligned_allocator<TT, A>&)const noexcept{
+		return true;
+	}
+
+	template <class TT> bool operator!=(const aligned_allocator<TT, A>&)const noexcept{
+		return false;
+	}
+};
+
+/**
+ * @brief 4d vector aligned to its size.
+ * Same as vector4, but aligned to 16 bytes for floats and 32 bytes for doubles, so that SIMD
+ * registers are loaded from and stored to it with aligned instructions and it never crosses a cache line boundary.
+ * The aligned vector is derived from vector4 and it is implicitly constructible from vector4,
+ * so it converts to and from vector4 at zero cost and all vector4 operations apply to it.
+ * Note, that operations inherited from vector4 return vector4.
+ * Arrays of aligned vectors allocated by std::vector are aligned since C++17, as standard allocator
+ * respects over-alignment.
+ * @tparam T - type of vector components.
+ */
+template <class T> class alignas(sizeof(vector4<T>)) aligned_vector4 : public vector4<T>{
+	static_assert((sizeof(vector4<T>) & (sizeof(vector4<T>) - 1)) == 0, "size of vector4<T> must be a power of two");
+
+	typedef vector4<T> base_type;
+public:
+	using base_type::base_type;
+
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the vector with any values.
+	 */
+	constexpr aligned_vector4() = default;
+
+	/**
+	 * @brief Construct from vector4.
+	 * @param v - vector to copy.
+	 */
+	constexpr aligned_vector4(const base_type& v)noexcept :
+			base_type(v)
+	{}
+};
+
+static_assert(sizeof(aligned_vector4<float>) == sizeof(vector4<float>), "aligned vector must have no padding");
+static_assert(sizeof(aligned_vector4<double>) == sizeof(vector4<double>), "aligned vector must have no padding");
+
+/**
+ * @brief 4x4 matrix aligned to cache line.
+ * Same as matrix4, but aligned to the cache line size, or to its own size if that is smaller.
+ * Each row of the matrix is aligned for SIMD loads and stores and the matrix
+ * occupies the minimal number of cache lines.
+ * The aligned matrix is derived from matrix4 and it is implicitly constructible from matrix4,
+ * so it converts to and from matrix4 at zero cost and all matrix4 operations apply to it.
+ * Note, that operations inherited from matrix4 return matrix4.
+ * @tparam T - type of matrix elements.
+ */
+template <class T> class alignas(std::min(sizeof(matrix4<T>), cache_line_size)) aligned_matrix4 : public matrix4<T>{
+	typedef matrix4<T> base_type;
+public:
+	using base_type::base_type;
+
+	/**
+	 * @brief Default constructor.
+	 * NOTE: it does not initialize the matrix with any values.
+	 */
+	constexpr aligned_matrix4() = default;
+
+	/**
+	 * @brief Construct from matrix4.
+	 * @param m - matrix to copy.
+	 */
+	constexpr aligned_matrix4(const base_type& m)noexcept :
+			base_type(m)
+	{}
+};
+
+/**
+ * @brief Transform aligned vectors by matrix.
+ * Same as transform() of vector4 span, but the results are stored with aligned SIMD instructions.
+ * Input and output spans can be the same span, i.e. in-place transformation is allowed.
+ * @param m - transformation matrix.
+ * @param in - vectors to transform.
+ * @param out - span to store the transformed vectors to. Must be of the same size as the input span.
+ */
+template <class T>
+void transform(const matrix4<T>& m, utki::span<const aligned_vector4<std::common_type_t<T>>> in, utki::span<aligned_vector4<std::common_type_t<T>>> out)noexcept{
+	ASSERT(in.size() == out.size())
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		internal::matrix4_columns<T> mc(m);
+		auto o = out.begin();
+		for(const auto& v : in){
+			simd::kernel<T, 4>::store_aligned(o->data(), mc.transform(v.x(), v.y(), v.z(), v.w()));
+			++o;
+		}
+	}else{
+		auto o = out.begin();
+		for(const auto& v : in){
+			*o = m * v;
+			++o;
+		}
+	}
+}
+
+}
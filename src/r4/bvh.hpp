@@ -0,0 +1,718 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "rectangle.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Bounding volume hierarchy of rectangles.
+ * A spatial index which allows finding rectangles overlapping a given point or a given rectangle,
+ * and rectangles nearest to a given point, in logarithmic time.
+ * The hierarchy is a binary tree, each leaf node holds one rectangle and each internal node
+ * holds the bounding rectangle of its two children.
+ * Rectangles are inserted incrementally, at the place which minimizes the perimeter growth
+ * of the bounding rectangles, and the tree is kept balanced by tree rotations.
+ * Alternatively, the tree can be bulk-built from a set of rectangles by recursive median splits.
+ * Each inserted rectangle is identified by an id, which stays valid until the rectangle is removed.
+ * Queries do not allocate any memory, the tree traversal uses links to parent nodes instead of a stack.
+ * Rectangles are supposed to have non-negative dimensions.
+ * @tparam T - type of rectangle coordinates.
+ */
+template <class T> class bvh{
+public:
+	/**
+	 * @brief Invalid id value.
+	 */
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+	struct node{
+		rectangle<T> box;
+
+		// parent node, for nodes in the free list this is the next free node
+		size_t parent;
+
+		// children[0] is npos for leaf nodes
+		std::array<size_t, 2> children;
+
+		// height of the subtree, 0 for leaf nodes, -1 for free nodes
+		int height;
+
+		bool is_leaf()const noexcept{
+			return this->children[0] == npos;
+		}
+	};
+
+	std::vector<node> nodes;
+
+	size_t root = npos;
+
+	size_t free_list = npos;
+
+	size_t num_leaves = 0;
+
+	// Height based rotations worsen the quality of the tree, so those are done only
+	// when subtree heights differ a lot, see balance_height().
+	static constexpr int max_height_imbalance = 4;
+
+public:
+	/**
+	 * @brief Construct empty hierarchy.
+	 */
+	bvh() = default;
+
+	/**
+	 * @brief Build hierarchy from a set of rectangles.
+	 * The tree is built top-down, by splitting the rectangles by median of their centers
+	 * along the longest axis of the centers' bounds.
+	 * Ids of the rectangles are their indices in the given span.
+	 * @param rects - rectangles to build the hierarchy of.
+	 */
+	explicit bvh(utki::span<const rectangle<T>> rects){
+		if(rects.empty()){
+			return;
+		}
+
+		// leaf nodes occupy first indices so that ids of rectangles are their indices in the span
+		this->nodes.reserve(rects.size() * 2 - 1);
+		this->nodes.resize(rects.size());
+
+		std::vector<size_t> leaves(rects.size());
+		for(size_t i = 0; i != rects.size(); ++i){
+			auto& n = this->nodes[i];
+			n.box = rects[i];
+			n.children[0] = npos;
+			n.children[1] = npos;
+			n.height = 0;
+			leaves[i] = i;
+		}
+
+		this->num_leaves = rects.size();
+		this->root = this->build(utki::make_span(leaves));
+		this->nodes[this->root].parent = npos;
+	}
+
+	/**
+	 * @brief Get number of rectangles in the hierarchy.
+	 * @return number of rectangles.
+	 */
+	size_t size()const noexcept{
+		return this->num_leaves;
+	}
+
+	/**
+	 * @brief Check if the hierarchy has no rectangles.
+	 * @return true if the hierarchy is empty.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->num_leaves == 0;
+	}
+
+	/**
+	 * @brief Get height of the tree.
+	 * @return height of the tree, 0 for a tree with only one rectangle, or for an empty tree.
+	 */
+	size_t height()const noexcept{
+		if(this->root == npos){
+			return 0;
+		}
+		return size_t(this->nodes[this->root].height);
+	}
+
+	/**
+	 * @brief Get bounding rectangle of all rectangles in the hierarchy.
+	 * @return bounding rectangle of all rectangles. Undefined if the hierarchy is empty.
+	 */
+	const rectangle<T>& bounds()const noexcept{
+		ASSERT(this->root != npos)
+		return this->nodes[this->root].box;
+	}
+
+	/**
+	 * @brief Remove all rectangles.
+	 */
+	void clear()noexcept{
+		this->nodes.clear();
+		this->root = npos;
+		this->free_list = npos;
+		this->num_leaves = 0;
+	}
+
+	/**
+	 * @brief Get rectangle by id.
+	 * @param id - id of the rectangle.
+	 * @return the rectangle.
+	 */
+	const rectangle<T>& get(size_t id)const noexcept{
+		ASSERT(id < this->nodes.size())
+		ASSERT(this->nodes[id].height == 0)
+		return this->nodes[id].box;
+	}
+
+	/**
+	 * @brief Insert rectangle.
+	 * @param rect - rectangle to insert.
+	 * @return id of the inserted rectangle.
+	 */
+	size_t insert(const rectangle<T>& rect){
+		size_t id = this->allocate_node();
+		auto& n = this->nodes[id];
+		n.box = rect;
+		n.children[0] = npos;
+		n.children[1] = npos;
+		n.height = 0;
+
+		this->insert_leaf(id);
+		++this->num_leaves;
+		return id;
+	}
+
+	/**
+	 * @brief Remove rectangle.
+	 * After removal the id of the removed rectangle becomes invalid and can be reused by later insertions.
+	 * @param id - id of the rectangle to remove.
+	 */
+	void remove(size_t id)noexcept{
+		ASSERT(id < this->nodes.size())
+		ASSERT(this->nodes[id].height == 0)
+
+		this->remove_leaf(id);
+		this->free_node(id);
+		--this->num_leaves;
+	}
+
+	/**
+	 * @brief Change rectangle.
+	 * The id of the rectangle remains the same.
+	 * @param id - id of the rectangle to change.
+	 * @param rect - new rectangle.
+	 */
+	void update(size_t id, const rectangle<T>& rect)noexcept{
+		ASSERT(id < this->nodes.size())
+		ASSERT(this->nodes[id].height == 0)
+
+		if(this->nodes[id].box == rect){
+			return;
+		}
+
+		this->remove_leaf(id);
+		this->nodes[id].box = rect;
+		this->insert_leaf(id);
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the point.
+	 * Overlapping is tested in the same way as by rectangle::overlaps(vector2).
+	 * @param point - point to find overlapping rectangles for.
+	 * @param func - function to call for each found rectangle. Takes id of the rectangle as argument.
+	 *               Can return bool, in that case returning false stops the search.
+	 */
+	template <class F> void query(const vector2<T>& point, F func)const{
+		this->traverse(
+				[this, &point](size_t n){
+					return this->nodes[n].box.overlaps(point);
+				},
+				[](size_t){
+					return 0;
+				},
+				[&func](size_t n){
+					return invoke(func, n);
+				}
+			);
+	}
+
+	/**
+	 * @brief Find rectangles overlapping the rectangle.
+	 * Overlapping is tested in the same way as by rectangle::overlaps(rectangle).
+	 * @param rect - rectangle to find overlapping rectangles for.
+	 * @param func - function to call for each found rectangle. Takes id of the rectangle as argument.
+	 *               Can return bool, in that case returning false stops the search.
+	 */
+	template <class F> void query(const rectangle<T>& rect, F func)const{
+		this->traverse(
+				[this, &rect](size_t n){
+					return this->nodes[n].box.overlaps(rect);
+				},
+				[](size_t){
+					return 0;
+				},
+				[&func](size_t n){
+					return invoke(func, n);
+				}
+			);
+	}
+
+	/**
+	 * @brief Find rectangles nearest to the point.
+	 * Distance from the point to a rectangle is the distance to the nearest point of the rectangle,
+	 * it is 0 if the point is inside of the rectangle.
+	 * The search is done by a depth first traversal which visits the nearest subtree first
+	 * and skips subtrees which are further than the furthest of already found rectangles.
+	 * @param point - point to find nearest rectangles to.
+	 * @param out - span to store ids of the found rectangles to. The size of the span is the number of rectangles to find.
+	 *              The ids are sorted by distance, the nearest rectangle first.
+	 * @return number of found rectangles, which is less than size of 'out' span only if the hierarchy has fewer rectangles.
+	 */
+	size_t nearest(const vector2<T>& point, utki::span<size_t> out)const noexcept{
+		if(out.empty()){
+			return 0;
+		}
+
+		size_t num_found = 0;
+
+		// distance to the furthest of found rectangles
+		T max_dist = 0;
+
+		auto dist = [this, &point](size_t n){
+			return distance_pow2(this->nodes[n].box, point);
+		};
+
+		this->traverse(
+				[&](size_t n){
+					return num_found != out.size() || dist(n) < max_dist;
+				},
+				[&](size_t n){
+					const auto& c = this->nodes[n].children;
+					return dist(c[1]) < dist(c[0]) ? 1 : 0;
+				},
+				[&](size_t n){
+					// insert into sorted array of found rectangles
+					auto d = dist(n);
+					size_t i = num_found == out.size() ? num_found - 1 : num_found++;
+					for(; i != 0 && d < dist(out[i - 1]); --i){
+						out[i] = out[i - 1];
+					}
+					out[i] = n;
+					max_dist = dist(out[num_found - 1]);
+					return true;
+				}
+			);
+
+		return num_found;
+	}
+
+	/**
+	 * @brief Find rectangle nearest to the point.
+	 * See nearest(vector2, span) for details.
+	 * @param point - point to find nearest rectangle to.
+	 * @return id of the nearest rectangle, or npos if the hierarchy is empty.
+	 */
+	size_t nearest(const vector2<T>& point)const noexcept{
+		size_t ret;
+		if(this->nearest(point, utki::make_span(&ret, 1)) == 0){
+			return npos;
+		}
+		return ret;
+	}
+
+private:
+	template <class F> static bool invoke(F& func, size_t id){
+		if constexpr (std::is_same_v<decltype(func(id)), bool>){
+			return func(id);
+		}else{
+			func(id);
+			return true;
+		}
+	}
+
+	// Squared distance from the point to the nearest point of the rectangle.
+	// Written without subtractions of possibly negative results to work for unsigned types.
+	static T distance_pow2(const rectangle<T>& r, const vector2<T>& p)noexcept{
+		T ret = 0;
+		for(size_t i = 0; i != 2; ++i){
+			T d;
+			if(p[i] < r.p[i]){
+				d = r.p[i] - p[i];
+			}else if(p[i] > r.p[i] + r.d[i]){
+				d = p[i] - (r.p[i] + r.d[i]);
+			}else{
+				continue;
+			}
+			ret += d * d;
+		}
+		return ret;
+	}
+
+	// half of perimeter
+	static T cost(const rectangle<T>& r)noexcept{
+		return r.d.x() + r.d.y();
+	}
+
+	static rectangle<T> united(rectangle<T> a, const rectangle<T>& b)noexcept{
+		return a.unite(b);
+	}
+
+	// Depth first traversal of the tree without stack.
+	// accept(n) tells whether to visit the subtree of node n,
+	// first(n) tells which child of internal node n to visit first (0 or 1),
+	// visit(n) is called for accepted leaf nodes, returning false stops the traversal.
+	// When going up from a child node to the parent, first(parent) is called again to find out
+	// whether the child was visited first, so it must return same value for the same node during the traversal.
+	template <class A, class F, class V> void traverse(A accept, F first, V visit)const{
+		size_t n = this->root;
+		if(n == npos){
+			return;
+		}
+
+		for(;;){
+			if(accept(n)){
+				const auto& nd = this->nodes[n];
+				if(nd.is_leaf()){
+					if(!visit(n)){
+						return;
+					}
+				}else{
+					n = nd.children[first(n)];
+					continue;
+				}
+			}
+
+			// go up until there is a sibling visited second
+			for(;;){
+				if(n == this->root){
+					return;
+				}
+				size_t p = this->nodes[n].parent;
+				const auto& c = this->nodes[p].children;
+				size_t f = size_t(first(p));
+				if(c[f] == n){
+					n = c[1 - f];
+					break;
+				}
+				n = p;
+			}
+		}
+	}
+
+	size_t allocate_node(){
+		if(this->free_list == npos){
+			this->nodes.emplace_back();
+			return this->nodes.size() - 1;
+		}
+		size_t ret = this->free_list;
+		this->free_list = this->nodes[ret].parent;
+		return ret;
+	}
+
+	void free_node(size_t n)noexcept{
+		this->nodes[n].parent = this->free_list;
+		this->nodes[n].height = -1;
+		this->free_list = n;
+	}
+
+	// recalculate bounding box and height of internal node from its children
+	void refit(size_t n)noexcept{
+		auto& nd = this->nodes[n];
+		const auto& c0 = this->nodes[nd.children[0]];
+		const auto& c1 = this->nodes[nd.children[1]];
+		nd.box = united(c0.box, c1.box);
+		nd.height = 1 + std::max(c0.height, c1.height);
+	}
+
+	void replace_child(size_t parent, size_t old_child, size_t new_child)noexcept{
+		if(parent == npos){
+			this->root = new_child;
+			return;
+		}
+		auto& c = this->nodes[parent].children;
+		c[c[0] == old_child ? 0 : 1] = new_child;
+	}
+
+	// rebalance and refit all nodes from n up to the root
+	void fix_upwards(size_t n)noexcept{
+		while(n != npos){
+			this->refit(n);
+			n = this->balance(n);
+			n = this->nodes[n].parent;
+		}
+	}
+
+	void insert_leaf(size_t leaf){
+		if(this->root == npos){
+			this->root = leaf;
+			this->nodes[leaf].parent = npos;
+			return;
+		}
+
+		const auto leaf_box = this->nodes[leaf].box;
+
+		// Find the best sibling for the new leaf, i.e. the one which gives least growth of total perimeter
+		// of all nodes. The cost of making node S the sibling is the perimeter of the new parent node,
+		// i.e. perimeter of union of S and the new leaf, plus perimeter growth of all ancestors of S.
+		// The search descends into the child with least lower bound of the cost of any node in its subtree,
+		// until the lower bounds are not better than the best cost found.
+		T leaf_cost = cost(leaf_box);
+
+		size_t sibling = this->root;
+		T best_cost = cost(united(this->nodes[sibling].box, leaf_box));
+
+		// perimeter growth of all ancestors of the current node, including the node itself
+		T inherited_cost = 0;
+
+		for(size_t n = this->root; !this->nodes[n].is_leaf();){
+			const auto& nd = this->nodes[n];
+
+			inherited_cost += cost(united(nd.box, leaf_box)) - cost(nd.box);
+
+			std::array<T, 2> lower_cost;
+			for(size_t i = 0; i != 2; ++i){
+				size_t ci = nd.children[i];
+				const auto& c = this->nodes[ci];
+
+				T direct_cost = cost(united(c.box, leaf_box));
+				T c_cost = direct_cost + inherited_cost;
+
+				// in case of equal costs prefer deeper nodes, this keeps the tree balanced
+				// when many rectangles are the same
+				if(!(best_cost < c_cost)){
+					best_cost = c_cost;
+					sibling = ci;
+				}
+
+				if(c.is_leaf()){
+					lower_cost[i] = std::numeric_limits<T>::max();
+				}else{
+					// descending into the child costs at least the growth of the child's perimeter
+					// plus the perimeter of the new leaf
+					lower_cost[i] = inherited_cost + (direct_cost - cost(c.box)) + leaf_cost;
+				}
+			}
+
+			if(best_cost < lower_cost[0] && best_cost < lower_cost[1]){
+				break;
+			}
+
+			size_t next;
+			if(lower_cost[0] == lower_cost[1]){
+				// descend into the lower subtree
+				next = this->nodes[nd.children[1]].height < this->nodes[nd.children[0]].height ? 1 : 0;
+			}else{
+				next = lower_cost[1] < lower_cost[0] ? 1 : 0;
+			}
+			n = nd.children[next];
+		}
+
+		size_t old_parent = this->nodes[sibling].parent;
+		size_t new_parent = this->allocate_node();
+
+		// NOTE: allocate_node() could reallocate nodes array, so get references after it
+		auto& np = this->nodes[new_parent];
+		np.parent = old_parent;
+		np.children[0] = sibling;
+		np.children[1] = leaf;
+		this->replace_child(old_parent, sibling, new_parent);
+		this->nodes[sibling].parent = new_parent;
+		this->nodes[leaf].parent = new_parent;
+
+		this->fix_upwards(new_parent);
+	}
+
+	void remove_leaf(size_t leaf)noexcept{
+		if(leaf == this->root){
+			this->root = npos;
+			return;
+		}
+
+		size_t parent = this->nodes[leaf].parent;
+		size_t grand_parent = this->nodes[parent].parent;
+		const auto& pc = this->nodes[parent].children;
+		size_t sibling = pc[0] == leaf ? pc[1] : pc[0];
+
+		this->replace_child(grand_parent, parent, sibling);
+		this->nodes[sibling].parent = grand_parent;
+		this->free_node(parent);
+
+		this->fix_upwards(grand_parent);
+	}
+
+	// Tree rotation which reduces the perimeter of one of the children of node a.
+	// The rotations swap a child of node a with a grand child from the other subtree,
+	// the one which gives the smallest resulting perimeter of the subtree node is chosen,
+	// if it is smaller than the current perimeter of the subtree node.
+	// Perimeter of node a itself does not change.
+	// Returns the node which took place of node a, i.e. a itself.
+	size_t balance(size_t a)noexcept{
+		auto& na = this->nodes[a];
+		if(na.is_leaf() || na.height < 2){
+			return a;
+		}
+
+		// best rotation found so far: swap child 'swap_child' of node a with the child 'swap_grand_child' of node 'swap_node'
+		T best_cost = 0;
+		size_t swap_child = npos;
+		size_t swap_node = npos;
+		size_t swap_grand_child = 0;
+
+		for(size_t s = 0; s != 2; ++s){
+			size_t x = na.children[s];
+			const auto& nx = this->nodes[x];
+			if(nx.is_leaf()){
+				continue;
+			}
+
+			T x_cost = cost(nx.box);
+			const auto& other = this->nodes[na.children[1 - s]];
+
+			for(size_t g = 0; g != 2; ++g){
+				// node x after swapping its child g with the other child of node a
+				T c = cost(united(other.box, this->nodes[nx.children[1 - g]].box));
+				if(c < x_cost && x_cost - c > best_cost){
+					best_cost = x_cost - c;
+					swap_child = 1 - s;
+					swap_node = x;
+					swap_grand_child = g;
+				}
+			}
+		}
+
+		if(swap_child == npos){
+			return this->balance_height(a);
+		}
+
+		size_t b = na.children[swap_child];
+		auto& nx = this->nodes[swap_node];
+		size_t g = nx.children[swap_grand_child];
+
+		na.children[swap_child] = g;
+		this->nodes[g].parent = a;
+		nx.children[swap_grand_child] = b;
+		this->nodes[b].parent = swap_node;
+
+		this->refit(swap_node);
+		this->refit(a);
+
+		return a;
+	}
+
+	// If subtrees of node a differ in height by more than max_height_imbalance, then rotate the higher child up.
+	// This keeps the tree height logarithmic in cases when perimeter based rotations do not help,
+	// e.g. when many rectangles are the same.
+	// Returns the node which took place of node a.
+	size_t balance_height(size_t a)noexcept{
+		auto& na = this->nodes[a];
+
+		int h0 = this->nodes[na.children[0]].height;
+		int h1 = this->nodes[na.children[1]].height;
+
+		if(std::abs(h1 - h0) <= max_height_imbalance){
+			return a;
+		}
+
+		// the higher child, it goes up and takes place of node a
+		size_t s = h1 > h0 ? 1 : 0;
+		size_t x = na.children[s];
+		auto& nx = this->nodes[x];
+
+		size_t f = nx.children[0];
+		size_t g = nx.children[1];
+
+		nx.parent = na.parent;
+		this->replace_child(na.parent, a, x);
+		na.parent = x;
+		nx.children[0] = a;
+
+		// higher grand child stays in node x, the lower one goes to node a
+		if(this->nodes[f].height < this->nodes[g].height){
+			std::swap(f, g);
+		}
+		nx.children[1] = f;
+		na.children[s] = g;
+		this->nodes[g].parent = a;
+
+		this->refit(a);
+		this->refit(x);
+
+		return x;
+	}
+
+	// build subtree of given leaves, returns root of the subtree
+	size_t build(utki::span<size_t> leaves){
+		if(leaves.size() == 1){
+			return leaves[0];
+		}
+
+		// find the longest axis of the bounds of the leaves' centers,
+		// centers are doubled to avoid division
+		auto center2 = [this](size_t n){
+			const auto& b = this->nodes[n].box;
+			return b.p * 2 + b.d;
+		};
+
+		auto min_c = center2(leaves[0]);
+		auto max_c = min_c;
+		for(auto l : leaves){
+			auto c = center2(l);
+			min_c = min(min_c, c);
+			max_c = max(max_c, c);
+		}
+		auto ext = max_c - min_c;
+		size_t axis = ext.x() < ext.y() ? 1 : 0;
+
+		auto mid = leaves.begin() + leaves.size() / 2;
+		std::nth_element(
+				leaves.begin(),
+				mid,
+				leaves.end(),
+				[&center2, axis](size_t a, size_t b){
+					return center2(a)[axis] < center2(b)[axis];
+				}
+			);
+
+		size_t c0 = this->build(utki::make_span(leaves.data(), leaves.size() / 2));
+		size_t c1 = this->build(utki::make_span(leaves.data() + leaves.size() / 2, leaves.size() - leaves.size() / 2));
+
+		size_t n = this->nodes.size();
+		this->nodes.emplace_back();
+		auto& nd = this->nodes[n];
+		nd.children[0] = c0;
+		nd.children[1] = c1;
+		this->nodes[c0].parent = n;
+		this->nodes[c1].parent = n;
+		this->refit(n);
+
+		return n;
+	}
+};
+
+}
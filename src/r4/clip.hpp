@@ -0,0 +1,370 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "segment2.hpp"
+#include "rectangle.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Bits of Cohen-Sutherland outcode.
+ * A bit of the outcode is set in case the point lies outside of the rectangle beyond the corresponding edge.
+ * Rectangles are treated as closed, i.e. points lying on the edges are inside.
+ * Zero outcode means that the point is inside of the rectangle.
+ */
+enum outcode_bit : uint8_t{
+	outcode_x1 = 1 << 0, // x < rect.p.x()
+	outcode_y1 = 1 << 1, // y < rect.p.y()
+	outcode_x2 = 1 << 2, // x > rect.x2()
+	outcode_y2 = 1 << 3, // y > rect.y2()
+};
+
+/**
+ * @brief Calculate Cohen-Sutherland outcode of a point.
+ * @param point - point to calculate the outcode of.
+ * @param rect - rectangle to calculate the outcode against.
+ * @return combination of outcode_bit values.
+ */
+template <class T> uint8_t outcode(const vector2<T>& point, const rectangle<T>& rect)noexcept{
+	return uint8_t(
+			(point.x() < rect.p.x() ? outcode_x1 : 0) |
+			(point.y() < rect.p.y() ? outcode_y1 : 0) |
+			(rect.x2() < point.x() ? outcode_x2 : 0) |
+			(rect.y2() < point.y() ? outcode_y2 : 0)
+		);
+}
+
+/**
+ * @brief Calculate Cohen-Sutherland outcodes of points.
+ * For float and double, in case SIMD is enabled, outcodes of two points are calculated at once.
+ * @param points - points to calculate the outcodes of.
+ * @param rect - rectangle to calculate the outcodes against.
+ * @param codes - output span of outcodes, one per point. Must be of the same size as points span.
+ */
+template <class T> void outcodes(utki::span<const vector2<T>> points, const rectangle<T>& rect, utki::span<uint8_t> codes)noexcept{
+	ASSERT(points.size() == codes.size())
+
+	typedef simd::kernel<T, 4> simd_kernel;
+
+	size_t i = 0;
+
+	if constexpr (simd_kernel::enabled){
+		// points are loaded to SIMD register by two as x, y, x, y
+		static_assert(sizeof(vector2<T>) == 2 * sizeof(T), "unexpected vector2 layout");
+
+		auto x2_y2 = rect.x2_y2();
+		auto lo = simd_kernel::set(rect.p.x(), rect.p.y(), rect.p.x(), rect.p.y());
+		auto hi = simd_kernel::set(x2_y2.x(), x2_y2.y(), x2_y2.x(), x2_y2.y());
+
+		for(; i + 2 <= points.size(); i += 2){
+			auto v = simd_kernel::load(points[i].data());
+
+			// lane bits of the masks go in the same order as the outcode bits of the two points
+			unsigned below = simd_kernel::lt_mask(v, lo);
+			unsigned above = simd_kernel::lt_mask(hi, v);
+
+			codes[i] = uint8_t((below & 0x3) | ((above & 0x3) << 2));
+			codes[i + 1] = uint8_t((below >> 2) | (above & 0xc));
+		}
+	}
+
+	for(; i < points.size(); ++i){
+		codes[i] = outcode(points[i], rect);
+	}
+}
+
+namespace internal{
+
+// Cohen-Sutherland clipping of the segment with known outcodes of its end points.
+template <class T> bool clip(segment2<T>& s, const rectangle<T>& rect, uint8_t c1, uint8_t c2)noexcept{
+	auto x2_y2 = rect.x2_y2();
+
+	// In exact arithmetic each end point is moved at most twice before the segment is accepted or rejected.
+	// Rounding of the intersection point lying at the rectangle corner can make its outcode non-zero again,
+	// in that case the remaining deviation is within rounding error, so the point is clamped to the rectangle.
+	for(unsigned iter = 0; ; ++iter){
+		if((c1 | c2) == 0){
+			return true;
+		}
+		if((c1 & c2) != 0){
+			return false;
+		}
+		if(iter == 4){
+			s.p1 = max(min(s.p1, x2_y2), rect.p);
+			s.p2 = max(min(s.p2, x2_y2), rect.p);
+			return true;
+		}
+
+		bool first = c1 != 0;
+		uint8_t c = first ? c1 : c2;
+
+		auto d = s.p2 - s.p1;
+		vector2<T> p;
+		if(c & outcode_x1){
+			p = {rect.p.x(), s.p1.y() + d.y() * (rect.p.x() - s.p1.x()) / d.x()};
+		}else if(c & outcode_x2){
+			p = {x2_y2.x(), s.p1.y() + d.y() * (x2_y2.x() - s.p1.x()) / d.x()};
+		}else if(c & outcode_y1){
+			p = {s.p1.x() + d.x() * (rect.p.y() - s.p1.y()) / d.y(), rect.p.y()};
+		}else{
+			p = {s.p1.x() + d.x() * (x2_y2.y() - s.p1.y()) / d.y(), x2_y2.y()};
+		}
+
+		if(first){
+			s.p1 = p;
+			c1 = outcode(p, rect);
+		}else{
+			s.p2 = p;
+			c2 = outcode(p, rect);
+		}
+	}
+}
+
+// One pass of Sutherland-Hodgman algorithm, clips polygon by the line where coordinate 'axis' equals to 'edge',
+// the inside half-plane is the one where the coordinate is not greater than 'edge' in case of 'max_edge'
+// and not less otherwise.
+template <class T, size_t axis, bool max_edge> size_t clip_polygon(
+		utki::span<const vector2<T>> in,
+		T edge,
+		utki::span<vector2<T>> out
+	)noexcept
+{
+	auto is_inside = [edge](const vector2<T>& p){
+		if constexpr (max_edge){
+			return p[axis] <= edge;
+		}else{
+			return p[axis] >= edge;
+		}
+	};
+
+	// intersection is always calculated from inside point towards outside one,
+	// so that the edge shared by two polygons is clipped to the same point regardless of its direction
+	auto intersection = [edge](const vector2<T>& in_p, const vector2<T>& out_p){
+		constexpr size_t other = 1 - axis;
+		vector2<T> ret;
+		ret[axis] = edge;
+		ret[other] = in_p[other] + (out_p[other] - in_p[other]) * (edge - in_p[axis]) / (out_p[axis] - in_p[axis]);
+		return ret;
+	};
+
+	size_t n = 0;
+	auto push = [&out, &n](const vector2<T>& p){
+		ASSERT(n < out.size())
+		out[n] = p;
+		++n;
+	};
+
+	const vector2<T>* prev = &in[in.size() - 1];
+	bool prev_inside = is_inside(*prev);
+	for(const auto& cur : in){
+		bool cur_inside = is_inside(cur);
+		if(cur_inside){
+			if(!prev_inside){
+				push(intersection(cur, *prev));
+			}
+			push(cur);
+		}else if(prev_inside){
+			push(intersection(*prev, cur));
+		}
+		prev = &cur;
+		prev_inside = cur_inside;
+	}
+	return n;
+}
+
+}
+
+/**
+ * @brief Clip segment by rectangle.
+ * Cohen-Sutherland algorithm is used.
+ * @param s - segment to clip. The clipped segment is stored back to it.
+ * @param rect - rectangle to clip the segment by.
+ * @return true in case the segment intersects the rectangle, s holds the clipped segment in that case.
+ * @return false in case the segment lies outside of the rectangle, s is left in unspecified state in that case.
+ */
+template <class T> bool clip(segment2<T>& s, const rectangle<T>& rect)noexcept{
+	static_assert(std::is_floating_point_v<T>, "clipping is only defined for floating point types");
+	return internal::clip(s, rect, outcode(s.p1, rect), outcode(s.p2, rect));
+}
+
+/**
+ * @brief Clip polyline by rectangle.
+ * Each edge of the polyline is clipped by Cohen-Sutherland algorithm, the edges intersecting the rectangle
+ * are written to the output span as segments in the order of the polyline.
+ * Outcodes of the polyline points are calculated in batches by outcodes() function, so the edges lying
+ * completely inside or completely outside of the rectangle along one of its edges are processed without
+ * calculating intersections. No memory allocation is done.
+ * @param polyline - points of the polyline.
+ * @param rect - rectangle to clip the polyline by.
+ * @param out - output span of clipped segments. Must have at least polyline.size() - 1 elements.
+ * @return number of segments written to the output span.
+ */
+template <class T> size_t clip_polyline(
+		utki::span<const vector2<T>> polyline,
+		const rectangle<T>& rect,
+		utki::span<segment2<T>> out
+	)noexcept
+{
+	static_assert(std::is_floating_point_v<T>, "clipping is only defined for floating point types");
+
+	if(polyline.size() < 2){
+		return 0;
+	}
+
+	ASSERT(out.size() >= polyline.size() - 1)
+
+	constexpr size_t batch_size = 256;
+	std::array<uint8_t, batch_size> codes;
+
+	size_t n = 0;
+	uint8_t prev_code = outcode(polyline[0], rect);
+
+	for(size_t i = 1; i < polyline.size(); i += batch_size){
+		size_t size = std::min(batch_size, polyline.size() - i);
+		outcodes(polyline.subspan(i, size), rect, utki::make_span(codes.data(), size));
+
+		for(size_t j = 0; j != size; ++j){
+			uint8_t code = codes[j];
+			if((prev_code & code) == 0){
+				out[n] = segment2<T>{polyline[i + j - 1], polyline[i + j]};
+				if((prev_code | code) == 0 || internal::clip(out[n], rect, prev_code, code)){
+					++n;
+				}
+			}
+			prev_code = code;
+		}
+	}
+
+	return n;
+}
+
+/**
+ * @brief Get output capacity needed for clipping polygon.
+ * Each pass of the Sutherland-Hodgman algorithm turns a polygon with n vertices into a polygon with
+ * at most n + n / 2 vertices, the returned value applies this bound for each of the four passes,
+ * so it is not exact, but is safe for any polygon, including concave ones.
+ * @param polygon_size - number of vertices of the polygon to clip.
+ * @return number of elements the output and buffer spans of clip_polygon() must have.
+ */
+constexpr size_t clip_polygon_capacity(size_t polygon_size)noexcept{
+	size_t ret = polygon_size;
+	for(unsigned i = 0; i != 4; ++i){
+		ret += ret / 2;
+	}
+	return ret;
+}
+
+/**
+ * @brief Clip polygon by rectangle.
+ * Sutherland-Hodgman algorithm is used. Outcodes of the polygon vertices are calculated in batches
+ * by outcodes() function first, so the polygons lying completely inside of the rectangle are copied to
+ * the output as is, and the polygons lying completely outside of the rectangle along one of its edges are rejected
+ * without running the clipping passes.
+ * Clipped concave polygons may have degenerate edges lying along the rectangle's edges.
+ * No memory allocation is done, the caller provides both output and intermediate buffers.
+ * @param polygon - vertices of the polygon.
+ * @param rect - rectangle to clip the polygon by.
+ * @param out - output span for vertices of the clipped polygon. Must not overlap the polygon span.
+ * @param buffer - buffer for intermediate results. Must not overlap the polygon and output spans.
+ *                 Both output and buffer spans must have at least clip_polygon_capacity(polygon.size()) elements.
+ * @return number of vertices of the clipped polygon written to the output span, 0 in case the polygon
+ *         does not intersect the rectangle.
+ */
+template <class T> size_t clip_polygon(
+		utki::span<const vector2<T>> polygon,
+		const rectangle<T>& rect,
+		utki::span<vector2<T>> out,
+		utki::span<vector2<T>> buffer
+	)noexcept
+{
+	static_assert(std::is_floating_point_v<T>, "clipping is only defined for floating point types");
+
+	if(polygon.empty()){
+		return 0;
+	}
+
+	constexpr size_t batch_size = 256;
+	std::array<uint8_t, batch_size> codes;
+
+	uint8_t codes_or = 0;
+	uint8_t codes_and = outcode_x1 | outcode_y1 | outcode_x2 | outcode_y2;
+	for(size_t i = 0; i < polygon.size(); i += batch_size){
+		size_t size = std::min(batch_size, polygon.size() - i);
+		outcodes(polygon.subspan(i, size), rect, utki::make_span(codes.data(), size));
+		for(size_t j = 0; j != size; ++j){
+			codes_or |= codes[j];
+			codes_and &= codes[j];
+		}
+	}
+
+	if(codes_and != 0){
+		return 0;
+	}
+
+	if(codes_or == 0){
+		ASSERT(out.size() >= polygon.size())
+		std::copy(polygon.begin(), polygon.end(), out.begin());
+		return polygon.size();
+	}
+
+	auto x2_y2 = rect.x2_y2();
+
+	// passes go back and forth between the buffer and the output, so that the result of the last pass is in the output
+	size_t n = internal::clip_polygon<T, 0, false>(polygon, rect.p.x(), buffer);
+	if(n == 0){
+		return 0;
+	}
+	n = internal::clip_polygon<T, 1, false>(buffer.subspan(0, n), rect.p.y(), out);
+	if(n == 0){
+		return 0;
+	}
+	n = internal::clip_polygon<T, 0, true>(out.subspan(0, n), x2_y2.x(), buffer);
+	if(n == 0){
+		return 0;
+	}
+	return internal::clip_polygon<T, 1, true>(buffer.subspan(0, n), x2_y2.y(), out);
+}
+
+}
@@ -0,0 +1,238 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <utki/math.hpp>
+
+#include "simd.hpp"
+
+namespace r4{
+namespace internal{
+
+/**
+ * @brief Check if the call is evaluated in constant expression.
+ * C++17 replacement of C++20's std::is_constant_evaluated().
+ * In case the compiler does not provide the needed builtin, the function always returns false,
+ * so all r4 operations can still be used at run time, but not in constant expressions.
+ * @return true in case the call is a part of constant expression evaluation.
+ * @return false otherwise.
+ */
+constexpr bool is_constant_evaluated()noexcept{
+#if defined(__cpp_lib_is_constant_evaluated)
+	return std::is_constant_evaluated();
+#elif defined(__GNUC__) && __GNUC__ >= 9
+	return __builtin_is_constant_evaluated();
+#elif defined(__clang__) && __clang_major__ >= 9
+	return __builtin_is_constant_evaluated();
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+	return __builtin_is_constant_evaluated();
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Square root.
+ * Can be evaluated in constant expressions. At compile time the square root is calculated
+ * by Newton's iterations, which converge to the correctly rounded result or to one of its
+ * neighbours, at run time std::sqrt() is used.
+ * @param x - number to take square root of.
+ * @return square root of x.
+ */
+template <typename T> constexpr T sqrt(T x)noexcept{
+	if constexpr (std::is_floating_point_v<T>){
+		if(is_constant_evaluated()){
+			if(!(x >= T(0))){
+				return std::numeric_limits<T>::quiet_NaN();
+			}
+			if(x == T(0) || x == std::numeric_limits<T>::infinity()){
+				return x;
+			}
+
+			// starting from the value which is greater than the root the iterations decrease monotonically,
+			// stop as soon as the next iteration does not make the value smaller
+			T r = x > T(1) ? x : T(1);
+			for(;;){
+				T n = (r + x / r) / T(2);
+				if(!(n < r)){
+					return r;
+				}
+				r = n;
+			}
+		}
+	}else if constexpr (std::is_integral_v<T>){
+		return T(internal::sqrt(double(x)));
+	}
+	using std::sqrt;
+	return sqrt(x);
+}
+
+/**
+ * @brief Reciprocal square root.
+ * Calculates 1 / sqrt(x). For float, in case SIMD is enabled, the hardware reciprocal square root estimate
+ * refined by Newton-Raphson iteration is used at run time, the relative error of the result is below 2^-21,
+ * i.e. a few ULPs. For other types and at compile time the result is calculated as 1 / internal::sqrt(x).
+ * @param x - positive normal number to take reciprocal square root of.
+ * @return reciprocal square root of x.
+ */
+template <typename T> constexpr T rsqrt(T x)noexcept{
+	if constexpr (std::is_same_v<T, float> && simd::kernel<T, 4>::enabled){
+		if(!is_constant_evaluated()){
+			typedef simd::kernel<T, 4> simd_kernel;
+			std::array<T, 4> r;
+			simd_kernel::store(r.data(), simd_kernel::rsqrt(simd_kernel::set(x)));
+			return r[0];
+		}
+	}
+	return T(1) / internal::sqrt(x);
+}
+
+/**
+ * @brief Absolute value.
+ * Can be evaluated in constant expressions, at run time std::abs() is used.
+ * @param x - number to take absolute value of.
+ * @return absolute value of x.
+ */
+template <typename T> constexpr T abs(T x)noexcept{
+	if constexpr (std::is_arithmetic_v<T>){
+		if(is_constant_evaluated()){
+			// subtracting from 0 also turns negative zero to positive zero
+			return x <= T(0) ? T(0) - x : x;
+		}
+	}
+	using std::abs;
+	return abs(x);
+}
+
+// Sine or cosine by Taylor series, the argument is reduced to [-pi : pi] range first.
+template <typename T> constexpr T sin_cos_series(T x, bool cosine)noexcept{
+	constexpr auto two_pi = T(2) * utki::pi<T>();
+
+	auto k = x / two_pi;
+	x -= two_pi * T(static_cast<long long>(k < 0 ? k - T(0.5) : k + T(0.5)));
+
+	T term = cosine ? T(1) : x;
+	T sum = term;
+	T x2 = x * x;
+	for(unsigned n = cosine ? 1 : 2; ; n += 2){
+		term *= -x2 / T(n * (n + 1));
+		T next = sum + term;
+		if(next == sum){
+			return sum;
+		}
+		sum = next;
+	}
+}
+
+/**
+ * @brief Sine.
+ * Can be evaluated in constant expressions. At compile time the sine is calculated
+ * by Taylor series, at run time std::sin() is used.
+ * The compile time result may differ from the run time one by a few ULPs.
+ * @param x - angle in radians.
+ * @return sine of x.
+ */
+template <typename T> constexpr T sin(T x)noexcept{
+	if constexpr (std::is_floating_point_v<T>){
+		if(is_constant_evaluated()){
+			return sin_cos_series(x, false);
+		}
+	}
+	using std::sin;
+	return sin(x);
+}
+
+/**
+ * @brief Cosine.
+ * Can be evaluated in constant expressions. At compile time the cosine is calculated
+ * by Taylor series, at run time std::cos() is used.
+ * The compile time result may differ from the run time one by a few ULPs.
+ * @param x - angle in radians.
+ * @return cosine of x.
+ */
+template <typename T> constexpr T cos(T x)noexcept{
+	if constexpr (std::is_floating_point_v<T>){
+		if(is_constant_evaluated()){
+			return sin_cos_series(x, true);
+		}
+	}
+	using std::cos;
+	return cos(x);
+}
+
+/**
+ * @brief Check if fused multiply-add of given type is done by hardware.
+ * The check relies on FP_FAST_FMA* macros, which the standard library defines in case
+ * std::fma() is as fast as or faster than a separate multiplication and addition.
+ * @tparam T - type of the numbers.
+ * @return true in case std::fma() for T is backed by hardware instruction.
+ * @return false otherwise.
+ */
+template <typename T> constexpr bool has_fast_fma()noexcept{
+	if constexpr (std::is_same_v<T, float>){
+#if defined(FP_FAST_FMAF)
+		return true;
+#endif
+	}else if constexpr (std::is_same_v<T, double>){
+#if defined(FP_FAST_FMA)
+		return true;
+#endif
+	}else if constexpr (std::is_same_v<T, long double>){
+#if defined(FP_FAST_FMAL)
+		return true;
+#endif
+	}
+	return false;
+}
+
+/**
+ * @brief Multiply-add.
+ * Calculates a * b + c. In case the hardware supports fused multiply-add for T
+ * the result is calculated by std::fma(), i.e. with single rounding, otherwise by separate
+ * multiplication and addition, because software emulation of std::fma() is very slow.
+ * Can be evaluated in constant expressions, at compile time multiplication and addition are always separate.
+ * @param a - multiplicand.
+ * @param b - multiplier.
+ * @param c - addend.
+ * @return a * b + c.
+ */
+template <typename T> constexpr T mul_add(T a, T b, T c)noexcept{
+	if constexpr (has_fast_fma<T>()){
+		if(!is_constant_evaluated()){
+			return std::fma(a, b, c);
+		}
+	}
+	return a * b + c;
+}
+
+}
+}
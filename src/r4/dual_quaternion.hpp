@@ -0,0 +1,369 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "trs.hpp"
+
+namespace r4{
+
+/**
+ * @brief Dual quaternion.
+ * Dual quaternion q = r + e * d, where r is the real part, d is the dual part and e is the dual unit (e^2 = 0).
+ * Unit dual quaternions represent rigid transformations, i.e. rotation followed by translation.
+ * For rotation defined by unit quaternion r and translation t the dual part is d = 1/2 * t * r,
+ * where t is pure quaternion (t, 0).
+ * As for quaternion, operator% is the dual quaternion product and operator+ and multiplication by scalar
+ * are component-wise, the latter are used for linear blending of transformations.
+ * @tparam T - type of the components.
+ */
+template <class T> class dual_quaternion{
+	static_assert(std::is_floating_point_v<T>, "dual_quaternion is only defined for floating point types");
+
+public:
+	/**
+	 * @brief Real part.
+	 */
+	quaternion<T> real;
+
+	/**
+	 * @brief Dual part.
+	 */
+	quaternion<T> dual;
+
+	constexpr dual_quaternion() = default;
+
+	/**
+	 * @brief Construct dual quaternion from its parts.
+	 * @param real - real part.
+	 * @param dual - dual part.
+	 */
+	constexpr dual_quaternion(const quaternion<T>& real, const quaternion<T>& dual)noexcept :
+			real(real),
+			dual(dual)
+	{}
+
+	/**
+	 * @brief Construct rigid transformation.
+	 * The resulting transformation rotates first and then translates.
+	 * @param rotation - unit quaternion defining the rotation.
+	 * @param translation - translation.
+	 */
+	constexpr dual_quaternion(const quaternion<T>& rotation, const vector3<T>& translation)noexcept :
+			real(rotation),
+			dual(quaternion<T>(translation.x(), translation.y(), translation.z(), T(0)) % rotation * T(0.5))
+	{}
+
+	/**
+	 * @brief Construct rigid transformation from matrix.
+	 * The matrix must be a product of translation and rotation matrices, scale is ignored.
+	 * @param m - matrix to convert.
+	 */
+	constexpr explicit dual_quaternion(const matrix4<T>& m)noexcept :
+			dual_quaternion(trs<T>(m).rotation, vector3<T>(m[0][3], m[1][3], m[2][3]))
+	{}
+
+	/**
+	 * @brief Set to identity transformation.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& set_identity()noexcept{
+		this->real.set_identity();
+		this->dual = quaternion<T>(T(0), T(0), T(0), T(0));
+		return *this;
+	}
+
+	/**
+	 * @brief Add dual quaternion and assign.
+	 * @param q - dual quaternion to add.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& operator+=(const dual_quaternion& q)noexcept{
+		this->real += q.real;
+		this->dual += q.dual;
+		return *this;
+	}
+
+	/**
+	 * @brief Add dual quaternion.
+	 * @param q - dual quaternion to add.
+	 * @return sum of the dual quaternions.
+	 */
+	constexpr dual_quaternion operator+(const dual_quaternion& q)const noexcept{
+		return dual_quaternion(*this) += q;
+	}
+
+	/**
+	 * @brief Multiply by scalar and assign.
+	 * @param s - scalar to multiply by.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& operator*=(T s)noexcept{
+		this->real *= s;
+		this->dual *= s;
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply by scalar.
+	 * @param s - scalar to multiply by.
+	 * @return resulting dual quaternion.
+	 */
+	constexpr dual_quaternion operator*(T s)const noexcept{
+		return dual_quaternion(*this) *= s;
+	}
+
+	/**
+	 * @brief Multiply by scalar.
+	 * @param s - scalar to multiply by.
+	 * @param q - dual quaternion to multiply.
+	 * @return resulting dual quaternion.
+	 */
+	friend constexpr dual_quaternion operator*(T s, const dual_quaternion& q)noexcept{
+		return q * s;
+	}
+
+	/**
+	 * @brief Multiply-add.
+	 * Adds dual quaternion multiplied by scalar to this dual quaternion, i.e. this = q * s + this.
+	 * @param q - dual quaternion to multiply.
+	 * @param s - scalar to multiply by.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& mul_add(const dual_quaternion& q, T s)noexcept{
+		this->real.mul_add(q.real, s);
+		this->dual.mul_add(q.dual, s);
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply by dual quaternion from the right and assign.
+	 * For unit dual quaternions the result is composition of transformations, the given transformation
+	 * is applied first, as with matrices.
+	 * @param q - dual quaternion to multiply by.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& operator%=(const dual_quaternion& q)noexcept{
+		// (r1 + e * d1) * (r2 + e * d2) = r1 * r2 + e * (r1 * d2 + d1 * r2)
+		this->dual = this->real % q.dual + this->dual % q.real;
+		this->real %= q.real;
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply by dual quaternion from the right.
+	 * See operator%=().
+	 * @param q - dual quaternion to multiply by.
+	 * @return product of the dual quaternions.
+	 */
+	constexpr dual_quaternion operator%(const dual_quaternion& q)const noexcept{
+		return dual_quaternion(*this) %= q;
+	}
+
+	/**
+	 * @brief Conjugate.
+	 * Conjugates both parts as quaternions. For unit dual quaternion the result is the inverse transformation.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& conjugate()noexcept{
+		this->real.conjugate();
+		this->dual.conjugate();
+		return *this;
+	}
+
+	/**
+	 * @brief Get conjugate.
+	 * See conjugate().
+	 * @return conjugated dual quaternion.
+	 */
+	constexpr dual_quaternion operator!()const noexcept{
+		return dual_quaternion(!this->real, !this->dual);
+	}
+
+	/**
+	 * @brief Normalize.
+	 * Divides both parts by the norm of the real part, so that the real part becomes unit quaternion.
+	 * In case the dual quaternion is a linear blend of unit dual quaternions, the dual part is not exactly
+	 * orthogonal to the real part, but translation() only uses the vector part of 2 * d * r^-1,
+	 * so the normalized blend still represents a rigid transformation.
+	 * @return reference to this dual quaternion.
+	 */
+	constexpr dual_quaternion& normalize()noexcept{
+		return this->operator*=(T(1) / this->real.norm());
+	}
+
+	/**
+	 * @brief Get rotation.
+	 * @return the real part, which is the rotation of unit dual quaternion.
+	 */
+	constexpr const quaternion<T>& rotation()const noexcept{
+		return this->real;
+	}
+
+	/**
+	 * @brief Get translation.
+	 * Defined only for unit dual quaternions.
+	 * @return translation.
+	 */
+	constexpr vector3<T> translation()const noexcept{
+		// t = 2 * d * r^-1, r^-1 is the conjugate of the unit real part
+		const auto& r = this->real;
+		const auto& d = this->dual;
+		return vector3<T>(
+				d.w() * r.x() - d.x() * r.w() + d.y() * r.z() - d.z() * r.y(),
+				d.w() * r.y() - d.y() * r.w() + d.z() * r.x() - d.x() * r.z(),
+				d.w() * r.z() - d.z() * r.w() + d.x() * r.y() - d.y() * r.x()
+			) * T(-2);
+	}
+
+	/**
+	 * @brief Transform point.
+	 * Defined only for unit dual quaternions.
+	 * @param p - point to transform.
+	 * @return rotated and translated point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return vector3<T>(p).rotate(this->real) + this->translation();
+	}
+
+	/**
+	 * @brief Convert to matrix.
+	 * Defined only for unit dual quaternions.
+	 * @return transformation matrix.
+	 */
+	constexpr matrix4<T> to_matrix()const noexcept{
+		matrix4<T> m(this->real);
+		auto t = this->translation();
+		for(size_t r = 0; r != 3; ++r){
+			m[r][3] = t[r];
+		}
+		return m;
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const dual_quaternion& q){
+		return s << "(" << q.real << ") + e(" << q.dual << ")";
+	}
+};
+
+/**
+ * @brief Bone influences of a skinned vertex.
+ * Unused influences must have zero weight and a valid bone index, e.g. 0.
+ * Bone indices are 32 bit to keep the record compact.
+ * @tparam T - type of the weights.
+ * @tparam N - maximum number of bones influencing the vertex.
+ */
+template <class T, size_t N> struct bone_influences{
+	/**
+	 * @brief Indices of the influencing bones.
+	 */
+	std::array<uint32_t, N> bones;
+
+	/**
+	 * @brief Weights of the influencing bones.
+	 * Sum of the weights should be 1.
+	 */
+	std::array<T, N> weights;
+};
+
+namespace internal{
+
+// Blends bone transformations with weights, in case the real part of the bone transformation is in the
+// opposite hemisphere to the first bone, the weight is negated, so that the blend goes along the shortest path.
+template <class T, size_t N>
+dual_quaternion<T> blend(utki::span<const dual_quaternion<T>> bones, const bone_influences<T, N>& inf)noexcept{
+	static_assert(N >= 1, "at least one bone influence is needed");
+
+	const auto& first = bones[inf.bones[0]];
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		typedef simd::kernel<T, 4> simd_kernel;
+		typedef typename simd_kernel::reg reg;
+
+		reg w = simd_kernel::set(inf.weights[0]);
+		reg real = simd_kernel::mul(simd_kernel::load(first.real.data()), w);
+		reg dual = simd_kernel::mul(simd_kernel::load(first.dual.data()), w);
+		for(size_t i = 1; i != N; ++i){
+			ASSERT(inf.bones[i] < bones.size())
+			const auto& b = bones[inf.bones[i]];
+			w = simd_kernel::set(b.real * first.real < T(0) ? -inf.weights[i] : inf.weights[i]);
+			real = simd_kernel::fma(simd_kernel::load(b.real.data()), w, real);
+			dual = simd_kernel::fma(simd_kernel::load(b.dual.data()), w, dual);
+		}
+
+		dual_quaternion<T> ret;
+		simd_kernel::store(ret.real.data(), real);
+		simd_kernel::store(ret.dual.data(), dual);
+		return ret;
+	}else{
+		auto ret = first * inf.weights[0];
+		for(size_t i = 1; i != N; ++i){
+			ASSERT(inf.bones[i] < bones.size())
+			const auto& b = bones[inf.bones[i]];
+			ret.mul_add(b, b.real * first.real < T(0) ? -inf.weights[i] : inf.weights[i]);
+		}
+		return ret;
+	}
+}
+
+}
+
+/**
+ * @brief Dual quaternion linear blend skinning.
+ * For each vertex blends the transformations of the influencing bones with the vertex weights,
+ * normalizes the blended dual quaternion and transforms the vertex position with it.
+ * Unlike blending of matrices, the blend is always a rigid transformation, so the skinned mesh does not collapse
+ * around the joints.
+ * Output span can be the same as the input span.
+ * @param bones - bone transformations, unit dual quaternions.
+ * @param influences - bone influences for each vertex.
+ * @param in - vertex positions.
+ * @param out - span to store the skinned positions to. Must be of the same size as the input span.
+ * @tparam I - type of bone influences, bone_influences<T, N> or const bone_influences<T, N>.
+ */
+template <class T, class I>
+void skin(
+		utki::span<const dual_quaternion<std::common_type_t<T>>> bones,
+		utki::span<I> influences,
+		utki::span<const vector3<std::common_type_t<T>>> in,
+		utki::span<vector3<T>> out
+	)noexcept
+{
+	ASSERT(influences.size() == in.size())
+	ASSERT(in.size() == out.size())
+
+	for(size_t i = 0; i != in.size(); ++i){
+		ASSERT(influences[i].bones[0] < bones.size())
+		out[i] = internal::blend(bones, influences[i]).normalize() * in[i];
+	}
+}
+
+}
@@ -0,0 +1,411 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <type_traits>
+
+#include "matrix.hpp"
+
+// Expression templates for component-wise vector and matrix arithmetic.
+// Regular vector and matrix operators create a temporary object for each operation,
+// e.g. a + b * s - c creates three temporary vectors. With expression templates
+// the operators build a lightweight expression object instead and the whole expression
+// is evaluated in a single loop when it is assigned to a vector or matrix, without any temporaries.
+//
+// Usage example:
+//     using r4::expr::lazy;
+//     r4::vector3<float> pos = lazy(pos) + lazy(vel) * dt + lazy(acc) * (dt * dt / 2);
+//
+// NOTE: expressions hold references to the vectors and matrices they are built from,
+//       so expressions must not outlive those, i.e. expressions should not be stored
+//       in 'auto' variables, but evaluated right away.
+
+namespace r4{
+namespace expr{
+
+/**
+ * @brief Base class of all expressions.
+ * @tparam E - actual expression type.
+ */
+template <class E> class expression{
+public:
+	/**
+	 * @brief Evaluate the expression.
+	 * @return vector or matrix which is the result of the expression.
+	 */
+	template <class R, class EE = E, std::enable_if_t<std::is_same_v<R, typename EE::result_type>, bool> = true>
+	constexpr operator R()const noexcept{
+		const auto& e = static_cast<const EE&>(*this);
+		R ret{};
+		for(size_t i = 0; i != EE::size; ++i){
+			EE::traits::get(ret, i) = e[i];
+		}
+		return ret;
+	}
+};
+
+namespace internal{
+
+template <class V> struct operand_traits{
+	static constexpr bool is_operand = false;
+};
+
+template <class T, size_t S> struct operand_traits<vector<T, S>>{
+	static constexpr bool is_operand = true;
+	static constexpr bool is_vector = true;
+	static constexpr size_t size = S;
+	typedef T value_type;
+
+	static constexpr const T& get(const vector<T, S>& v, size_t i)noexcept{
+		return v[i];
+	}
+
+	static constexpr T& get(vector<T, S>& v, size_t i)noexcept{
+		return v[i];
+	}
+};
+
+// matrix elements are accessed by index of the element in row-major order,
+// since number of columns is known at compile time the division is cheap and
+// the loop over elements of fixed size matrix is unrolled by the compiler anyway
+template <class T, size_t R, size_t C> struct operand_traits<matrix<T, R, C>>{
+	static constexpr bool is_operand = true;
+	static constexpr bool is_vector = false;
+	static constexpr size_t size = R * C;
+	typedef T value_type;
+
+	static constexpr const T& get(const matrix<T, R, C>& m, size_t i)noexcept{
+		return m[i / C][i % C];
+	}
+
+	static constexpr T& get(matrix<T, R, C>& m, size_t i)noexcept{
+		return m[i / C][i % C];
+	}
+};
+
+template <class A> constexpr bool is_expression_v = std::is_base_of_v<expression<A>, A>;
+
+template <class A> constexpr bool is_operand_v = is_expression_v<A> || operand_traits<A>::is_operand;
+
+// enables binary operator in case at least one of its operands is an expression,
+// so that operators on plain vectors and matrices are not affected
+template <class A, class B>
+using enable_if_operands_t = std::enable_if_t<
+		(is_expression_v<A> || is_expression_v<B>) && is_operand_v<A> && is_operand_v<B>,
+		bool
+	>;
+
+struct add{
+	template <class T> static constexpr T apply(T a, T b)noexcept{
+		return a + b;
+	}
+};
+
+struct subtract{
+	template <class T> static constexpr T apply(T a, T b)noexcept{
+		return a - b;
+	}
+};
+
+struct multiply{
+	template <class T> static constexpr T apply(T a, T b)noexcept{
+		return a * b;
+	}
+};
+
+struct divide{
+	template <class T> static constexpr T apply(T a, T b)noexcept{
+		return a / b;
+	}
+};
+
+}
+
+/**
+ * @brief Expression referring to a vector or a matrix.
+ * @tparam V - vector or matrix type.
+ */
+template <class V> class terminal : public expression<terminal<V>>{
+	const V& v;
+public:
+	typedef internal::operand_traits<V> traits;
+	typedef V result_type;
+	typedef typename traits::value_type value_type;
+	static constexpr size_t size = traits::size;
+
+	constexpr explicit terminal(const V& v)noexcept :
+			v(v)
+	{}
+
+	constexpr value_type operator[](size_t i)const noexcept{
+		return traits::get(this->v, i);
+	}
+};
+
+/**
+ * @brief Component-wise binary operation expression.
+ * @tparam O - operation.
+ * @tparam L - left operand expression type.
+ * @tparam R - right operand expression type.
+ */
+template <class O, class L, class R> class binary : public expression<binary<O, L, R>>{
+	static_assert(
+			std::is_same_v<typename L::result_type, typename R::result_type>,
+			"operands of component-wise operation must be of same type"
+		);
+
+	L l;
+	R r;
+public:
+	typedef typename L::traits traits;
+	typedef typename L::result_type result_type;
+	typedef typename L::value_type value_type;
+	static constexpr size_t size = L::size;
+
+	constexpr binary(const L& l, const R& r)noexcept :
+			l(l),
+			r(r)
+	{}
+
+	constexpr value_type operator[](size_t i)const noexcept{
+		return O::apply(this->l[i], this->r[i]);
+	}
+};
+
+/**
+ * @brief Expression of operation between each component and a scalar.
+ * @tparam O - operation.
+ * @tparam E - operand expression type.
+ */
+template <class O, class E> class scalar : public expression<scalar<O, E>>{
+	E e;
+	typename E::value_type s;
+public:
+	typedef typename E::traits traits;
+	typedef typename E::result_type result_type;
+	typedef typename E::value_type value_type;
+	static constexpr size_t size = E::size;
+
+	constexpr scalar(const E& e, value_type s)noexcept :
+			e(e),
+			s(s)
+	{}
+
+	constexpr value_type operator[](size_t i)const noexcept{
+		return O::apply(this->e[i], this->s);
+	}
+};
+
+/**
+ * @brief Component-wise negation expression.
+ * @tparam E - operand expression type.
+ */
+template <class E> class negation : public expression<negation<E>>{
+	E e;
+public:
+	typedef typename E::traits traits;
+	typedef typename E::result_type result_type;
+	typedef typename E::value_type value_type;
+	static constexpr size_t size = E::size;
+
+	constexpr explicit negation(const E& e)noexcept :
+			e(e)
+	{}
+
+	constexpr value_type operator[](size_t i)const noexcept{
+		return -this->e[i];
+	}
+};
+
+namespace internal{
+
+template <class A> using expression_t = std::conditional_t<is_expression_v<A>, A, terminal<A>>;
+
+template <class A> constexpr expression_t<A> as_expression(const A& a)noexcept{
+	if constexpr (is_expression_v<A>){
+		return a;
+	}else{
+		return terminal<A>(a);
+	}
+}
+
+template <class O, class A, class B> constexpr binary<O, expression_t<A>, expression_t<B>> make_binary(const A& a, const B& b)noexcept{
+	return binary<O, expression_t<A>, expression_t<B>>(as_expression(a), as_expression(b));
+}
+
+}
+
+/**
+ * @brief Start lazily evaluated expression.
+ * @param v - vector to use in expression.
+ * @return expression referring to the vector.
+ */
+template <class T, size_t S> constexpr terminal<vector<T, S>> lazy(const vector<T, S>& v)noexcept{
+	return terminal<vector<T, S>>(v);
+}
+
+/**
+ * @brief Start lazily evaluated expression.
+ * @param m - matrix to use in expression.
+ * @return expression referring to the matrix.
+ */
+template <class T, size_t R, size_t C> constexpr terminal<matrix<T, R, C>> lazy(const matrix<T, R, C>& m)noexcept{
+	return terminal<matrix<T, R, C>>(m);
+}
+
+/**
+ * @brief Evaluate expression.
+ * @param e - expression to evaluate.
+ * @return vector or matrix which is the result of the expression.
+ */
+template <class E> constexpr typename E::result_type eval(const expression<E>& e)noexcept{
+	typename E::result_type ret = e;
+	return ret;
+}
+
+/**
+ * @brief Component-wise addition.
+ * At least one of the operands has to be an expression, the other can be a vector or matrix.
+ */
+template <class A, class B, internal::enable_if_operands_t<A, B> = true>
+constexpr auto operator+(const A& a, const B& b)noexcept{
+	return internal::make_binary<internal::add>(a, b);
+}
+
+/**
+ * @brief Component-wise subtraction.
+ * At least one of the operands has to be an expression, the other can be a vector or matrix.
+ */
+template <class A, class B, internal::enable_if_operands_t<A, B> = true>
+constexpr auto operator-(const A& a, const B& b)noexcept{
+	return internal::make_binary<internal::subtract>(a, b);
+}
+
+/**
+ * @brief Component-wise multiplication.
+ * At least one of the operands has to be an expression, the other can be a vector or matrix.
+ */
+template <class A, class B, internal::enable_if_operands_t<A, B> = true>
+constexpr auto comp_mul(const A& a, const B& b)noexcept{
+	return internal::make_binary<internal::multiply>(a, b);
+}
+
+/**
+ * @brief Component-wise division.
+ * At least one of the operands has to be an expression, the other can be a vector or matrix.
+ */
+template <class A, class B, internal::enable_if_operands_t<A, B> = true>
+constexpr auto comp_div(const A& a, const B& b)noexcept{
+	return internal::make_binary<internal::divide>(a, b);
+}
+
+/**
+ * @brief Negation.
+ */
+template <class E> constexpr negation<E> operator-(const expression<E>& e)noexcept{
+	return negation<E>(static_cast<const E&>(e));
+}
+
+/**
+ * @brief Multiply each component by scalar.
+ */
+template <class E> constexpr scalar<internal::multiply, E> operator*(const expression<E>& e, typename E::value_type s)noexcept{
+	return scalar<internal::multiply, E>(static_cast<const E&>(e), s);
+}
+
+/**
+ * @brief Multiply each component by scalar.
+ */
+template <class E> constexpr scalar<internal::multiply, E> operator*(typename E::value_type s, const expression<E>& e)noexcept{
+	return scalar<internal::multiply, E>(static_cast<const E&>(e), s);
+}
+
+/**
+ * @brief Divide each component by scalar.
+ */
+template <class E> constexpr scalar<internal::divide, E> operator/(const expression<E>& e, typename E::value_type s)noexcept{
+	return scalar<internal::divide, E>(static_cast<const E&>(e), s);
+}
+
+/**
+ * @brief Dot product.
+ * Defined only for vector expressions. The dot product is calculated in the same
+ * loop as the expressions of the operands, without evaluating those to temporary vectors.
+ * At least one of the operands has to be an expression, the other can be a vector.
+ * @return dot product of the operands.
+ */
+template <class A, class B, internal::enable_if_operands_t<A, B> = true>
+constexpr auto operator*(const A& a, const B& b)noexcept ->
+		std::enable_if_t<
+				internal::expression_t<A>::traits::is_vector,
+				typename internal::expression_t<A>::value_type
+			>
+{
+	auto ea = internal::as_expression(a);
+	auto eb = internal::as_expression(b);
+	static_assert(
+			std::is_same_v<typename decltype(ea)::result_type, typename decltype(eb)::result_type>,
+			"operands of dot product must be of same type"
+		);
+
+	typename decltype(ea)::value_type ret = 0;
+	for(size_t i = 0; i != decltype(ea)::size; ++i){
+		ret += ea[i] * eb[i];
+	}
+	return ret;
+}
+
+/**
+ * @brief Add expression to vector or matrix.
+ * @param v - vector or matrix to add to.
+ * @param e - expression to add.
+ * @return reference to v.
+ */
+template <class V, class E> constexpr std::enable_if_t<std::is_same_v<V, typename E::result_type>, V&> operator+=(V& v, const expression<E>& e)noexcept{
+	const auto& ee = static_cast<const E&>(e);
+	for(size_t i = 0; i != E::size; ++i){
+		E::traits::get(v, i) += ee[i];
+	}
+	return v;
+}
+
+/**
+ * @brief Subtract expression from vector or matrix.
+ * @param v - vector or matrix to subtract from.
+ * @param e - expression to subtract.
+ * @return reference to v.
+ */
+template <class V, class E> constexpr std::enable_if_t<std::is_same_v<V, typename E::result_type>, V&> operator-=(V& v, const expression<E>& e)noexcept{
+	const auto& ee = static_cast<const E&>(e);
+	for(size_t i = 0; i != E::size; ++i){
+		E::traits::get(v, i) -= ee[i];
+	}
+	return v;
+}
+
+}
+}
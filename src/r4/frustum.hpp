@@ -0,0 +1,300 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <algorithm>
+
+#include <utki/span.hpp>
+
+#include "matrix.hpp"
+#include "simd.hpp"
+
+namespace r4{
+
+/**
+ * @brief View frustum.
+ * The frustum is given by six planes, extracted from a view-projection matrix.
+ * Each plane is stored as a 4d vector (a, b, c, d) such that the point (x, y, z) is on the inner side of the plane
+ * if a * x + b * y + c * z + d >= 0. The (a, b, c) part of the plane is normalized, so the plane equation gives
+ * the signed distance from the point to the plane.
+ * The frustum is used to cull spheres and axis aligned boxes which are not visible.
+ * The culling is conservative, i.e. objects outside of the frustum near its edges and corners can
+ * be reported as visible, but visible objects are never culled.
+ * Batch culling functions produce bitmasks of visible objects, bit (i % 32) of the mask word (i / 32)
+ * corresponds to i-th object.
+ * @tparam T - type of the plane coefficients, must be floating point.
+ */
+template <class T> class frustum{
+	static_assert(std::is_floating_point_v<T>, "frustum is only defined for floating point types");
+
+	typedef simd::kernel<T, 4> simd_kernel;
+
+public:
+	/**
+	 * @brief Frustum planes.
+	 * The planes order is: left, right, bottom, top, near, far.
+	 */
+	std::array<vector4<T>, 6> planes;
+
+	/**
+	 * @brief Extract frustum planes from matrix.
+	 * The matrix transforms points to clip space, in which the frustum is -w <= x, y, z <= w,
+	 * as produced by matrix::set_frustum().
+	 * Given a projection matrix the planes are in view space, given a view-projection matrix the planes are
+	 * in world space, given a model-view-projection matrix the planes are in the model's space.
+	 * @param m - matrix to extract planes from.
+	 */
+	constexpr explicit frustum(const matrix4<T>& m)noexcept :
+			planes{{
+				m[3] + m[0],
+				m[3] - m[0],
+				m[3] + m[1],
+				m[3] - m[1],
+				m[3] + m[2],
+				m[3] - m[2]
+			}}
+	{
+		for(auto& p : this->planes){
+			T n = vector3<T>(p).norm();
+			ASSERT(n != 0)
+			p /= n;
+		}
+	}
+
+	/**
+	 * @brief Calculate size of visibility bitmask.
+	 * @param num_objects - number of objects to cull.
+	 * @return number of bitmask words needed to hold visibility bits of the given number of objects.
+	 */
+	static constexpr size_t mask_size(size_t num_objects)noexcept{
+		return (num_objects + 31) / 32;
+	}
+
+	/**
+	 * @brief Signed distance from point to plane.
+	 * @param plane - index of the plane.
+	 * @param p - point.
+	 * @return distance from the point to the plane, negative if the point is on the outer side of the plane.
+	 */
+	constexpr T distance(size_t plane, const vector3<T>& p)const noexcept{
+		ASSERT(plane < this->planes.size())
+		const auto& pl = this->planes[plane];
+		return internal::mul_add(pl.x(), p.x(), internal::mul_add(pl.y(), p.y(), internal::mul_add(pl.z(), p.z(), pl.w())));
+	}
+
+	/**
+	 * @brief Check if point is inside of the frustum.
+	 * @param p - point to check.
+	 * @return true if the point is inside of the frustum or on its boundary.
+	 * @return false otherwise.
+	 */
+	constexpr bool contains(const vector3<T>& p)const noexcept{
+		return this->overlaps(p, T(0));
+	}
+
+	/**
+	 * @brief Check if sphere overlaps the frustum.
+	 * @param center - center of the sphere.
+	 * @param radius - radius of the sphere.
+	 * @return true if the sphere is potentially visible.
+	 * @return false if the sphere is entirely outside of the frustum.
+	 */
+	constexpr bool overlaps(const vector3<T>& center, T radius)const noexcept{
+		for(size_t i = 0; i != this->planes.size(); ++i){
+			if(this->distance(i, center) < -radius){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Check if axis aligned box overlaps the frustum.
+	 * @param min - minimum corner of the box.
+	 * @param max - maximum corner of the box.
+	 * @return true if the box is potentially visible.
+	 * @return false if the box is entirely outside of the frustum.
+	 */
+	constexpr bool overlaps(const vector3<T>& min, const vector3<T>& max)const noexcept{
+		auto center = (min + max) / T(2);
+		auto extent = (max - min) / T(2);
+		for(size_t i = 0; i != this->planes.size(); ++i){
+			// the box corner which is farthest along the plane normal is the last one to leave the frustum
+			if(this->distance(i, center) < -(abs(vector3<T>(this->planes[i])) * extent)){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Cull spheres.
+	 * @param spheres - spheres to cull, each sphere is given by its center (x, y, z) and radius (w).
+	 * @param visible - output visibility bitmask, must be of at least mask_size(spheres.size()) words.
+	 * @return number of potentially visible spheres.
+	 */
+	size_t cull(utki::span<const vector4<T>> spheres, utki::span<uint32_t> visible)const noexcept{
+		ASSERT(visible.size() >= mask_size(spheres.size()))
+		std::fill(visible.begin(), std::next(visible.begin(), mask_size(spheres.size())), 0);
+
+		size_t i = 0;
+		if constexpr (simd_kernel::enabled){
+			typedef typename simd_kernel::reg reg;
+
+			// broadcasted plane coefficients
+			reg pl[6][4];
+			for(size_t p = 0; p != this->planes.size(); ++p){
+				for(size_t c = 0; c != 4; ++c){
+					pl[p][c] = simd_kernel::set(this->planes[p][c]);
+				}
+			}
+			const reg zero = simd_kernel::set(T(0));
+
+			for(; i + 4 <= spheres.size(); i += 4){
+				// transpose to have same components of all 4 spheres in one register
+				reg s[4];
+				for(size_t j = 0; j != 4; ++j){
+					s[j] = simd_kernel::load(spheres[i + j].data());
+				}
+				simd_kernel::transpose(s[0], s[1], s[2], s[3]);
+
+				unsigned culled = 0;
+				for(const auto& p : pl){
+					// distance from center to plane plus radius
+					reg d = simd_kernel::fma(p[0], s[0],
+							simd_kernel::fma(p[1], s[1],
+									simd_kernel::fma(p[2], s[2], simd_kernel::add(p[3], s[3]))
+								)
+						);
+					culled |= simd_kernel::lt_mask(d, zero);
+				}
+				visible[i / 32] |= uint32_t(~culled & 0xf) << (i % 32);
+			}
+		}
+
+		for(; i < spheres.size(); ++i){
+			const auto& s = spheres[i];
+			if(this->overlaps(vector3<T>(s), s.w())){
+				visible[i / 32] |= uint32_t(1) << (i % 32);
+			}
+		}
+
+		return count(visible, spheres.size());
+	}
+
+	/**
+	 * @brief Cull axis aligned boxes.
+	 * @param min - minimum corners of the boxes.
+	 * @param max - maximum corners of the boxes, must be of the same size as min.
+	 * @param visible - output visibility bitmask, must be of at least mask_size(min.size()) words.
+	 * @return number of potentially visible boxes.
+	 */
+	size_t cull(utki::span<const vector3<T>> min, utki::span<const vector3<T>> max, utki::span<uint32_t> visible)const noexcept{
+		ASSERT(min.size() == max.size())
+		ASSERT(visible.size() >= mask_size(min.size()))
+		std::fill(visible.begin(), std::next(visible.begin(), mask_size(min.size())), 0);
+
+		size_t i = 0;
+		if constexpr (simd_kernel::enabled){
+			typedef typename simd_kernel::reg reg;
+
+			// broadcasted plane coefficients and absolute values of plane normal components
+			reg pl[6][4];
+			reg an[6][3];
+			for(size_t p = 0; p != this->planes.size(); ++p){
+				for(size_t c = 0; c != 4; ++c){
+					pl[p][c] = simd_kernel::set(this->planes[p][c]);
+				}
+				for(size_t c = 0; c != 3; ++c){
+					an[p][c] = simd_kernel::abs(pl[p][c]);
+				}
+			}
+			const reg zero = simd_kernel::set(T(0));
+			const reg half = simd_kernel::set(T(0.5));
+
+			for(; i + 4 <= min.size(); i += 4){
+				// gather same components of all 4 boxes to have those in one register
+				std::array<std::array<T, 4>, 3> mn;
+				std::array<std::array<T, 4>, 3> mx;
+				for(size_t j = 0; j != 4; ++j){
+					for(size_t c = 0; c != 3; ++c){
+						mn[c][j] = min[i + j][c];
+						mx[c][j] = max[i + j][c];
+					}
+				}
+
+				reg center[3];
+				reg extent[3];
+				for(size_t c = 0; c != 3; ++c){
+					reg a = simd_kernel::load(mn[c].data());
+					reg b = simd_kernel::load(mx[c].data());
+					center[c] = simd_kernel::mul(simd_kernel::add(a, b), half);
+					extent[c] = simd_kernel::mul(simd_kernel::sub(b, a), half);
+				}
+
+				unsigned culled = 0;
+				for(size_t p = 0; p != this->planes.size(); ++p){
+					// distance from center to plane plus projection of the box extent onto the plane normal
+					reg d = simd_kernel::fma(pl[p][0], center[0],
+							simd_kernel::fma(pl[p][1], center[1],
+									simd_kernel::fma(pl[p][2], center[2], pl[p][3])
+								)
+						);
+					d = simd_kernel::fma(an[p][0], extent[0],
+							simd_kernel::fma(an[p][1], extent[1],
+									simd_kernel::fma(an[p][2], extent[2], d)
+								)
+						);
+					culled |= simd_kernel::lt_mask(d, zero);
+				}
+				visible[i / 32] |= uint32_t(~culled & 0xf) << (i % 32);
+			}
+		}
+
+		for(; i < min.size(); ++i){
+			if(this->overlaps(min[i], max[i])){
+				visible[i / 32] |= uint32_t(1) << (i % 32);
+			}
+		}
+
+		return count(visible, min.size());
+	}
+
+private:
+	static size_t count(utki::span<const uint32_t> mask, size_t num_objects)noexcept{
+		size_t ret = 0;
+		for(size_t i = 0; i != mask_size(num_objects); ++i){
+			ret += std::bitset<32>(mask[i]).count();
+		}
+		return ret;
+	}
+};
+
+}
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include "vector.hpp"
 #include "quaternion.hpp"
+#include "simd.hpp"
 
 // undefine possibly defined macro
 #ifdef minor
@@ -38,6 +39,62 @@ SOFTWARE.
 
 namespace r4{
 
+template <class T, size_t R, size_t C> class matrix;
+
+namespace internal{
+
+// SIMD kernel of matrix product, matrices are given as pointers to their rows which are stored one after another
+// without gaps. Each row of the product is a linear combination of rows of the right matrix with coefficients from
+// the corresponding row of the left matrix, so the elements of the left matrix are broadcast to SIMD registers
+// and multiplied by the rows of the right matrix held in SIMD registers.
+// All inputs are read before any output is written, so the output can be the same as any of the inputs.
+// The kernel is defined only for 4x4 matrices, in case SIMD kernel for 4 numbers of type T is enabled.
+// Rows of 3x3 and 2x3 matrices do not fill whole SIMD register, loading and storing those
+// without lane shuffling operations costs more than the scalar implementation.
+template <class T, size_t R, size_t C, bool = simd::kernel<T, 4>::enabled> struct matrix_product{
+	static constexpr bool enabled = false;
+};
+
+// Returns product of two matrices calculated by the SIMD kernel.
+template <class T, size_t R, size_t C> matrix<T, R, C> simd_product(const matrix<T, R, C>& a, const matrix<T, R, C>& b)noexcept{
+	matrix<T, R, C> ret;
+	matrix_product<T, R, C>::mul(a[0].data(), b[0].data(), ret[0].data());
+	return ret;
+}
+
+// 4x4 matrices, each row occupies exactly one SIMD register.
+template <class T> struct matrix_product<T, 4, 4, true>{
+	typedef simd::kernel<T, 4> simd_kernel;
+	typedef typename simd_kernel::reg reg;
+
+	static constexpr bool enabled = true;
+
+	static reg mul_row(const T* a, const reg* b)noexcept{
+		return simd_kernel::add(
+				simd_kernel::fma(simd_kernel::set(a[0]), b[0], simd_kernel::mul(simd_kernel::set(a[1]), b[1])),
+				simd_kernel::fma(simd_kernel::set(a[2]), b[2], simd_kernel::mul(simd_kernel::set(a[3]), b[3]))
+			);
+	}
+
+	static void mul(const T* a, const T* b, T* out)noexcept{
+		reg rb[4];
+		for(size_t i = 0; i != 4; ++i){
+			rb[i] = simd_kernel::load(b + i * 4);
+		}
+
+		reg r[4];
+		for(size_t i = 0; i != 4; ++i){
+			r[i] = mul_row(a + i * 4, rb);
+		}
+
+		for(size_t i = 0; i != 4; ++i){
+			simd_kernel::store(out + i * 4, r[i]);
+		}
+	}
+};
+
+}
+
 template <class T, size_t R, size_t C> class matrix : public std::array<vector<T, C>, R>{
 	static_assert(R >= 1, "matrix cannot have 0 rows");
 	typedef std::array<vector<T, C>, R> base_type;
@@ -91,7 +148,9 @@ public:
 	 * @param quat - unit quaternion defining the rotation.
 	 */
 	template <typename E = T>
-	constexpr matrix(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& quat)noexcept{
+	constexpr matrix(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& quat)noexcept :
+			base_type{}
+	{
 		this->set(quat);
 	}
 
@@ -99,8 +158,8 @@ public:
 	 * @brief Convert to different element type.
 	 * @return matrix with converted element type.
 	 */
-	template <typename TT> matrix<TT, R, C> to()noexcept{
-		matrix<TT, R, C> ret;
+	template <typename TT> constexpr matrix<TT, R, C> to()noexcept{
+		matrix<TT, R, C> ret{};
 		for(size_t i = 0; i != R; ++i){
 			ret[i] = this->row(i).template to<TT>();
 		}
@@ -114,7 +173,7 @@ public:
 	 * @param quat - unit quaternion defining the rotation.
 	 * @return Reference to this matrix object.
 	 */
-	template <typename E = T> matrix& set(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& quat)noexcept{
+	template <typename E = T> constexpr matrix& set(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& quat)noexcept{
 		// Quaternion to matrix conversion:
 		//     |  1-(2y^2+2z^2)   2xy-2zw         2xz+2yw         0   |
 		// M = |  2xy+2zw         1-(2x^2+2z^2)   2yz-2xw         0   |
@@ -155,7 +214,7 @@ public:
 	 * @param r - row number to get.
 	 * @return reference to vector representing the row of this matrix.
 	 */
-	vector<T, C>& row(size_t r)noexcept{
+	constexpr vector<T, C>& row(size_t r)noexcept{
 		ASSERT(r < this->size())
 		return this->operator[](r);
 	}
@@ -165,7 +224,7 @@ public:
 	 * @param r - row number to get.
 	 * @return reference to vector representing the row of this matrix.
 	 */
-	const vector<T, C>& row(size_t r)const noexcept{
+	constexpr const vector<T, C>& row(size_t r)const noexcept{
 		ASSERT(r < this->size())
 		return this->operator[](r);
 	}
@@ -175,8 +234,8 @@ public:
 	 * @param m - matrix to subtract from this matrix.
 	 * @return resulting matrix of the subtraction.
 	 */
-	matrix operator-(const matrix& m)const noexcept{
-		matrix res;
+	constexpr matrix operator-(const matrix& m)const noexcept{
+		matrix res{};
 		for(size_t r = 0; r != R; ++r){
 			res[r] = this->row(r) - m[r];
 		}
@@ -190,9 +249,9 @@ public:
 	 * @param vec - vector to transform. Must have same number of components, as number of columns in this matrix.
 	 * @return Transformed vector.
 	 */
-	vector<T, R> operator*(const vector<T, C>& vec)const noexcept
+	constexpr vector<T, R> operator*(const vector<T, C>& vec)const noexcept
 	{
-		vector<T, R> r;
+		vector<T, R> r{};
 		for(size_t i = 0; i != R; ++i){
 			r[i] = this->row(i) * vec;
 		}
@@ -200,7 +259,7 @@ public:
 	}
 
 	template <size_t S, typename E = T>
-	vector<std::enable_if_t<
+	constexpr vector<std::enable_if_t<
 			(R == 2 && C == 3 && S == 2),
 			E
 		>, S> operator*(const vector<T, S>& vec)const noexcept
@@ -226,14 +285,20 @@ public:
 	 * @return New matrix of size RxCC as a result of matrices product.
 	 */
 	template <size_t CC>
-	matrix<T, R, CC> operator*(const matrix<T, C, CC>& m)const noexcept{
-		matrix<T, R, CC> ret;
+	constexpr matrix<T, R, CC> operator*(const matrix<T, C, CC>& m)const noexcept{
+		if constexpr (R == C && C == CC && internal::matrix_product<T, R, C>::enabled){
+			if(!internal::is_constant_evaluated()){
+				return internal::simd_product(*this, m);
+			}
+		}
+
+		matrix<T, R, CC> ret{};
 		for(size_t rd = 0; rd != ret.size(); ++rd){
 			auto& row_d = ret[rd];
 			for(size_t cd = 0; cd != row_d.size(); ++cd){
 				T v = 0;
 				for(size_t i = 0; i != C; ++i){
-					v += this->row(rd)[i] * m[i][cd];
+					v = internal::mul_add(this->row(rd)[i], m[i][cd], v);
 				}
 				ret[rd][cd] = v;
 			}
@@ -243,17 +308,17 @@ public:
 
 	// Define operaotr*(matrix) for 2x3 matrices. See description of operator*(matrix) for square matrices for info.
 	template <typename E = matrix>
-	std::enable_if_t<R == 2 && C == 3, E> operator*(const matrix& matr)const noexcept{
+	constexpr std::enable_if_t<R == 2 && C == 3, E> operator*(const matrix& matr)const noexcept{
 		return matrix{
 				vector<T, 3>{
-						this->row(0)[0] * matr[0][0] + this->row(0)[1] * matr[1][0],
-						this->row(0)[0] * matr[0][1] + this->row(0)[1] * matr[1][1],
-						this->row(0)[0] * matr[0][2] + this->row(0)[1] * matr[1][2] + this->row(0)[2]
+						internal::mul_add(this->row(0)[0], matr[0][0], this->row(0)[1] * matr[1][0]),
+						internal::mul_add(this->row(0)[0], matr[0][1], this->row(0)[1] * matr[1][1]),
+						internal::mul_add(this->row(0)[0], matr[0][2], internal::mul_add(this->row(0)[1], matr[1][2], this->row(0)[2]))
 					},
 				vector<T, 3>{
-						this->row(1)[0] * matr[0][0] + this->row(1)[1] * matr[1][0],
-						this->row(1)[0] * matr[0][1] + this->row(1)[1] * matr[1][1],
-						this->row(1)[0] * matr[0][2] + this->row(1)[1] * matr[1][2] + this->row(1)[2]
+						internal::mul_add(this->row(1)[0], matr[0][0], this->row(1)[1] * matr[1][0]),
+						internal::mul_add(this->row(1)[0], matr[0][1], this->row(1)[1] * matr[1][1]),
+						internal::mul_add(this->row(1)[0], matr[0][2], internal::mul_add(this->row(1)[1], matr[1][2], this->row(1)[2]))
 					},
 			};
 	}
@@ -264,11 +329,37 @@ public:
 	 * implicitly converted to square matrix before the opration by adding (0, 0, 1) row as a third row, and
 	 * after assignment, the third row is discarded again.
 	 * Multiply this matrix M by another matrix K from the right (M  = M * K).
+	 * Unless the matrix K is this matrix, the product is written to this matrix directly,
+	 * without intermediate temporary matrix.
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = matrix>
-	std::enable_if_t<R == C || (R == 2 && C == 3), E&> operator*=(const matrix& matr)noexcept{
-		return this->operator=(this->operator*(matr));
+	constexpr std::enable_if_t<R == C || (R == 2 && C == 3), E&> operator*=(const matrix& matr)noexcept{
+		if constexpr (internal::matrix_product<T, R, C>::enabled){
+			if(!internal::is_constant_evaluated()){
+				internal::matrix_product<T, R, C>::mul(this->row(0).data(), matr[0].data(), this->row(0).data());
+				return *this;
+			}
+		}
+
+		if(&matr == this){
+			return this->operator=(this->operator*(matr));
+		}
+
+		// each row of the product depends only on the same row of this matrix,
+		// so the rows are replaced one by one
+		for(auto& row : *this){
+			vector<T, C> p = matr[0] * row[0];
+			for(size_t i = 1; i != R; ++i){
+				p.mul_add(matr[i], row[i]);
+			}
+			if constexpr (R == 2 && C == 3){
+				// implicit third row of 2x3 matrix is (0, 0, 1)
+				p[2] += row[2];
+			}
+			row = p;
+		}
+		return *this;
 	}
 
 	/**
@@ -276,7 +367,7 @@ public:
 	 * @param n - scalar to multiply the matrix by.
 	 * @return reference to this matrix.
 	 */
-	matrix& operator*=(T n){
+	constexpr matrix& operator*=(T n){
 		for(auto& r : *this){
 			r *= n;
 		}
@@ -288,7 +379,7 @@ public:
 	 * @param n - scalar to divide the matrix by.
 	 * @return reference to this matrix.
 	 */
-	matrix& operator/=(T n){
+	constexpr matrix& operator/=(T n){
 		for(auto& r : *this){
 			r /= n;
 		}
@@ -300,8 +391,8 @@ public:
 	 * @param num - scalar to divide the matrix by.
 	 * @return divided matrix.
 	 */
-	matrix operator/(T num)const noexcept{
-		matrix res;
+	constexpr matrix operator/(T num)const noexcept{
+		matrix res{};
 		for(unsigned r = 0; r != R; ++r){
 			res[r] = this->row(r) / num;
 		}
@@ -313,11 +404,20 @@ public:
 	 * Multiply this matrix M by another matrix K from the left (M  = K * M).
 	 * Defined only for square matrices and 2x3 matrices. For details about 2x3 matrices see
 	 * description of operator*(matrix).
+	 * For 4x4 matrices, in case SIMD is enabled, the product is written to this matrix directly,
+	 * without intermediate temporary matrix.
 	 * @param matr - matrix to multiply by.
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = matrix>
-	std::enable_if_t<R == C || (R == 2 && C == 3), E&> left_mul(const matrix& matr)noexcept{
+	constexpr std::enable_if_t<R == C || (R == 2 && C == 3), E&> left_mul(const matrix& matr)noexcept{
+		if constexpr (internal::matrix_product<T, R, C>::enabled){
+			if(!internal::is_constant_evaluated()){
+				internal::matrix_product<T, R, C>::mul(matr[0].data(), this->row(0).data(), this->row(0).data());
+				return *this;
+			}
+		}
+
 		return this->operator=(matr.operator*(*this));
 	}
 
@@ -325,7 +425,7 @@ public:
 	 * @brief Initialize this matrix with identity matrix.
 	 * Defined for both, square and non-square matrices.
 	 */
-	matrix& set_identity()noexcept{
+	constexpr matrix& set_identity()noexcept{
 		using std::min;
 		for(size_t r = 1; r != R; ++r){
 			for(size_t c = 0; c != min(r, C); ++c){
@@ -356,7 +456,7 @@ public:
 	 * @return reference to this matrix instance.
 	 */
 	template <typename E = T>
-	matrix& set_frustum(
+	constexpr matrix& set_frustum(
 			std::enable_if_t<R == C && R == 4, E> left,
 			T right,
 			T bottom,
@@ -412,7 +512,7 @@ public:
 	 * @return reference to this matrix instance.
 	 */
 	template <typename E = T>
-	matrix frustum(
+	constexpr matrix frustum(
 			std::enable_if_t<R == C && R == 4, E> left,
 			T right,
 			T bottom,
@@ -421,7 +521,7 @@ public:
 			T far_val
 		)noexcept
 	{
-		matrix f;
+		matrix f{};
 		f.set_frustum(left, right, bottom, top, near_val, far_val);
 		return this->operator*=(f);
 	}
@@ -434,7 +534,7 @@ public:
 	 * @return reference to this matrix instance.
 	 */
 	template <typename E = matrix>
-	std::enable_if_t<
+	constexpr std::enable_if_t<
 			(R == C && (1 <= R && R <= 4)) || (R == 2 && C == 3),
 			matrix&
 		>scale(T s)noexcept
@@ -457,7 +557,7 @@ public:
 	 * @param y - scaling factor in y direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix& scale(T x, T y)noexcept{
+	constexpr matrix& scale(T x, T y)noexcept{
 		for(size_t r = 0; r != R; ++r){
 			this->row(r)[0] *= x;
 		}
@@ -477,7 +577,7 @@ public:
 	 * @param z - scaling factor in z direction.
 	 * @return reference to this matrix instance.
 	 */
-	matrix& scale(T x, T y, T z)noexcept{
+	constexpr matrix& scale(T x, T y, T z)noexcept{
 		// update 0th and 1st columns
 		this->scale(x, y);
 
@@ -496,7 +596,7 @@ public:
 	 * @param s - vector of scaling factors.
 	 * @return reference to this matrix instance.
 	 */
-	template <size_t S> matrix& scale(const vector<T, S>& s)noexcept{
+	template <size_t S> constexpr matrix& scale(const vector<T, S>& s)noexcept{
 		using std::min;
 		for(size_t c = 0; c != min(S, C); ++c){
 			for(size_t r = 0; r != R; ++r){
@@ -516,7 +616,7 @@ public:
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = T>
-	matrix& translate(std::enable_if_t<(R == 2 && C == 3) || (R == C && (R == 3 || R == 4)), E> x, T y)noexcept{
+	constexpr matrix& translate(std::enable_if_t<(R == 2 && C == 3) || (R == C && (R == 3 || R == 4)), E> x, T y)noexcept{
 		// only last column of the matrix changes
 		for(size_t r = 0; r != R; ++r){
 			this->row(r)[C - 1] += this->row(r)[0] * x + this->row(r)[1] * y;
@@ -533,7 +633,7 @@ public:
 	 * @param z - z component of translation vector.
 	 * @return reference to this matrix object.
 	 */
-	template <typename E = T> matrix& translate(std::enable_if_t<R == C && R == 4, E> x, T y, T z)noexcept{
+	template <typename E = T> constexpr matrix& translate(std::enable_if_t<R == C && R == 4, E> x, T y, T z)noexcept{
 		// only last column of the matrix changes
 		for(size_t r = 0; r != R; ++r){
 			this->row(r)[C - 1] += this->row(r)[0] * x + this->row(r)[1] * y + this->row(r)[2] * z;
@@ -549,7 +649,7 @@ public:
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = T, size_t S>
-	matrix& translate(
+	constexpr matrix& translate(
 			const vector<std::enable_if_t<
 					((R == 2 && C == 3) || (R == C && (R == 3 || R == 4))) && (S == 2 || S == 3)
 				, E>, S>& t
@@ -574,7 +674,7 @@ public:
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = T>
-	matrix& rotate(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& q)noexcept{
+	constexpr matrix& rotate(const quaternion<std::enable_if_t<R == C && (R == 3 || R == 4), E>>& q)noexcept{
 		return this->operator*=(matrix<T, R, C>(q));
 	}
 
@@ -588,7 +688,7 @@ public:
 	 * @return reference to this matrix object.
 	 */
 	template <typename E = T>
-	matrix& rotate(std::enable_if_t<(R == 2 && C == 3) || (R == C && (R == 3 || R == 4)), E> a)noexcept{
+	constexpr matrix& rotate(std::enable_if_t<(R == 2 && C == 3) || (R == C && (R == 3 || R == 4)), E> a)noexcept{
 		if constexpr (R == C){
 			// square matrix
 			return this->rotate(vector<T, 3>(0, 0, a));
@@ -599,10 +699,8 @@ public:
 			//               | cos(a) -sin(a) 0 |
 			// this = this * | sin(a)  cos(a) 0 |
 
-			using std::cos;
-			using std::sin;
-			T sina = sin(a);
-			T cosa = cos(a);
+			T sina = internal::sin(a);
+			T cosa = internal::cos(a);
 
 			T m00 = this->row(0)[0] * cosa + this->row(0)[1] * sina;
 			T m10 = this->row(1)[0] * cosa + this->row(1)[1] * sina;
@@ -623,12 +721,14 @@ public:
 	/**
 	 * @brief Transpose this matrix.
 	 */
-	matrix& transpose()noexcept{
-		using std::swap;
+	constexpr matrix& transpose()noexcept{
 		using std::min;
 		for(size_t r = 1; r != min(R, C); ++r){
 			for(size_t c = 0; c != r; ++c){
-				swap(this->row(r)[c], this->row(c)[r]);
+				// std::swap() is not constexpr in C++17
+				T tmp = this->row(r)[c];
+				this->row(r)[c] = this->row(c)[r];
+				this->row(c)[r] = tmp;
 			}
 		}
 		// in case the matrix is not square, then zero out the "non-square" parts
@@ -653,8 +753,8 @@ public:
 	 * @brief Make transposed matrix.
 	 * @return a new matrix which is a transpose of this matrix.
 	 */
-	matrix tposed()const noexcept{
-		matrix ret;
+	constexpr matrix tposed()const noexcept{
+		matrix ret{};
 
 		using std::min;
 
@@ -696,8 +796,8 @@ public:
 	 * @return minor matrix.
 	 */
 	template <typename E = T>
-	matrix<std::enable_if_t<(R >= 2 && C >= 2), E>, R - 1, C - 1> remove(size_t row, size_t col)const noexcept{
-		matrix<T, R - 1, C - 1> ret;
+	constexpr matrix<std::enable_if_t<(R >= 2 && C >= 2), E>, R - 1, C - 1> remove(size_t row, size_t col)const noexcept{
+		matrix<T, R - 1, C - 1> ret{};
 
 		for(size_t dr = 0; dr != row; ++dr){
 			for(size_t dc = 0; dc != col; ++dc){
@@ -729,7 +829,7 @@ public:
 	 * @param col - index of the column to remove.
 	 */
 	template <typename E = T>
-	std::enable_if_t<R == C && (R >= 2), E> minor(size_t row, size_t col)const noexcept{
+	constexpr std::enable_if_t<R == C && (R >= 2), E> minor(size_t row, size_t col)const noexcept{
 		return this->remove(row, col).det();
 	}
 
@@ -739,11 +839,21 @@ public:
 	 * @return matrix determinant.
 	 */
 	template <typename E = T>
-	std::enable_if_t<R == C || (R == 2 && C == 3), E> det()const noexcept{
+	constexpr std::enable_if_t<R == C || (R == 2 && C == 3), E> det()const noexcept{
 		if constexpr (R == C){
 			if constexpr (R == 1){
 				return this->row(0)[0];
-			}else{
+			}else if constexpr (R == 3){
+				const matrix& m = *this;
+				return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+						- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+						+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+			}else if constexpr (R == 4){
+				// Laplace expansion by first two rows, sharing 2x2 sub-determinants
+				auto s = this->upper_sub_dets();
+				auto c = this->lower_sub_dets();
+				return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+			}else if constexpr (R != 2){
 				T ret = 0;
 				T sign = 1;
 				for(size_t i = 0; i != C; ++i, sign = -sign){
@@ -751,8 +861,9 @@ public:
 				}
 				return ret;
 			}
-		}else{
-			static_assert(R == 2 && (C == 2 || C == 3), "");
+		}
+		if constexpr (R == 2){
+			static_assert(C == 2 || C == 3, "");
 			// for 2x3 matrix:
 
 			//    |a b c|          |e f|          |d f|          |d e|
@@ -780,16 +891,78 @@ public:
 	 * @return right inverse matrix of this matrix.
 	 */
 	template <typename E = T>
-	matrix<std::enable_if_t<R == C || (R == 2 && C == 3), E>, R, C> inv()const noexcept{
+	constexpr matrix<std::enable_if_t<R == C || (R == 2 && C == 3), E>, R, C> inv()const noexcept{
+		const matrix& m = *this;
 		if constexpr (R == C){
 			if constexpr (R == 1){
 				return T(1) / this->row(0)[0];
+			}else if constexpr (R == 2){
+				matrix<T, R, C> ret(
+					vector<T, C>(m[1][1], -m[0][1]),
+					vector<T, C>(-m[1][0], m[0][0])
+				);
+				divide_adjugate(ret, this->det());
+				return ret;
+			}else if constexpr (R == 3){
+				// adjugate matrix, i.e. transposed matrix of cofactors
+				matrix<T, R, C> ret(
+					vector<T, 3>(
+						m[1][1] * m[2][2] - m[1][2] * m[2][1],
+						m[0][2] * m[2][1] - m[0][1] * m[2][2],
+						m[0][1] * m[1][2] - m[0][2] * m[1][1]
+					),
+					vector<T, 3>(
+						m[1][2] * m[2][0] - m[1][0] * m[2][2],
+						m[0][0] * m[2][2] - m[0][2] * m[2][0],
+						m[0][2] * m[1][0] - m[0][0] * m[1][2]
+					),
+					vector<T, 3>(
+						m[1][0] * m[2][1] - m[1][1] * m[2][0],
+						m[0][1] * m[2][0] - m[0][0] * m[2][1],
+						m[0][0] * m[1][1] - m[0][1] * m[1][0]
+					)
+				);
+				divide_adjugate(ret, m[0][0] * ret[0][0] + m[0][1] * ret[1][0] + m[0][2] * ret[2][0]);
+				return ret;
+			}else if constexpr (R == 4){
+				// cofactors are calculated from 2x2 sub-determinants of upper and lower halves of the matrix
+				auto s = this->upper_sub_dets();
+				auto c = this->lower_sub_dets();
+
+				matrix<T, R, C> ret(
+					vector<T, C>(
+						m[1][1] * c[5] - m[1][2] * c[4] + m[1][3] * c[3],
+						-m[0][1] * c[5] + m[0][2] * c[4] - m[0][3] * c[3],
+						m[3][1] * s[5] - m[3][2] * s[4] + m[3][3] * s[3],
+						-m[2][1] * s[5] + m[2][2] * s[4] - m[2][3] * s[3]
+					),
+					vector<T, C>(
+						-m[1][0] * c[5] + m[1][2] * c[2] - m[1][3] * c[1],
+						m[0][0] * c[5] - m[0][2] * c[2] + m[0][3] * c[1],
+						-m[3][0] * s[5] + m[3][2] * s[2] - m[3][3] * s[1],
+						m[2][0] * s[5] - m[2][2] * s[2] + m[2][3] * s[1]
+					),
+					vector<T, C>(
+						m[1][0] * c[4] - m[1][1] * c[2] + m[1][3] * c[0],
+						-m[0][0] * c[4] + m[0][1] * c[2] - m[0][3] * c[0],
+						m[3][0] * s[4] - m[3][1] * s[2] + m[3][3] * s[0],
+						-m[2][0] * s[4] + m[2][1] * s[2] - m[2][3] * s[0]
+					),
+					vector<T, C>(
+						-m[1][0] * c[3] + m[1][1] * c[1] - m[1][2] * c[0],
+						m[0][0] * c[3] - m[0][1] * c[1] + m[0][2] * c[0],
+						-m[3][0] * s[3] + m[3][1] * s[1] - m[3][2] * s[0],
+						m[2][0] * s[3] - m[2][1] * s[1] + m[2][2] * s[0]
+					)
+				);
+				divide_adjugate(ret, s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0]);
+				return ret;
 			}else{
 				T d = this->det();
 
 				// calculate matrix of minors
 				static_assert(R == C, "");
-				matrix<T, R, C> mm;
+				matrix<T, R, C> mm{};
 
 				for(size_t r = 0; r != R; ++r){
 					T sign = r % 2 == 0 ? T(1) : T(-1);
@@ -806,26 +979,82 @@ public:
 		}else{
 			static_assert(R == 2 && C == 3, "");
 
-			matrix<T, 3, 3> m{
-				this->row(0),
-				this->row(1),
-				{0, 0, 1}
-			};
+			// the matrix is an affine transformation, i.e. it is a 3x3 matrix with (0, 0, 1) last row,
+			// so invert the linear 2x2 part and then apply the inverted linear part to the negated translation
+			matrix<T, 2, 3> ret(
+				vector<T, 3>(m[1][1], -m[0][1], T(0)),
+				vector<T, 3>(-m[1][0], m[0][0], T(0))
+			);
+			divide_adjugate(ret, this->det());
+			ret[0][2] = -(ret[0][0] * m[0][2] + ret[0][1] * m[1][2]);
+			ret[1][2] = -(ret[1][0] * m[0][2] + ret[1][1] * m[1][2]);
+			return ret;
+		}
+	}
 
-			m.invert();
+	/**
+	 * @brief Calculate inverse of affine transformation matrix.
+	 * Defined only for 4x4 and 2x3 matrices.
+	 * The matrix is assumed to be an affine transformation matrix, i.e. for 4x4 matrix the last row is (0, 0, 0, 1)
+	 * and for 2x3 matrix the implicit last row is (0, 0, 1). The inverse of such matrix is calculated by inverting the
+	 * linear part (upper-left 3x3 or 2x2 sub-matrix) and transforming the negated translation by it,
+	 * which is much cheaper than the general matrix inversion.
+	 * In case the matrix is not affine, the result is undefined.
+	 * @return inverse matrix of this affine transformation matrix.
+	 */
+	template <typename E = T>
+	constexpr matrix<std::enable_if_t<(R == 4 && C == 4) || (R == 2 && C == 3), E>, R, C> inv_affine()const noexcept{
+		if constexpr (R == 2){
+			return this->inv();
+		}else{
+			const matrix& m = *this;
+
+			// adjugate of the upper-left 3x3 sub-matrix
+			matrix<T, 3, 3> l(
+				vector<T, 3>(
+					m[1][1] * m[2][2] - m[1][2] * m[2][1],
+					m[0][2] * m[2][1] - m[0][1] * m[2][2],
+					m[0][1] * m[1][2] - m[0][2] * m[1][1]
+				),
+				vector<T, 3>(
+					m[1][2] * m[2][0] - m[1][0] * m[2][2],
+					m[0][0] * m[2][2] - m[0][2] * m[2][0],
+					m[0][2] * m[1][0] - m[0][0] * m[1][2]
+				),
+				vector<T, 3>(
+					m[1][0] * m[2][1] - m[1][1] * m[2][0],
+					m[0][1] * m[2][0] - m[0][0] * m[2][1],
+					m[0][0] * m[1][1] - m[0][1] * m[1][0]
+				)
+			);
+			matrix<T, 3, 3>::divide_adjugate(l, m[0][0] * l[0][0] + m[0][1] * l[1][0] + m[0][2] * l[2][0]);
 
-			return {
-				m[0],
-				m[1]
-			};
+			vector<T, 3> t(m[0][3], m[1][3], m[2][3]);
+
+			return matrix(
+				vector<T, 4>(l[0], -(l[0] * t)),
+				vector<T, 4>(l[1], -(l[1] * t)),
+				vector<T, 4>(l[2], -(l[2] * t)),
+				vector<T, 4>(T(0), T(0), T(0), T(1))
+			);
 		}
 	}
 
+	/**
+	 * @brief Invert this affine transformation matrix.
+	 * See inv_affine() for details.
+	 * @return reference to this matrix.
+	 */
+	template <typename E = matrix>
+	constexpr std::enable_if_t<(R == 4 && C == 4) || (R == 2 && C == 3), E&> invert_affine()noexcept{
+		return this->operator=(this->inv_affine());
+	}
+
 	/**
 	 * @brief Invert this matrix.
 	 * @return reference to this matrix.
 	 */
-	matrix& invert()noexcept{
+	constexpr matrix& invert()noexcept{
 		this->operator=(this->inv());
 		return *this;
 	}
@@ -847,13 +1076,55 @@ public:
 	 * @brief Set each element of this matrix to a given number.
 	 * @param num - number to set each matrix element to.
 	 */
-	matrix& set(T num)noexcept{
+	constexpr matrix& set(T num)noexcept{
 		for(auto& e : *this){
 			e.set(num);
 		}
 		return *this;
 	}
 
+private:
+	template <class, size_t, size_t> friend class matrix;
+
+	// Divide adjugate matrix by the determinant to get the inverse matrix.
+	// For floating point types multiply by reciprocal of the determinant instead of dividing every element.
+	static constexpr void divide_adjugate(matrix& adj, T d)noexcept{
+		if constexpr (std::is_floating_point_v<T>){
+			adj *= T(1) / d;
+		}else{
+			adj /= d;
+		}
+	}
+
+	// 2x2 sub-determinants of the first two rows of 4x4 matrix
+	template <typename E = T>
+	constexpr std::array<std::enable_if_t<R == 4 && C == 4, E>, 6> upper_sub_dets()const noexcept{
+		const matrix& m = *this;
+		return {{
+			m[0][0] * m[1][1] - m[1][0] * m[0][1],
+			m[0][0] * m[1][2] - m[1][0] * m[0][2],
+			m[0][0] * m[1][3] - m[1][0] * m[0][3],
+			m[0][1] * m[1][2] - m[1][1] * m[0][2],
+			m[0][1] * m[1][3] - m[1][1] * m[0][3],
+			m[0][2] * m[1][3] - m[1][2] * m[0][3]
+		}};
+	}
+
+	// 2x2 sub-determinants of the last two rows of 4x4 matrix
+	template <typename E = T>
+	constexpr std::array<std::enable_if_t<R == 4 && C == 4, E>, 6> lower_sub_dets()const noexcept{
+		const matrix& m = *this;
+		return {{
+			m[2][0] * m[3][1] - m[3][0] * m[2][1],
+			m[2][0] * m[3][2] - m[3][0] * m[2][2],
+			m[2][0] * m[3][3] - m[3][0] * m[2][3],
+			m[2][1] * m[3][2] - m[3][1] * m[2][2],
+			m[2][1] * m[3][3] - m[3][1] * m[2][3],
+			m[2][2] * m[3][3] - m[3][2] * m[2][3]
+		}};
+	}
+
+public:
 	friend std::ostream& operator<<(std::ostream& s, const matrix& mat){
 		for(auto& r : mat){
 			s << "|" << r << std::endl;
@@ -866,4 +1137,184 @@ template <class T> using matrix2 = matrix<T, 2, 3>;
 template <class T> using matrix3 = matrix<T, 3, 3>;
 template <class T> using matrix4 = matrix<T, 4, 4>;
 
+namespace internal{
+
+// Holds columns of 4x4 matrix in SIMD registers, the matrix is read only once for the whole batch.
+template <class T> struct matrix4_columns{
+	typedef simd::kernel<T, 4> simd_kernel;
+	typedef typename simd_kernel::reg reg;
+
+	reg c[4];
+
+	matrix4_columns(const matrix4<T>& m)noexcept{
+		for(size_t i = 0; i != 4; ++i){
+			std::array<T, 4> col = {{m[0][i], m[1][i], m[2][i], m[3][i]}};
+			this->c[i] = simd_kernel::load(col.data());
+		}
+	}
+
+	// returns M * (x, y, z, 1)
+	reg transform(T x, T y, T z)const noexcept{
+		return simd_kernel::add(
+				simd_kernel::fma(this->c[0], simd_kernel::set(x), simd_kernel::mul(this->c[1], simd_kernel::set(y))),
+				simd_kernel::fma(this->c[2], simd_kernel::set(z), this->c[3])
+			);
+	}
+
+	// returns M * (x, y, z, w)
+	reg transform(T x, T y, T z, T w)const noexcept{
+		return simd_kernel::add(
+				simd_kernel::fma(this->c[0], simd_kernel::set(x), simd_kernel::mul(this->c[1], simd_kernel::set(y))),
+				simd_kernel::fma(this->c[2], simd_kernel::set(z), simd_kernel::mul(this->c[3], simd_kernel::set(w)))
+			);
+	}
+};
+
+}
+
+/**
+ * @brief Transform points by matrix.
+ * Each point P of the input span is transformed as M * (P, 1), the resulting w component is discarded.
+ * The matrix is loaded only once for the whole batch.
+ * Input and output spans can be the same span, i.e. in-place transformation is allowed.
+ * @param m - transformation matrix.
+ * @param in - points to transform.
+ * @param out - span to store the transformed points to. Must be of the same size as the input span.
+ */
+template <class T>
+void transform(const matrix4<T>& m, utki::span<const vector<std::common_type_t<T>, 3>> in, utki::span<vector<std::common_type_t<T>, 3>> out)noexcept{
+	ASSERT(in.size() == out.size())
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		internal::matrix4_columns<T> mc(m);
+		std::array<T, 4> r;
+		auto o = out.begin();
+		for(const auto& p : in){
+			simd::kernel<T, 4>::store(r.data(), mc.transform(p.x(), p.y(), p.z()));
+			o->x() = r[0];
+			o->y() = r[1];
+			o->z() = r[2];
+			++o;
+		}
+	}else{
+		auto o = out.begin();
+		for(const auto& p : in){
+			T x = p.x();
+			T y = p.y();
+			T z = p.z();
+			o->x() = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+			o->y() = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+			o->z() = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+			++o;
+		}
+	}
+}
+
+/**
+ * @brief Transform vectors by matrix.
+ * Each vector V of the input span is transformed as M * V.
+ * The matrix is loaded only once for the whole batch.
+ * Input and output spans can be the same span, i.e. in-place transformation is allowed.
+ * @param m - transformation matrix.
+ * @param in - vectors to transform.
+ * @param out - span to store the transformed vectors to. Must be of the same size as the input span.
+ */
+template <class T>
+void transform(const matrix4<T>& m, utki::span<const vector<std::common_type_t<T>, 4>> in, utki::span<vector<std::common_type_t<T>, 4>> out)noexcept{
+	ASSERT(in.size() == out.size())
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		internal::matrix4_columns<T> mc(m);
+		auto o = out.begin();
+		for(const auto& v : in){
+			simd::kernel<T, 4>::store(o->data(), mc.transform(v.x(), v.y(), v.z(), v.w()));
+			++o;
+		}
+	}else{
+		auto o = out.begin();
+		for(const auto& v : in){
+			T x = v.x();
+			T y = v.y();
+			T z = v.z();
+			T w = v.w();
+			o->x() = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3] * w;
+			o->y() = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3] * w;
+			o->z() = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3] * w;
+			o->w() = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3] * w;
+			++o;
+		}
+	}
+}
+
+/**
+ * @brief Transform points by matrix with perspective divide.
+ * Each point P of the input span is transformed as M * (P, 1),
+ * after that x, y and z components of the result are divided by its w component.
+ * The matrix is loaded only once for the whole batch.
+ * Input and output spans can be the same span, i.e. in-place transformation is allowed.
+ * @param m - projection matrix.
+ * @param in - points to project.
+ * @param out - span to store the projected points to. Must be of the same size as the input span.
+ */
+template <class T>
+void project(const matrix4<T>& m, utki::span<const vector<std::common_type_t<T>, 3>> in, utki::span<vector<std::common_type_t<T>, 3>> out)noexcept{
+	ASSERT(in.size() == out.size())
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		typedef simd::kernel<T, 4> simd_kernel;
+		internal::matrix4_columns<T> mc(m);
+		std::array<T, 4> r;
+		auto o = out.begin();
+		for(const auto& p : in){
+			auto h = mc.transform(p.x(), p.y(), p.z());
+			simd_kernel::store(r.data(), h);
+			simd_kernel::store(r.data(), simd_kernel::div(h, simd_kernel::set(r[3])));
+			o->x() = r[0];
+			o->y() = r[1];
+			o->z() = r[2];
+			++o;
+		}
+	}else{
+		auto o = out.begin();
+		for(const auto& p : in){
+			T x = p.x();
+			T y = p.y();
+			T z = p.z();
+			T w = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+			o->x() = (m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3]) / w;
+			o->y() = (m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3]) / w;
+			o->z() = (m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3]) / w;
+			++o;
+		}
+	}
+}
+
+/**
+ * @brief Transform points by 2x3 matrix.
+ * Each point P of the input span is transformed as M * (P, 1).
+ * The matrix is loaded only once for the whole batch.
+ * Input and output spans can be the same span, i.e. in-place transformation is allowed.
+ * @param m - transformation matrix.
+ * @param in - points to transform.
+ * @param out - span to store the transformed points to. Must be of the same size as the input span.
+ */
+template <class T>
+void transform(const matrix2<T>& m, utki::span<const vector<std::common_type_t<T>, 2>> in, utki::span<vector<std::common_type_t<T>, 2>> out)noexcept{
+	ASSERT(in.size() == out.size())
+
+	// keep matrix elements in local variables so that the compiler does not reload them
+	// after each store to the output span which might alias the matrix
+	T m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+	T m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+
+	auto o = out.begin();
+	for(const auto& p : in){
+		T x = p.x();
+		T y = p.y();
+		o->x() = m00 * x + m01 * y + m02;
+		o->y() = m10 * x + m11 * y + m12;
+		++o;
+	}
+}
+
 }
@@ -0,0 +1,414 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <exception>
+#include <algorithm>
+
+#include <utki/span.hpp>
+
+#include "matrix.hpp"
+#include "segment2.hpp"
+#include "rectangle.hpp"
+
+// Functions of this header run work on std::thread's, so the program has to be linked with the threads library,
+// e.g. -pthread on Linux.
+
+namespace r4{
+
+/**
+ * @brief Default size of data processed as one piece of parallel work, in bytes.
+ * The chunk and the data produced from it are supposed to fit into L2 cache of a core,
+ * while being big enough to make the scheduling overhead negligible.
+ */
+constexpr size_t parallel_chunk_bytes = 64 * 1024;
+
+/**
+ * @brief Minimal size of data to process in parallel, in bytes.
+ * Starting threads takes tens of microseconds, so the span processing functions
+ * process smaller spans on the calling thread only.
+ */
+constexpr size_t parallel_threshold_bytes = 256 * 1024;
+
+/**
+ * @brief Default number of elements processed as one piece of parallel work.
+ * @tparam T - type of the element.
+ * @return number of elements of type T which fit into parallel_chunk_bytes.
+ */
+template <class T> constexpr size_t parallel_grain()noexcept{
+	return std::max(size_t(1), parallel_chunk_bytes / sizeof(T));
+}
+
+namespace internal{
+
+// Range of chunk indices [begin, end) owned by a worker thread.
+// The owner takes chunks from the front, other workers steal halves of the range from the back.
+// Both ends are packed into one atomic word, so that taking and stealing are single CAS operations.
+struct alignas(64) work_range{
+	std::atomic<uint64_t> range{0};
+
+	static constexpr uint64_t pack(uint64_t begin, uint64_t end)noexcept{
+		return begin | (end << 32);
+	}
+
+	static constexpr uint64_t begin(uint64_t r)noexcept{
+		return r & 0xffffffff;
+	}
+
+	static constexpr uint64_t end(uint64_t r)noexcept{
+		return r >> 32;
+	}
+
+	// returns false if the range is empty
+	bool pop_front(size_t& chunk)noexcept{
+		uint64_t r = this->range.load(std::memory_order_relaxed);
+		for(;;){
+			if(begin(r) >= end(r)){
+				return false;
+			}
+			if(this->range.compare_exchange_weak(r, pack(begin(r) + 1, end(r)), std::memory_order_acq_rel)){
+				chunk = size_t(begin(r));
+				return true;
+			}
+		}
+	}
+
+	// returns empty range if there is nothing to steal
+	uint64_t steal_back()noexcept{
+		uint64_t r = this->range.load(std::memory_order_relaxed);
+		for(;;){
+			if(begin(r) >= end(r)){
+				return 0;
+			}
+			uint64_t mid = begin(r) + (end(r) - begin(r)) / 2;
+			if(this->range.compare_exchange_weak(r, pack(begin(r), mid), std::memory_order_acq_rel)){
+				return pack(mid, end(r));
+			}
+		}
+	}
+};
+
+// Number of threads to process span of given size with.
+inline size_t span_num_threads(size_t size_bytes, size_t num_threads)noexcept{
+	return size_bytes < parallel_threshold_bytes ? 1 : num_threads;
+}
+
+inline size_t parallel_num_threads(size_t num_threads, size_t num_chunks)noexcept{
+	if(num_threads == 0){
+		num_threads = std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+	}
+	return std::min(num_threads, num_chunks);
+}
+
+// Calls func(chunk) for each chunk index from [0, num_chunks) on num_threads threads, including the calling one.
+// Each worker starts with an equal share of the chunks and steals from others when it runs out of own chunks.
+// The first exception thrown by func is rethrown after all threads finish.
+template <class F> void run_chunks(size_t num_chunks, size_t num_threads, const F& func){
+	ASSERT(num_chunks <= 0xffffffff)
+
+	if(num_threads <= 1){
+		for(size_t i = 0; i != num_chunks; ++i){
+			func(i);
+		}
+		return;
+	}
+
+	std::vector<work_range> ranges(num_threads);
+	for(size_t i = 0; i != num_threads; ++i){
+		ranges[i].range.store(work_range::pack(num_chunks * i / num_threads, num_chunks * (i + 1) / num_threads), std::memory_order_relaxed);
+	}
+
+	std::atomic<bool> failed{false};
+	std::exception_ptr error;
+
+	auto worker = [&](size_t self){
+		auto& own = ranges[self];
+		for(;;){
+			size_t chunk;
+			while(own.pop_front(chunk)){
+				if(failed.load(std::memory_order_relaxed)){
+					return;
+				}
+				try{
+					func(chunk);
+				}catch(...){
+					if(!failed.exchange(true)){
+						error = std::current_exception();
+					}
+					return;
+				}
+			}
+
+			// own range is exhausted, steal from other workers, nobody steals from the empty range
+			uint64_t stolen = 0;
+			for(size_t i = 1; i != num_threads && stolen == 0; ++i){
+				stolen = ranges[(self + i) % num_threads].steal_back();
+			}
+			if(stolen == 0){
+				// chunks are never added, so there is no more work
+				return;
+			}
+			own.range.store(stolen, std::memory_order_release);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads - 1);
+	for(size_t i = 1; i != num_threads; ++i){
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for(auto& t : threads){
+		t.join();
+	}
+
+	if(error){
+		std::rethrow_exception(error);
+	}
+}
+
+}
+
+/**
+ * @brief Run function over index range in parallel.
+ * The range [0, size) is split into chunks of grain indices, which are processed by a number of threads.
+ * The threads balance the load by stealing chunks from each other, so chunks which take different time
+ * to process are fine.
+ * The calling thread also processes chunks, and the function returns when all chunks are processed.
+ * Threads are started on each call, so the function is intended for big amounts of work, for small amounts
+ * of work, i.e. one chunk, no threads are started at all.
+ * In case the function throws, the remaining chunks are not processed and the exception is rethrown to the caller.
+ * @param size - size of the index range.
+ * @param grain - number of indices in one chunk, must be greater than zero.
+ * @param func - function to call for each chunk, func(begin, end), where [begin, end) is the chunk's index range.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ */
+template <class F> void parallel_for(size_t size, size_t grain, const F& func, size_t num_threads = 0){
+	ASSERT(grain != 0)
+	size_t num_chunks = (size + grain - 1) / grain;
+	internal::run_chunks(
+			num_chunks,
+			internal::parallel_num_threads(num_threads, num_chunks),
+			[&](size_t chunk){
+				size_t begin = chunk * grain;
+				func(begin, std::min(begin + grain, size));
+			}
+		);
+}
+
+/**
+ * @brief Reduce index range in parallel.
+ * The range [0, size) is split into chunks in the same way as by parallel_for().
+ * Each chunk is reduced to a value by the map function and then chunk values are combined by
+ * the reduce function in order of chunks. So, the result does not depend on the number of threads,
+ * even for operations which are not associative, like floating point addition.
+ * @param size - size of the index range.
+ * @param grain - number of indices in one chunk, must be greater than zero.
+ * @param identity - value to combine with chunk values first, also the result for empty range.
+ * @param map - function calculating value of a chunk, map(begin, end) -> T.
+ * @param reduce - function combining two values, reduce(T, T) -> T.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ * @return result of the reduction.
+ */
+template <class T, class M, class R> T parallel_reduce(size_t size, size_t grain, T identity, const M& map, const R& reduce, size_t num_threads = 0){
+	ASSERT(grain != 0)
+	size_t num_chunks = (size + grain - 1) / grain;
+	std::vector<T> values(num_chunks, identity);
+	internal::run_chunks(
+			num_chunks,
+			internal::parallel_num_threads(num_threads, num_chunks),
+			[&](size_t chunk){
+				size_t begin = chunk * grain;
+				values[chunk] = map(begin, std::min(begin + grain, size));
+			}
+		);
+	for(const auto& v : values){
+		identity = reduce(identity, v);
+	}
+	return identity;
+}
+
+/**
+ * @brief Transform points by matrix in parallel.
+ * Same as transform(m, in, out), but the work is split between threads, for spans bigger than parallel_threshold_bytes.
+ * @param m - transformation matrix.
+ * @param in - points to transform.
+ * @param out - span to store the transformed points to. Must be of the same size as the input span.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ */
+template <class T>
+void parallel_transform(
+		const matrix4<T>& m,
+		utki::span<const vector<std::common_type_t<T>, 3>> in,
+		utki::span<vector<std::common_type_t<T>, 3>> out,
+		size_t num_threads = 0
+	)
+{
+	ASSERT(in.size() == out.size())
+	parallel_for(
+			in.size(),
+			parallel_grain<vector<T, 3>>(),
+			[&](size_t begin, size_t end){
+				transform(m, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+			},
+			internal::span_num_threads(in.size() * sizeof(in[0]), num_threads)
+		);
+}
+
+/**
+ * @brief Transform vectors by matrix in parallel.
+ * Same as transform(m, in, out), but the work is split between threads, for spans bigger than parallel_threshold_bytes.
+ * @param m - transformation matrix.
+ * @param in - vectors to transform.
+ * @param out - span to store the transformed vectors to. Must be of the same size as the input span.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ */
+template <class T>
+void parallel_transform(
+		const matrix4<T>& m,
+		utki::span<const vector<std::common_type_t<T>, 4>> in,
+		utki::span<vector<std::common_type_t<T>, 4>> out,
+		size_t num_threads = 0
+	)
+{
+	ASSERT(in.size() == out.size())
+	parallel_for(
+			in.size(),
+			parallel_grain<vector<T, 4>>(),
+			[&](size_t begin, size_t end){
+				transform(m, in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+			},
+			internal::span_num_threads(in.size() * sizeof(in[0]), num_threads)
+		);
+}
+
+/**
+ * @brief Rotate vectors in parallel.
+ * Same as rotate(vecs, q), but the work is split between threads, for spans bigger than parallel_threshold_bytes.
+ * @param vecs - vectors to rotate.
+ * @param q - unit quaternion which defines the rotation.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ */
+template <class T, size_t S>
+std::enable_if_t<S == 3 || S == 4> parallel_rotate(utki::span<vector<T, S>> vecs, const quaternion<T>& q, size_t num_threads = 0){
+	parallel_for(
+			vecs.size(),
+			parallel_grain<vector<T, S>>(),
+			[&](size_t begin, size_t end){
+				rotate(vecs.subspan(begin, end - begin), q);
+			},
+			internal::span_num_threads(vecs.size() * sizeof(vector<T, S>), num_threads)
+		);
+}
+
+/**
+ * @brief Calculate bounding box of points in parallel.
+ * The work is split between threads for spans bigger than parallel_threshold_bytes.
+ * @tparam V - vector type.
+ * @param points - points to calculate bounding box of, must not be empty.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ * @return pair of minimum and maximum corners of the bounding box.
+ */
+template <class V>
+std::pair<std::remove_const_t<V>, std::remove_const_t<V>> parallel_min_max(utki::span<V> points, size_t num_threads = 0){
+	ASSERT(!points.empty())
+	typedef std::remove_const_t<V> vector_type;
+	typedef std::pair<vector_type, vector_type> bounds_type;
+	return parallel_reduce(
+			points.size(),
+			parallel_grain<vector_type>(),
+			bounds_type(points[0], points[0]),
+			[&](size_t begin, size_t end){
+				bounds_type b(points[begin], points[begin]);
+				for(size_t i = begin + 1; i != end; ++i){
+					b.first = min(b.first, points[i]);
+					b.second = max(b.second, points[i]);
+				}
+				return b;
+			},
+			[](const bounds_type& a, const bounds_type& b){
+				return bounds_type(min(a.first, b.first), max(a.second, b.second));
+			},
+			internal::span_num_threads(points.size() * sizeof(V), num_threads)
+		);
+}
+
+
+/**
+ * @brief Calculate bounding box of 2d points in parallel.
+ * Same as segment2::from_points(), but the work is split between threads,
+ * for spans bigger than parallel_threshold_bytes.
+ * @tparam V - 2d vector type.
+ * @param points - points to calculate the bounding box of.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ * @return bounding box of the points, p1 is the minimum corner and p2 is the maximum corner.
+ * @return empty bounding box, as set by segment2::set_empty_bounding_box(), if the span is empty.
+ */
+template <class V>
+segment2<typename V::value_type> parallel_bounding_box(utki::span<V> points, size_t num_threads = 0){
+	typedef segment2<typename V::value_type> segment_type;
+	segment_type empty;
+	empty.set_empty_bounding_box();
+	return parallel_reduce(
+			points.size(),
+			parallel_grain<V>(),
+			empty,
+			[&](size_t begin, size_t end){
+				return segment_type::from_points(points.subspan(begin, end - begin));
+			},
+			[](segment_type a, const segment_type& b){
+				return a.unite(b);
+			},
+			internal::span_num_threads(points.size() * sizeof(V), num_threads)
+		);
+}
+
+/**
+ * @brief Calculate bounding rectangle of 2d points in parallel.
+ * Same as rectangle::from_points(), but the work is split between threads,
+ * for spans bigger than parallel_threshold_bytes.
+ * @tparam V - 2d vector type.
+ * @param points - points to calculate the bounding rectangle of.
+ * @param num_threads - number of threads to use, 0 means number of hardware threads.
+ * @return bounding rectangle of the points.
+ * @return zero rectangle at (0, 0) if the span is empty.
+ */
+template <class V>
+rectangle<typename V::value_type> parallel_bounding_rectangle(utki::span<V> points, size_t num_threads = 0){
+	if(points.empty()){
+		return rectangle<typename V::value_type>(0, 0, 0, 0);
+	}
+	auto bb = parallel_bounding_box(points, num_threads);
+	return rectangle<typename V::value_type>(bb.p1, bb.p2 - bb.p1);
+}
+
+}
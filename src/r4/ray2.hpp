@@ -0,0 +1,402 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <limits>
+#include <bitset>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "segment2.hpp"
+#include "rectangle.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+namespace internal{
+
+// SIMD version of the ray vs rectangle slab test, rect holds x, y, width and height of 4 rectangles.
+// Returns bitmask of the rectangles missed by the rays.
+template <class K>
+unsigned slab_miss_mask(
+		typename K::reg ox,
+		typename K::reg oy,
+		typename K::reg ix,
+		typename K::reg iy,
+		const typename K::reg* rect,
+		typename K::reg zero,
+		typename K::reg t_max
+	)noexcept
+{
+	auto tx1 = K::mul(K::sub(rect[0], ox), ix);
+	auto tx2 = K::mul(K::sub(K::add(rect[0], rect[2]), ox), ix);
+	auto ty1 = K::mul(K::sub(rect[1], oy), iy);
+	auto ty2 = K::mul(K::sub(K::add(rect[1], rect[3]), oy), iy);
+
+	auto entry = K::max(K::max(K::min(tx1, tx2), K::min(ty1, ty2)), zero);
+	auto exit = K::min(K::min(K::max(tx1, tx2), K::max(ty1, ty2)), t_max);
+	return K::lt_mask(exit, entry);
+}
+
+inline size_t count_bits(utki::span<const uint32_t> mask, size_t num_objects)noexcept{
+	size_t ret = 0;
+	for(size_t i = 0; i != (num_objects + 31) / 32; ++i){
+		ret += std::bitset<32>(mask[i]).count();
+	}
+	return ret;
+}
+
+}
+
+/**
+ * @brief 2d ray.
+ * The ray is parametrized as origin + direction * t, where t >= 0. The direction does not need to be normalized,
+ * so a segment can be represented by the ray from its first point with direction to its second point
+ * and t limited to [0 : 1].
+ * Intersection tests against rectangles use the slab method. Rectangles are treated as closed,
+ * i.e. a ray touching the rectangle's edge or corner does intersect it.
+ * @tparam T - type of the components.
+ */
+template <class T> class ray2{
+	static_assert(std::is_floating_point_v<T>, "ray2 is only defined for floating point types");
+
+	typedef simd::kernel<T, 4> simd_kernel;
+
+	// rectangles and rays are loaded to SIMD registers as 4 consecutive components
+	static_assert(sizeof(rectangle<T>) == 4 * sizeof(T), "unexpected rectangle layout");
+
+public:
+	/**
+	 * @brief Origin point of the ray.
+	 */
+	vector2<T> origin;
+
+	/**
+	 * @brief Direction of the ray.
+	 */
+	vector2<T> direction;
+
+	constexpr ray2() = default;
+
+	/**
+	 * @brief Construct ray.
+	 * @param origin - origin point.
+	 * @param direction - direction.
+	 */
+	constexpr ray2(const vector2<T>& origin, const vector2<T>& direction)noexcept :
+			origin(origin),
+			direction(direction)
+	{}
+
+	/**
+	 * @brief Construct ray from segment.
+	 * The ray starts at p1 of the segment and the point at t = 1 is p2 of the segment.
+	 * @param s - segment.
+	 */
+	constexpr explicit ray2(const segment2<T>& s)noexcept :
+			origin(s.p1),
+			direction(s.p2 - s.p1)
+	{}
+
+	/**
+	 * @brief Get point of the ray.
+	 * @param t - parameter of the point.
+	 * @return origin + direction * t.
+	 */
+	constexpr vector2<T> point_at(T t)const noexcept{
+		return this->origin + this->direction * t;
+	}
+
+	/**
+	 * @brief Calculate size of hit bitmask.
+	 * @param num_objects - number of objects to test.
+	 * @return number of bitmask words needed to hold hit bits of the given number of objects.
+	 */
+	static constexpr size_t mask_size(size_t num_objects)noexcept{
+		return (num_objects + 31) / 32;
+	}
+
+	/**
+	 * @brief Intersect ray with rectangle.
+	 * @param rect - rectangle to intersect with.
+	 * @param t_max - maximum parameter of the ray points to consider.
+	 * @return parameter of the first point of the ray which is within the rectangle, 0 if the origin is within the rectangle.
+	 * @return infinity in case the ray does not intersect the rectangle within [0 : t_max] range of parameter.
+	 */
+	T intersect(const rectangle<T>& rect, T t_max = std::numeric_limits<T>::infinity())const noexcept{
+		auto t = this->slab(inv(this->direction), rect, t_max);
+		return t.first <= t.second ? t.first : std::numeric_limits<T>::infinity();
+	}
+
+	/**
+	 * @brief Test if ray intersects rectangle.
+	 * @param rect - rectangle to test for intersection with.
+	 * @param t_max - maximum parameter of the ray points to consider.
+	 * @return true if the ray intersects the rectangle within [0 : t_max] range of parameter.
+	 * @return false otherwise.
+	 */
+	bool intersects(const rectangle<T>& rect, T t_max = std::numeric_limits<T>::infinity())const noexcept{
+		auto t = this->slab(inv(this->direction), rect, t_max);
+		return t.first <= t.second;
+	}
+
+	/**
+	 * @brief Test ray against many rectangles.
+	 * Rectangles are processed by groups of 4 with SIMD instructions, when available,
+	 * unless the ray is parallel to one of the axes.
+	 * @param rects - rectangles to test for intersection with.
+	 * @param hits - output hit bitmask, must be of at least mask_size(rects.size()) words.
+	 * @param t_max - maximum parameter of the ray points to consider.
+	 * @return number of intersected rectangles.
+	 */
+	size_t intersects(
+			utki::span<const rectangle<T>> rects,
+			utki::span<uint32_t> hits,
+			T t_max = std::numeric_limits<T>::infinity()
+		)const noexcept
+	{
+		ASSERT(hits.size() >= mask_size(rects.size()))
+		std::fill(hits.begin(), std::next(hits.begin(), mask_size(rects.size())), 0);
+
+		auto inv_dir = inv(this->direction);
+
+		size_t i = 0;
+		if constexpr (simd_kernel::enabled){
+			// for the ray parallel to one of the axes the slab of the axis is handled separately,
+			// so such rays are tested by the scalar loop
+			if(!is_parallel(this->direction.x()) && !is_parallel(this->direction.y())){
+				typedef typename simd_kernel::reg reg;
+
+				const reg ox = simd_kernel::set(this->origin.x());
+				const reg oy = simd_kernel::set(this->origin.y());
+				const reg ix = simd_kernel::set(inv_dir.x());
+				const reg iy = simd_kernel::set(inv_dir.y());
+				const reg zero = simd_kernel::set(T(0));
+				const reg tm = simd_kernel::set(t_max);
+
+				for(; i + 4 <= rects.size(); i += 4){
+					// transpose to have x, y, width and height of all 4 rectangles in separate registers
+					reg r[4];
+					for(size_t j = 0; j != 4; ++j){
+						r[j] = simd_kernel::load(rects[i + j].p.data());
+					}
+					simd_kernel::transpose(r[0], r[1], r[2], r[3]);
+
+					unsigned missed = internal::slab_miss_mask<simd_kernel>(ox, oy, ix, iy, r, zero, tm);
+					hits[i / 32] |= uint32_t(~missed & 0xf) << (i % 32);
+				}
+			}
+		}
+
+		for(auto r = std::next(rects.begin(), i); r != rects.end(); ++r, ++i){
+			auto t = this->slab(inv_dir, *r, t_max);
+			if(t.first <= t.second){
+				hits[i / 32] |= uint32_t(1) << (i % 32);
+			}
+		}
+
+		return internal::count_bits(hits, rects.size());
+	}
+
+	/**
+	 * @brief Check if direction component is treated as zero.
+	 * Components which are smaller than the smallest normal number by absolute value are treated as zero,
+	 * because their inverse overflows.
+	 * @param d - direction component.
+	 * @return true if the ray is treated as parallel to the axis of the other component.
+	 */
+	static bool is_parallel(T d)noexcept{
+		using std::abs;
+		return abs(d) < std::numeric_limits<T>::min();
+	}
+
+private:
+	// inverse of direction components, the inverse of zero component is not used, see slab()
+	static vector2<T> inv(const vector2<T>& d)noexcept{
+		return {
+				is_parallel(d.x()) ? T(0) : T(1) / d.x(),
+				is_parallel(d.y()) ? T(0) : T(1) / d.y()
+			};
+	}
+
+	// Parameters of the ray points where the ray enters and exits the rectangle,
+	// the ray misses the rectangle if the entry is greater than the exit.
+	// For direction component which is zero the slab of its axis either contains the whole ray or nothing,
+	// it cannot be calculated as for other directions, because ray lying on the slab boundary gives 0 * infinity.
+	std::pair<T, T> slab(const vector2<T>& inv_dir, const rectangle<T>& rect, T t_max)const noexcept{
+		using std::min;
+		using std::max;
+
+		auto x2_y2 = rect.x2_y2();
+
+		T entry = 0;
+		T exit = t_max;
+		for(size_t a = 0; a != 2; ++a){
+			T o = this->origin[a];
+			if(is_parallel(this->direction[a])){
+				if(o < rect.p[a] || o > x2_y2[a]){
+					return {T(1), T(0)};
+				}
+				continue;
+			}
+			T t1 = (rect.p[a] - o) * inv_dir[a];
+			T t2 = (x2_y2[a] - o) * inv_dir[a];
+			entry = max(entry, min(t1, t2));
+			exit = min(exit, max(t1, t2));
+		}
+		return {entry, exit};
+	}
+};
+
+/**
+ * @brief Test many rays against rectangle.
+ * Rays are processed by groups of 4 with SIMD instructions, when available, so packets of 4, 8, 16 or any other
+ * number of rays can be tested at once. To test segments, make rays from the segments and use t_max = 1.
+ * @param rays - rays to test.
+ * @param rect - rectangle to test the rays for intersection with.
+ * @param hits - output hit bitmask, must be of at least ray2::mask_size(rays.size()) words.
+ * @param t_max - maximum parameter of the ray points to consider.
+ * @return number of rays intersecting the rectangle.
+ */
+template <class T>
+size_t intersects(
+		utki::span<const ray2<std::common_type_t<T>>> rays,
+		const rectangle<T>& rect,
+		utki::span<uint32_t> hits,
+		T t_max = std::numeric_limits<T>::infinity()
+	)noexcept
+{
+	typedef ray2<T> ray_type;
+	typedef simd::kernel<T, 4> simd_kernel;
+
+	ASSERT(hits.size() >= ray_type::mask_size(rays.size()))
+	std::fill(hits.begin(), std::next(hits.begin(), ray_type::mask_size(rays.size())), 0);
+
+	size_t i = 0;
+	if constexpr (simd_kernel::enabled){
+		typedef typename simd_kernel::reg reg;
+
+		const reg r[] = {
+			simd_kernel::set(rect.p.x()),
+			simd_kernel::set(rect.p.y()),
+			simd_kernel::set(rect.d.x()),
+			simd_kernel::set(rect.d.y())
+		};
+		const reg zero = simd_kernel::set(T(0));
+		const reg tm = simd_kernel::set(t_max);
+		const reg one = simd_kernel::set(T(1));
+		const reg min_normal = simd_kernel::set(std::numeric_limits<T>::min());
+
+		for(; i + 4 <= rays.size(); i += 4){
+			// transpose to have origin x, origin y, direction x and direction y of all 4 rays in separate registers
+			static_assert(sizeof(ray_type) == 4 * sizeof(T), "unexpected ray2 layout");
+			reg ray[4];
+			for(size_t j = 0; j != 4; ++j){
+				ray[j] = simd_kernel::load(rays[i + j].origin.data());
+			}
+			simd_kernel::transpose(ray[0], ray[1], ray[2], ray[3]);
+
+			// rays parallel to one of the axes are handled separately, see ray2::is_parallel()
+			unsigned parallel =
+					simd_kernel::lt_mask(simd_kernel::abs(ray[2]), min_normal) |
+					simd_kernel::lt_mask(simd_kernel::abs(ray[3]), min_normal);
+
+			reg ix = simd_kernel::div(one, ray[2]);
+			reg iy = simd_kernel::div(one, ray[3]);
+
+			unsigned missed = internal::slab_miss_mask<simd_kernel>(ray[0], ray[1], ix, iy, r, zero, tm);
+			if(parallel != 0){
+				for(size_t j = 0; j != 4; ++j){
+					if(parallel & (1u << j)){
+						missed &= ~(1u << j);
+						if(!rays[i + j].intersects(rect, t_max)){
+							missed |= 1u << j;
+						}
+					}
+				}
+			}
+			hits[i / 32] |= uint32_t(~missed & 0xf) << (i % 32);
+		}
+	}
+
+	for(auto r = std::next(rays.begin(), i); r != rays.end(); ++r, ++i){
+		if(r->intersects(rect, t_max)){
+			hits[i / 32] |= uint32_t(1) << (i % 32);
+		}
+	}
+
+	return internal::count_bits(hits, rays.size());
+}
+
+/**
+ * @brief Test if segment intersects rectangle.
+ * The rectangle is treated as closed, i.e. a segment touching the rectangle's edge or corner does intersect it.
+ * For floating point types the slab test is used, see ray2. For integer types the test is exact,
+ * see segment2::side().
+ * @param s - segment to test.
+ * @param rect - rectangle to test the segment for intersection with.
+ * @return true if the segment intersects the rectangle.
+ * @return false otherwise.
+ */
+template <class T>
+bool intersects(const segment2<T>& s, const rectangle<T>& rect)noexcept{
+	if constexpr (std::is_floating_point_v<T>){
+		return ray2<T>(s).intersects(rect, T(1));
+	}else{
+		using std::min;
+		using std::max;
+
+		// separating axis test, the axes are the rectangle's axes, i.e. the bounding boxes test,
+		// and the segment's normal, i.e. all corners of the rectangle are strictly on one side of the segment's line
+		auto x2_y2 = rect.x2_y2();
+		if(
+				max(s.p1.x(), s.p2.x()) < rect.p.x() || min(s.p1.x(), s.p2.x()) > x2_y2.x() ||
+				max(s.p1.y(), s.p2.y()) < rect.p.y() || min(s.p1.y(), s.p2.y()) > x2_y2.y()
+			)
+		{
+			return false;
+		}
+
+		int side = s.side(rect.p) + s.side(rect.x1_y2()) + s.side(rect.x2_y1()) + s.side(x2_y2);
+		return side != 4 && side != -4;
+	}
+}
+
+}
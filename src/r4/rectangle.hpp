@@ -130,6 +130,41 @@ public:
 			;
 	}
 
+	/**
+	 * @brief Test if the rectangle overlaps given rectangle.
+	 * Rectangles overlap if their projections to both axes overlap, i.e. x1 < rect.x2 and rect.x1 < x2,
+	 * and same for y. Rectangles which only touch each other by their edges do not overlap.
+	 * Zero size rectangle overlaps only if its position lies strictly inside the rectangle. So, unlike a point,
+	 * see overlaps(vector2), zero size rectangle on the minimum edges of the rectangle does not overlap it.
+	 * @param rect - rectangle to test for overlapping.
+	 * @return true if the rectangles overlap.
+	 * @return false otherwise.
+	 */
+	bool overlaps(const rectangle& rect)const noexcept{
+		return
+				rect.p.x() < this->x2() &&
+				rect.p.y() < this->y2() &&
+				this->p.x() < rect.x2() &&
+				this->p.y() < rect.y2()
+			;
+	}
+
+	/**
+	 * @brief Test if the rectangle contains given rectangle.
+	 * The given rectangle is contained in case it lies within this rectangle, touching its edges is allowed.
+	 * @param rect - rectangle to test for being contained.
+	 * @return true if the given rectangle lies within this rectangle.
+	 * @return false otherwise.
+	 */
+	bool contains(const rectangle& rect)const noexcept{
+		return
+				rect.p.x() >= this->p.x() &&
+				rect.p.y() >= this->p.y() &&
+				rect.x2() <= this->x2() &&
+				rect.y2() <= this->y2()
+			;
+	}
+
 	/**
 	 * @brief Intersect this rectangle with given rectangle.
 	 * The intersection result is stored in this rectangle.
@@ -163,6 +198,22 @@ public:
 		return *this;
 	}
 
+	/**
+	 * @brief Calculate bounding rectangle of points.
+	 * The points are processed with SIMD instructions, when available.
+	 * For multithreaded calculation see parallel_bounding_rectangle().
+	 * @param points - points to calculate the bounding rectangle of.
+	 * @return bounding rectangle of the points.
+	 * @return zero rectangle at (0, 0) if the span is empty.
+	 */
+	static rectangle from_points(utki::span<const vector2<T>> points)noexcept{
+		if(points.empty()){
+			return rectangle(0, 0, 0, 0);
+		}
+		auto bounds = internal::min_max(points);
+		return rectangle(bounds.first, bounds.second - bounds.first);
+	}
+
 	/**
 	 * @brief Get point of the rectangle with maxium X and Y coordinates.
 	 * @return point of the rectangle with maximal X anf Y coordinates.
@@ -0,0 +1,718 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <vector>
+#include <numeric>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "rectangle.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Skyline rectangle packer.
+ * Packs rectangles into a bin of fixed dimensions, e.g. glyphs or sprites into a texture atlas.
+ * The packer keeps the upper contour of the packed rectangles, the skyline, as an array of horizontal
+ * segments sorted by x, and places each rectangle at the position where its top is the lowest,
+ * the leftmost of such positions is taken.
+ * The packer is fast and uses little memory, but the space below the skyline which is not occupied by
+ * the packed rectangles is lost.
+ * The cost of insertion grows linearly with the number of skyline segments, which is about the bin width
+ * divided by the typical rectangle width.
+ * Rectangles are never rotated.
+ * @tparam T - type of coordinates, must be signed.
+ */
+template <class T> class skyline_packer{
+	static_assert(std::is_signed_v<T>, "coordinates must be signed");
+
+	vector2<T> bin_dims;
+
+	// segment of the skyline, everything above the segment is free
+	struct node{
+		T x;
+		T y;
+		T width;
+	};
+
+	// sorted by x, covers [0 : bin_dims.x()) without gaps
+	std::vector<node> nodes;
+
+	T used = 0;
+
+	// Calculate y of the rectangle of given dimensions placed at x of the given node.
+	// Returns false in case the rectangle does not fit at that position or its y is not below y_bound.
+	bool fit(size_t index, const vector2<T>& dims, T y_bound, T& y)const noexcept{
+		ASSERT(this->nodes[index].x + dims.x() <= this->bin_dims.x())
+		y = 0;
+		T remaining = dims.x();
+		for(auto i = this->nodes.begin() + index; remaining > 0; ++i){
+			ASSERT(i != this->nodes.end())
+			y = std::max(y, i->y);
+			if(y >= y_bound || y + dims.y() > this->bin_dims.y()){
+				return false;
+			}
+			remaining -= i->width;
+		}
+		return true;
+	}
+
+	// Merge neighbour nodes of same height in the range of nodes [begin - 1 : end].
+	// The range is compacted in place and the merged nodes are erased at once, so the nodes after the range
+	// are shifted only once.
+	void merge(size_t begin, size_t end)noexcept{
+		size_t out = begin == 0 ? 0 : begin - 1;
+		end = std::min(end + 1, this->nodes.size());
+		for(size_t i = out + 1; i < end; ++i){
+			auto& n = this->nodes[out];
+			const auto& next = this->nodes[i];
+			if(n.y == next.y){
+				n.width += next.width;
+			}else{
+				++out;
+				this->nodes[out] = next;
+			}
+		}
+		++out;
+		if(out < end){
+			this->nodes.erase(this->nodes.begin() + out, this->nodes.begin() + end);
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param dims - dimensions of the bin.
+	 */
+	skyline_packer(const vector2<T>& dims) :
+			bin_dims(dims)
+	{
+		this->clear();
+	}
+
+	/**
+	 * @brief Get dimensions of the bin.
+	 * @return dimensions of the bin.
+	 */
+	const vector2<T>& dims()const noexcept{
+		return this->bin_dims;
+	}
+
+	/**
+	 * @brief Get area occupied by the packed rectangles.
+	 * @return total area of the packed rectangles.
+	 */
+	T used_area()const noexcept{
+		return this->used;
+	}
+
+	/**
+	 * @brief Remove all packed rectangles.
+	 */
+	void clear(){
+		this->nodes.clear();
+		this->nodes.push_back(node{0, 0, this->bin_dims.x()});
+		this->used = 0;
+	}
+
+	/**
+	 * @brief Pack rectangle.
+	 * @param dims - dimensions of the rectangle to pack, must be non-negative.
+	 * @return placement of the rectangle in the bin.
+	 * @return std::nullopt in case the rectangle does not fit.
+	 */
+	std::optional<rectangle<T>> insert(const vector2<T>& dims){
+		ASSERT(dims.x() >= 0 && dims.y() >= 0)
+		if(dims.x() == 0 || dims.y() == 0){
+			return rectangle<T>(vector2<T>(0), dims);
+		}
+
+		size_t best = this->nodes.size();
+		T best_y = std::numeric_limits<T>::max();
+		for(size_t i = 0; i != this->nodes.size(); ++i){
+			const auto& n = this->nodes[i];
+			if(n.x + dims.x() > this->bin_dims.x()){
+				// nodes are sorted by x, so the rest of nodes are too far right as well
+				break;
+			}
+			T y;
+			if(n.y < best_y && this->fit(i, dims, best_y, y)){
+				best = i;
+				best_y = y;
+			}
+		}
+
+		if(best == this->nodes.size()){
+			return std::nullopt;
+		}
+
+		rectangle<T> ret(vector2<T>(this->nodes[best].x, best_y), dims);
+		node new_node{ret.p.x(), ret.y2(), dims.x()};
+
+		// nodes [begin : end) are covered by the new node completely, the node at end may be covered partially
+		T x2 = ret.x2();
+		auto begin = this->nodes.begin() + best;
+		auto end = begin;
+		for(; end != this->nodes.end() && end->x + end->width <= x2; ++end){}
+		if(end != this->nodes.end() && end->x < x2){
+			end->width -= x2 - end->x;
+			end->x = x2;
+		}
+
+		// the new node replaces the covered nodes, so the nodes after them are shifted at most once
+		if(begin == end){
+			this->nodes.insert(begin, new_node);
+		}else{
+			*begin = new_node;
+			this->nodes.erase(begin + 1, end);
+		}
+
+		this->merge(best, best + 1);
+
+		this->used += dims.x() * dims.y();
+		return ret;
+	}
+
+	/**
+	 * @brief Free space occupied by packed rectangle.
+	 * The skyline can only be lowered, so the space can be freed only in case the rectangle lies right
+	 * below the skyline, i.e. its top edge is the part of the skyline, e.g. the last packed rectangle.
+	 * The skyline is lowered to the bottom edge of the rectangle, the space which was lost below the rectangle
+	 * when it was packed remains lost. Otherwise the space of the rectangle is lost until clear().
+	 * @param rect - placement of the packed rectangle as returned by insert().
+	 * @return true in case the space is freed.
+	 * @return false otherwise.
+	 */
+	bool free(const rectangle<T>& rect){
+		if(rect.d.x() == 0 || rect.d.y() == 0){
+			return true;
+		}
+
+		T x1 = rect.p.x();
+		T x2 = rect.x2();
+
+		auto begin = std::upper_bound(
+				this->nodes.begin(),
+				this->nodes.end(),
+				x1,
+				[](T x, const node& n){
+					return x < n.x;
+				}
+			);
+		ASSERT(begin != this->nodes.begin())
+		--begin;
+
+		auto end = begin;
+		for(; end != this->nodes.end() && end->x < x2; ++end){
+			if(end->y != rect.y2()){
+				return false;
+			}
+		}
+
+		// replace the nodes above the rectangle with the lowered node and parts of the first and last nodes
+		// sticking out of the rectangle
+		std::array<node, 3> replacement;
+		size_t num = 0;
+		const auto& first = *begin;
+		const auto& last = *(end - 1);
+		if(first.x < x1){
+			replacement[num++] = node{first.x, first.y, x1 - first.x};
+		}
+		replacement[num++] = node{x1, rect.p.y(), rect.d.x()};
+		if(last.x + last.width > x2){
+			replacement[num++] = node{x2, last.y, last.x + last.width - x2};
+		}
+
+		size_t index = size_t(begin - this->nodes.begin());
+		size_t count = size_t(end - begin);
+		if(count >= num){
+			std::copy(replacement.begin(), replacement.begin() + num, begin);
+			this->nodes.erase(begin + num, end);
+		}else{
+			std::copy(replacement.begin(), replacement.begin() + count, begin);
+			this->nodes.insert(end, replacement.begin() + count, replacement.begin() + num);
+		}
+
+		this->merge(index, index + num);
+
+		this->used -= rect.d.x() * rect.d.y();
+		return true;
+	}
+};
+
+/**
+ * @brief MaxRects rectangle packer.
+ * Packs rectangles into a bin of fixed dimensions, e.g. glyphs or sprites into a texture atlas.
+ * The packer keeps the list of maximal free rectangles, which may overlap each other, and places each rectangle
+ * to the free rectangle where it fits best by shorter leftover side (best short side fit heuristic).
+ * The packer gives denser packing than skyline_packer for rectangles of varying sizes, but is slower,
+ * the cost of insertion grows linearly with the number of free rectangles. The free rectangles overlap,
+ * so there are several of them per packed rectangle. Use skyline_packer in case insertion speed matters
+ * more than density.
+ * The free rectangles are stored as separate arrays of coordinates, so that searching through them
+ * is done by plain loops over contiguous arrays, which the compiler vectorizes.
+ * Rectangles are never rotated.
+ * @tparam T - type of coordinates, must be signed.
+ */
+template <class T> class max_rects_packer{
+	static_assert(std::is_signed_v<T>, "coordinates must be signed");
+
+	vector2<T> bin_dims;
+
+	// free rectangles by corner coordinates, structure of arrays
+	struct rect_arrays{
+		std::vector<T> x1;
+		std::vector<T> y1;
+		std::vector<T> x2;
+		std::vector<T> y2;
+
+		size_t size()const noexcept{
+			return this->x1.size();
+		}
+
+		void clear()noexcept{
+			this->x1.clear();
+			this->y1.clear();
+			this->x2.clear();
+			this->y2.clear();
+		}
+
+		void push_back(const rectangle<T>& r){
+			this->x1.push_back(r.p.x());
+			this->y1.push_back(r.p.y());
+			this->x2.push_back(r.x2());
+			this->y2.push_back(r.y2());
+		}
+
+		rectangle<T> operator[](size_t i)const noexcept{
+			return rectangle<T>(this->x1[i], this->y1[i], this->x2[i] - this->x1[i], this->y2[i] - this->y1[i]);
+		}
+
+		// remove element by replacing it with the last one
+		void remove(size_t i)noexcept{
+			this->x1[i] = this->x1.back();
+			this->y1[i] = this->y1.back();
+			this->x2[i] = this->x2.back();
+			this->y2[i] = this->y2.back();
+			this->x1.pop_back();
+			this->y1.pop_back();
+			this->x2.pop_back();
+			this->y2.pop_back();
+		}
+
+		// check if any of the rectangles contains the given one
+		bool any_contains(const rectangle<T>& r)const noexcept{
+			T rx1 = r.p.x();
+			T ry1 = r.p.y();
+			T rx2 = r.x2();
+			T ry2 = r.y2();
+			const T* x1 = this->x1.data();
+			const T* y1 = this->y1.data();
+			const T* x2 = this->x2.data();
+			const T* y2 = this->y2.data();
+
+			// branchless, to be vectorized
+			bool ret = false;
+			for(size_t i = 0; i != this->size(); ++i){
+				ret |= (x1[i] <= rx1) & (y1[i] <= ry1) & (rx2 <= x2[i]) & (ry2 <= y2[i]);
+			}
+			return ret;
+		}
+	};
+
+	rect_arrays free_rects;
+
+	// reused to avoid memory allocation on each insertion
+	std::vector<rectangle<T>> new_rects;
+	std::vector<rectangle<T>> touching_rects;
+	std::vector<size_t> overlapping_indices;
+
+	T used = 0;
+
+	// free rectangles are searched through by chunks of this size, the search within a chunk is vectorized
+	static constexpr size_t chunk_size = 64;
+
+	// Leftover side of the free rectangle where the packed one does not fit is negative, the key maps it to
+	// a value greater than any non-negative leftover. For integers this is done by conversion to unsigned type,
+	// because a conditional expression prevents the compiler from vectorizing the loops of find_best().
+	// Keys of negative leftovers are not less than key of the lowest value of T.
+	typedef typename std::conditional_t<
+			std::is_integral_v<T>,
+			std::make_unsigned<T>,
+			std::common_type<T>
+		>::type key_type;
+
+	static key_type key(T leftover)noexcept{
+		if constexpr (std::is_integral_v<T>){
+			return key_type(leftover);
+		}else{
+			return leftover < 0 ? std::numeric_limits<T>::max() : leftover;
+		}
+	}
+
+	// Find free rectangle by best short side fit, returns size of the free rectangles list in case nothing fits.
+	size_t find_best(const vector2<T>& dims)const noexcept{
+		const auto& fr = this->free_rects;
+		size_t size = fr.size();
+		const T* x1 = fr.x1.data();
+		const T* y1 = fr.y1.data();
+		const T* x2 = fr.x2.data();
+		const T* y2 = fr.y2.data();
+		T w = dims.x();
+		T h = dims.y();
+
+		constexpr auto none = std::numeric_limits<key_type>::max();
+
+		// The search is done in separate branchless passes, to be vectorized, which is faster than
+		// a single pass with branches. Ternary operators are used instead of std::min() and std::max()
+		// for the same reason.
+		key_type best_short = none;
+		for(size_t i = 0; i != size; ++i){
+			T lw = x2[i] - x1[i] - w;
+			T lh = y2[i] - y1[i] - h;
+			key_type s = key(lw < lh ? lw : lh);
+			best_short = s < best_short ? s : best_short;
+		}
+		if(best_short >= key(std::numeric_limits<T>::lowest())){
+			// all leftovers are negative
+			return size;
+		}
+
+		// The longer leftover is searched by chunks, the search within a chunk is vectorized.
+		// The first chunk where the best longer leftover is found contains the best rectangle,
+		// so it is the only chunk to search through for the index of the best rectangle.
+		key_type best_long = none;
+		size_t best_chunk = 0;
+		for(size_t begin = 0; begin < size; begin += chunk_size){
+			size_t end = std::min(begin + chunk_size, size);
+			key_type chunk_long = none;
+			for(size_t i = begin; i != end; ++i){
+				T lw = x2[i] - x1[i] - w;
+				T lh = y2[i] - y1[i] - h;
+				key_type s = key(lw < lh ? lw : lh);
+				key_type l = key(lw < lh ? lh : lw);
+				if constexpr (std::is_integral_v<T>){
+					// set all bits in case the shorter leftover is not the best one, which gives the 'none' value
+					l |= key_type(0) - key_type(s != best_short);
+				}else{
+					l = s == best_short ? l : none;
+				}
+				chunk_long = l < chunk_long ? l : chunk_long;
+			}
+			if(chunk_long < best_long){
+				best_long = chunk_long;
+				best_chunk = begin;
+			}
+		}
+
+		for(size_t i = best_chunk; ; ++i){
+			ASSERT(i < std::min(best_chunk + chunk_size, size))
+			T lw = x2[i] - x1[i] - w;
+			T lh = y2[i] - y1[i] - h;
+			if(key(lw < lh ? lw : lh) == best_short && key(lw < lh ? lh : lw) == best_long){
+				return i;
+			}
+		}
+	}
+
+	// Replace free rectangles overlapping the given occupied rectangle with maximal free rectangles around it.
+	void split(const rectangle<T>& occupied){
+		auto& fr = this->free_rects;
+		auto& nr = this->new_rects;
+		nr.clear();
+		this->touching_rects.clear();
+
+		T ox1 = occupied.p.x();
+		T oy1 = occupied.p.y();
+		T ox2 = occupied.x2();
+		T oy2 = occupied.y2();
+
+		const T* x1 = fr.x1.data();
+		const T* y1 = fr.y1.data();
+		const T* x2 = fr.x2.data();
+		const T* y2 = fr.y2.data();
+		auto touches = [&](size_t i) -> unsigned{
+			return unsigned((ox1 <= x2[i]) & (oy1 <= y2[i]) & (x1[i] <= ox2) & (y1[i] <= oy2));
+		};
+
+		// Free rectangles touching the occupied one are searched by chunks, the check if a chunk contains
+		// any of them is branchless, to be vectorized. Only few chunks contain touching rectangles,
+		// those are searched through one by one.
+		size_t size = fr.size();
+		this->overlapping_indices.clear();
+		for(size_t begin = 0; begin < size; begin += chunk_size){
+			size_t end = std::min(begin + chunk_size, size);
+			unsigned found = 0;
+			for(size_t i = begin; i != end; ++i){
+				found |= touches(i);
+			}
+			if(!found){
+				continue;
+			}
+			for(size_t i = begin; i != end; ++i){
+				if(!touches(i)){
+					continue;
+				}
+
+				auto f = fr[i];
+				if(!f.overlaps(occupied)){
+					this->touching_rects.push_back(f);
+					continue;
+				}
+				this->overlapping_indices.push_back(i);
+
+				T fx1 = f.p.x();
+				T fy1 = f.p.y();
+				T fx2 = f.x2();
+				T fy2 = f.y2();
+
+				if(fx1 < ox1){
+					nr.push_back(rectangle<T>(fx1, fy1, ox1 - fx1, fy2 - fy1));
+				}
+				if(ox2 < fx2){
+					nr.push_back(rectangle<T>(ox2, fy1, fx2 - ox2, fy2 - fy1));
+				}
+				if(fy1 < oy1){
+					nr.push_back(rectangle<T>(fx1, fy1, fx2 - fx1, oy1 - fy1));
+				}
+				if(oy2 < fy2){
+					nr.push_back(rectangle<T>(fx1, oy2, fx2 - fx1, fy2 - oy2));
+				}
+			}
+		}
+
+		// removing in descending order of indices does not move the rectangles which are yet to be removed
+		for(auto i = this->overlapping_indices.rbegin(); i != this->overlapping_indices.rend(); ++i){
+			fr.remove(*i);
+		}
+
+		// The remaining free rectangles do not contain each other. The new ones are parts of the removed ones,
+		// so none of the remaining rectangles can be contained in a new one, otherwise it would be contained
+		// in the removed one. Thus, only the new rectangles need to be checked for being contained in others.
+		// Each new rectangle touches the occupied one, so it can only be contained in a free rectangle
+		// which touches the occupied one as well.
+		for(size_t i = 0; i != nr.size(); ){
+			bool contained = false;
+			for(size_t j = 0; !contained && j != this->touching_rects.size(); ++j){
+				contained = this->touching_rects[j].contains(nr[i]);
+			}
+			for(size_t j = 0; !contained && j != nr.size(); ++j){
+				// in case of equal rectangles the one with greater index is removed
+				contained = j != i && nr[j].contains(nr[i]) && (j < i || !(nr[j] == nr[i]));
+			}
+			if(contained){
+				nr[i] = nr.back();
+				nr.pop_back();
+			}else{
+				++i;
+			}
+		}
+
+		for(const auto& r : nr){
+			fr.push_back(r);
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param dims - dimensions of the bin.
+	 */
+	max_rects_packer(const vector2<T>& dims) :
+			bin_dims(dims)
+	{
+		this->clear();
+	}
+
+	/**
+	 * @brief Get dimensions of the bin.
+	 * @return dimensions of the bin.
+	 */
+	const vector2<T>& dims()const noexcept{
+		return this->bin_dims;
+	}
+
+	/**
+	 * @brief Get area occupied by the packed rectangles.
+	 * @return total area of the packed rectangles.
+	 */
+	T used_area()const noexcept{
+		return this->used;
+	}
+
+	/**
+	 * @brief Get free rectangles.
+	 * Free rectangles may overlap each other, but none of them contains another one.
+	 * @return copy of the free rectangles list.
+	 */
+	std::vector<rectangle<T>> free_rectangles()const{
+		std::vector<rectangle<T>> ret;
+		ret.reserve(this->free_rects.size());
+		for(size_t i = 0; i != this->free_rects.size(); ++i){
+			ret.push_back(this->free_rects[i]);
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Remove all packed rectangles.
+	 */
+	void clear(){
+		this->free_rects.clear();
+		this->free_rects.push_back(rectangle<T>(vector2<T>(0), this->bin_dims));
+		this->used = 0;
+	}
+
+	/**
+	 * @brief Pack rectangle.
+	 * @param dims - dimensions of the rectangle to pack, must be non-negative.
+	 * @return placement of the rectangle in the bin.
+	 * @return std::nullopt in case the rectangle does not fit.
+	 */
+	std::optional<rectangle<T>> insert(const vector2<T>& dims){
+		ASSERT(dims.x() >= 0 && dims.y() >= 0)
+		if(dims.x() == 0 || dims.y() == 0){
+			return rectangle<T>(vector2<T>(0), dims);
+		}
+
+		size_t best = this->find_best(dims);
+		if(best == this->free_rects.size()){
+			return std::nullopt;
+		}
+
+		rectangle<T> ret(vector2<T>(this->free_rects.x1[best], this->free_rects.y1[best]), dims);
+		this->split(ret);
+
+		this->used += dims.x() * dims.y();
+		return ret;
+	}
+
+	/**
+	 * @brief Free space occupied by packed rectangle.
+	 * The freed rectangle is added to the free list, merged with the free rectangles sharing a whole edge with it.
+	 * The free list is not rebuilt to be maximal, so freeing fragments the free space to some extent.
+	 * @param rect - placement of the packed rectangle as returned by insert().
+	 */
+	void free(const rectangle<T>& rect){
+		if(rect.d.x() == 0 || rect.d.y() == 0){
+			return;
+		}
+
+		this->used -= rect.d.x() * rect.d.y();
+
+		auto& fr = this->free_rects;
+
+		auto r = rect;
+		for(size_t i = 0; i != fr.size(); ){
+			auto f = fr[i];
+			bool same_column = f.p.x() == r.p.x() && f.d.x() == r.d.x() && (f.y2() == r.p.y() || r.y2() == f.p.y());
+			bool same_row = f.p.y() == r.p.y() && f.d.y() == r.d.y() && (f.x2() == r.p.x() || r.x2() == f.p.x());
+			if(same_column || same_row){
+				r.unite(f);
+				fr.remove(i);
+				i = 0;
+			}else{
+				++i;
+			}
+		}
+
+		if(fr.any_contains(r)){
+			return;
+		}
+
+		for(size_t i = 0; i != fr.size(); ){
+			if(r.contains(fr[i])){
+				fr.remove(i);
+			}else{
+				++i;
+			}
+		}
+		fr.push_back(r);
+	}
+};
+
+/**
+ * @brief Pack set of rectangles.
+ * Offline packing, the rectangles are inserted in the order of decreasing longer side and then shorter side,
+ * which gives denser packing than inserting them in arbitrary order.
+ * @param packer - packer to insert the rectangles to, skyline_packer or max_rects_packer.
+ * @param dims - dimensions of the rectangles to pack.
+ * @param out - output span of placements of the rectangles, must be of the same size as dims span.
+ *              Placements of the rectangles which did not fit have negative dimensions.
+ * @return number of packed rectangles.
+ */
+template <class P, class T> size_t pack(P& packer, utki::span<const vector2<T>> dims, utki::span<rectangle<T>> out){
+	static_assert(std::is_signed_v<T>, "coordinates must be signed, negative dimensions mark rectangles which did not fit");
+
+	ASSERT(dims.size() == out.size())
+
+	std::vector<size_t> order(dims.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(
+			order.begin(),
+			order.end(),
+			[&dims](size_t a, size_t b){
+				const auto& da = dims[a];
+				const auto& db = dims[b];
+				T la = std::max(da.x(), da.y());
+				T lb = std::max(db.x(), db.y());
+				if(la != lb){
+					return la > lb;
+				}
+				return std::min(da.x(), da.y()) > std::min(db.x(), db.y());
+			}
+		);
+
+	size_t ret = 0;
+	for(auto i : order){
+		auto r = packer.insert(dims[i]);
+		if(r){
+			out[i] = r.value();
+			++ret;
+		}else{
+			out[i] = rectangle<T>(0, 0, -1, -1);
+		}
+	}
+	return ret;
+}
+
+}
@@ -0,0 +1,417 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include <utki/span.hpp>
+#include <utki/debug.hpp>
+
+#include "rectangle.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Region of 2d space as a set of disjoint rectangles.
+ * Intended for accumulating damaged areas for incremental redraw. Unlike uniting the damaged rectangles
+ * into a single bounding rectangle, the region keeps separate areas separate, so that only the really
+ * damaged areas are redrawn.
+ * The number of rectangles is bounded, when adding a rectangle makes it exceed the limit, the pair of
+ * rectangles whose bounding rectangle adds the least area to the region is merged, until the number of
+ * rectangles is within the limit. So, the region can grow bigger than the union of the added rectangles,
+ * but never smaller. Adjacent rectangles which unite exactly, without adding any area, are always merged.
+ * Rectangles of zero or negative area are ignored.
+ * @tparam T - type of coordinates.
+ */
+template <class T> class region{
+	size_t max_rects;
+
+	std::vector<rectangle<T>> rects;
+
+	// bounding rectangle of all the rectangles, valid only when the region is not empty
+	rectangle<T> bounds;
+
+	// reused to avoid memory allocation on each operation
+	std::vector<rectangle<T>> pieces;
+	std::vector<rectangle<T>> new_pieces;
+
+	static bool is_empty(const rectangle<T>& r)noexcept{
+		return !(r.d.x() > 0 && r.d.y() > 0);
+	}
+
+	static T area(const rectangle<T>& r)noexcept{
+		return r.d.x() * r.d.y();
+	}
+
+	// Append parts of the rectangle which are not covered by the hole, the rectangle must overlap the hole.
+	// The parts are: full height strips to the left and to the right of the hole and strips below and above the hole
+	// limited to the hole's horizontal extent.
+	template <class C> static void cut(const rectangle<T>& r, const rectangle<T>& hole, C& out){
+		using std::min;
+		using std::max;
+
+		ASSERT(r.overlaps(hole))
+
+		T x1 = r.p.x();
+		T y1 = r.p.y();
+		T x2 = r.x2();
+		T y2 = r.y2();
+
+		T hx1 = max(hole.p.x(), x1);
+		T hx2 = min(hole.x2(), x2);
+
+		if(x1 < hx1){
+			out.push_back(rectangle<T>(x1, y1, hx1 - x1, y2 - y1));
+		}
+		if(hx2 < x2){
+			out.push_back(rectangle<T>(hx2, y1, x2 - hx2, y2 - y1));
+		}
+		if(y1 < hole.p.y()){
+			out.push_back(rectangle<T>(hx1, y1, hx2 - hx1, hole.p.y() - y1));
+		}
+		if(hole.y2() < y2){
+			out.push_back(rectangle<T>(hx1, hole.y2(), hx2 - hx1, y2 - hole.y2()));
+		}
+	}
+
+	void remove(size_t i)noexcept{
+		this->rects[i] = this->rects.back();
+		this->rects.pop_back();
+	}
+
+	void update_bounds()noexcept{
+		if(this->rects.empty()){
+			return;
+		}
+		this->bounds = this->rects.front();
+		for(const auto& r : this->rects){
+			this->bounds.unite(r);
+		}
+	}
+
+	// Replace two rectangles with their bounding rectangle, which also swallows all other rectangles
+	// it overlaps, so that the rectangles remain disjoint.
+	void merge(size_t i, size_t j){
+		ASSERT(i < j)
+		auto u = this->rects[i];
+		u.unite(this->rects[j]);
+		this->remove(j);
+		this->remove(i);
+
+		for(size_t k = 0; k != this->rects.size(); ){
+			if(this->rects[k].overlaps(u)){
+				u.unite(this->rects[k]);
+				this->remove(k);
+				// the bounding rectangle has grown, it may overlap rectangles which were checked already
+				k = 0;
+			}else{
+				++k;
+			}
+		}
+
+		this->rects.push_back(u);
+	}
+
+	void reduce(){
+		for(;;){
+			size_t size = this->rects.size();
+			if(size < 2){
+				return;
+			}
+
+			size_t best_i = 0;
+			size_t best_j = 0;
+			T best_waste = std::numeric_limits<T>::max();
+			for(size_t i = 0; i != size && best_waste > 0; ++i){
+				const auto& a = this->rects[i];
+				T area_a = area(a);
+				for(size_t j = i + 1; j != size; ++j){
+					const auto& b = this->rects[j];
+					auto u = a;
+					u.unite(b);
+					T waste = area(u) - area_a - area(b);
+					if(waste < best_waste){
+						best_waste = waste;
+						best_i = i;
+						best_j = j;
+						if(!(waste > 0)){
+							break;
+						}
+					}
+				}
+			}
+
+			if(best_waste > 0 && size <= this->max_rects){
+				return;
+			}
+
+			this->merge(best_i, best_j);
+		}
+	}
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param max_rects - maximum number of rectangles in the region, must be greater than zero.
+	 *                    Each addition costs O(max_rects^2) in the worst case.
+	 */
+	region(size_t max_rects = 16) :
+			max_rects(max_rects)
+	{
+		ASSERT(max_rects > 0)
+		this->rects.reserve(max_rects + 1);
+	}
+
+	/**
+	 * @brief Get rectangles of the region.
+	 * The rectangles do not overlap each other.
+	 * @return span of the rectangles.
+	 */
+	utki::span<const rectangle<T>> rectangles()const noexcept{
+		return utki::make_span(this->rects);
+	}
+
+	/**
+	 * @brief Get number of rectangles in the region.
+	 * @return number of rectangles.
+	 */
+	size_t size()const noexcept{
+		return this->rects.size();
+	}
+
+	/**
+	 * @brief Get maximum number of rectangles in the region.
+	 * @return maximum number of rectangles.
+	 */
+	size_t max_size()const noexcept{
+		return this->max_rects;
+	}
+
+	/**
+	 * @brief Check if the region is empty.
+	 * @return true if the region has no rectangles.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->rects.empty();
+	}
+
+	/**
+	 * @brief Make the region empty.
+	 */
+	void clear()noexcept{
+		this->rects.clear();
+	}
+
+	/**
+	 * @brief Get bounding rectangle of the region.
+	 * @return bounding rectangle of the region.
+	 * @return zero rectangle at (0, 0) in case the region is empty.
+	 */
+	rectangle<T> bounding_rectangle()const noexcept{
+		if(this->rects.empty()){
+			return rectangle<T>(0, 0, 0, 0);
+		}
+		return this->bounds;
+	}
+
+	/**
+	 * @brief Get area of the region.
+	 * @return total area of the region's rectangles.
+	 */
+	T area()const noexcept{
+		T ret = 0;
+		for(const auto& r : this->rects){
+			ret += area(r);
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Add rectangle to the region.
+	 * Only parts of the rectangle which are not in the region yet are added. In case the number of rectangles
+	 * then exceeds the maximum, rectangles are merged, see region description. This is done even if nothing
+	 * is added, as the number of rectangles may exceed the maximum after subtract().
+	 * @param rect - rectangle to add.
+	 */
+	void add(const rectangle<T>& rect){
+		if(is_empty(rect)){
+			this->reduce();
+			return;
+		}
+
+		if(this->rects.empty()){
+			this->rects.push_back(rect);
+			this->bounds = rect;
+			return;
+		}
+
+		auto& p = this->pieces;
+		p.clear();
+		p.push_back(rect);
+
+		if(this->bounds.overlaps(rect)){
+			for(const auto& r : this->rects){
+				if(!r.overlaps(rect)){
+					continue;
+				}
+				if(r.contains(rect)){
+					this->reduce();
+					return;
+				}
+
+				auto& np = this->new_pieces;
+				np.clear();
+				for(const auto& piece : p){
+					if(piece.overlaps(r)){
+						cut(piece, r, np);
+					}else{
+						np.push_back(piece);
+					}
+				}
+				std::swap(p, np);
+			}
+		}
+
+		this->rects.insert(this->rects.end(), p.begin(), p.end());
+		this->bounds.unite(rect);
+		this->reduce();
+	}
+
+	/**
+	 * @brief Add region to this region.
+	 * @param reg - region to add.
+	 */
+	void add(const region& reg){
+		for(const auto& r : reg.rects){
+			this->add(r);
+		}
+	}
+
+	/**
+	 * @brief Subtract rectangle from the region.
+	 * The subtraction is exact, the resulting number of rectangles may exceed the maximum,
+	 * it is brought within the limit by the next add().
+	 * @param rect - rectangle to subtract.
+	 */
+	void subtract(const rectangle<T>& rect){
+		if(is_empty(rect) || this->rects.empty() || !this->bounds.overlaps(rect)){
+			return;
+		}
+
+		auto& p = this->pieces;
+		p.clear();
+		bool changed = false;
+		for(const auto& r : this->rects){
+			if(r.overlaps(rect)){
+				cut(r, rect, p);
+				changed = true;
+			}else{
+				p.push_back(r);
+			}
+		}
+
+		if(changed){
+			std::swap(this->rects, p);
+			this->update_bounds();
+		}
+	}
+
+	/**
+	 * @brief Intersect the region with rectangle.
+	 * The intersection is exact.
+	 * @param rect - rectangle to intersect the region with.
+	 */
+	void intersect(const rectangle<T>& rect){
+		if(is_empty(rect)){
+			this->clear();
+			return;
+		}
+		for(size_t i = 0; i != this->rects.size(); ){
+			auto& r = this->rects[i];
+			if(r.overlaps(rect)){
+				r.intersect(rect);
+				++i;
+			}else{
+				this->remove(i);
+			}
+		}
+		this->update_bounds();
+	}
+
+	/**
+	 * @brief Test if the region overlaps given point.
+	 * @param point - point to test for overlapping.
+	 * @return true if any of the region's rectangles overlaps the point.
+	 * @return false otherwise.
+	 */
+	bool overlaps(const vector2<T>& point)const noexcept{
+		if(this->rects.empty() || !this->bounds.overlaps(point)){
+			return false;
+		}
+		return std::any_of(
+				this->rects.begin(),
+				this->rects.end(),
+				[&point](const auto& r){
+					return r.overlaps(point);
+				}
+			);
+	}
+
+	/**
+	 * @brief Test if the region overlaps given rectangle.
+	 * Same as rectangle::overlaps(), touching by edges is not overlapping.
+	 * @param rect - rectangle to test for overlapping.
+	 * @return true if any of the region's rectangles overlaps the given rectangle.
+	 * @return false otherwise.
+	 */
+	bool overlaps(const rectangle<T>& rect)const noexcept{
+		if(this->rects.empty() || !this->bounds.overlaps(rect)){
+			return false;
+		}
+		return std::any_of(
+				this->rects.begin(),
+				this->rects.end(),
+				[&rect](const auto& r){
+					return r.overlaps(rect);
+				}
+			);
+	}
+};
+
+}
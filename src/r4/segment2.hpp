@@ -26,6 +26,10 @@ SOFTWARE.
 
 #pragma once
 
+#include <tuple>
+#include <limits>
+#include <type_traits>
+
 #include "vector.hpp"
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
@@ -147,8 +151,8 @@ public:
 				limits::max()
 			};
 		this->p2 = decltype(this->p2){
-				limits::min(),
-				limits::min()
+				limits::lowest(),
+				limits::lowest()
 			};
 		return *this;
 	}
@@ -169,6 +173,147 @@ public:
 
 		return *this;
 	}
+
+	/**
+	 * @brief Calculate bounding box of points.
+	 * The points are processed with SIMD instructions, when available.
+	 * For multithreaded calculation see parallel_bounding_box().
+	 * @param points - points to calculate the bounding box of.
+	 * @return bounding box of the points, p1 is the minimum corner and p2 is the maximum corner.
+	 * @return empty bounding box, as set by set_empty_bounding_box(), if the span is empty.
+	 */
+	static segment2 from_points(utki::span<const vector2<T>> points)noexcept{
+		segment2 ret;
+		if(points.empty()){
+			ret.set_empty_bounding_box();
+		}else{
+			std::tie(ret.p1, ret.p2) = internal::min_max(points);
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Get side of the segment's line the point is on.
+	 * The side is the sign of the cross product (p2 - p1) x (point - p1).
+	 * For integer types the calculation is exact, it is done in long long, so
+	 * the coordinates must not exceed 2^30 by absolute value for 32 bit integers.
+	 * @param point - point to get the side of.
+	 * @return 1 if the point is to the left of the line directed from p1 to p2, in a coordinate system with Y axis pointing up.
+	 * @return -1 if the point is to the right of the line.
+	 * @return 0 if the point is on the line.
+	 */
+	int side(const vector2<T>& point)const noexcept{
+		wide_type x = this->p1.x();
+		wide_type y = this->p1.y();
+		wide_type o =
+				(wide_type(this->p2.x()) - x) * (wide_type(point.y()) - y) -
+				(wide_type(this->p2.y()) - y) * (wide_type(point.x()) - x);
+		return (o > 0) - (o < 0);
+	}
+
+	/**
+	 * @brief Test if this segment intersects another segment.
+	 * Segments are closed, i.e. segments which only touch each other by an end point, or which are collinear
+	 * and overlapping, do intersect. Degenerate segments, i.e. points, are also handled.
+	 * For integer types the test is exact, see side().
+	 * @param s - segment to test for intersection with.
+	 * @return true if the segments have at least one common point.
+	 * @return false otherwise.
+	 */
+	bool intersects(const segment2& s)const noexcept{
+		// in case both end points of one segment are strictly on the same side of the other segment's line,
+		// the segments do not intersect
+		int d1 = s.side(this->p1);
+		int d2 = s.side(this->p2);
+		if(d1 * d2 > 0){
+			return false;
+		}
+		int d3 = this->side(s.p1);
+		int d4 = this->side(s.p2);
+		if(d3 * d4 > 0){
+			return false;
+		}
+
+		if(d1 * d2 < 0 && d3 * d4 < 0){
+			return true;
+		}
+
+		// a point which is collinear with the other segment lies on it if it is within the segment's bounding box
+		return
+				(d1 == 0 && within_box(s.p1, s.p2, this->p1)) ||
+				(d2 == 0 && within_box(s.p1, s.p2, this->p2)) ||
+				(d3 == 0 && within_box(this->p1, this->p2, s.p1)) ||
+				(d4 == 0 && within_box(this->p1, this->p2, s.p2))
+			;
+	}
+
+	/**
+	 * @brief Intersect this segment with another segment.
+	 * Defined only for floating point types.
+	 * The segment is parametrized as p1 + (p2 - p1) * t, where t is from [0 : 1].
+	 * In case the segments are collinear and overlap, the parameter of the common point closest to p1 is returned.
+	 * @param s - segment to intersect with.
+	 * @return parameter t of the first common point of the segments.
+	 * @return infinity in case the segments do not intersect.
+	 */
+	template <typename E = T>
+	std::enable_if_t<std::is_floating_point_v<E>, T> intersect(const segment2& s)const noexcept{
+		constexpr auto none = std::numeric_limits<T>::infinity();
+
+		auto r = this->dx_dy();
+		auto q = s.dx_dy();
+		auto w = s.p1 - this->p1;
+
+		T denom = cross(r, q);
+		if(denom != 0){
+			T t = cross(w, q) / denom;
+			T u = cross(w, r) / denom;
+			if(t >= 0 && t <= 1 && u >= 0 && u <= 1){
+				return t;
+			}
+			return none;
+		}
+
+		// parallel segments
+		T rr = r * r;
+		if(rr == 0){
+			// this segment is a point
+			return this->intersects(s) ? T(0) : none;
+		}
+		if(cross(w, r) != 0){
+			return none;
+		}
+
+		// collinear segments, project the other segment onto this one
+		T t0 = (w * r) / rr;
+		T t1 = t0 + (q * r) / rr;
+
+		using std::min;
+		using std::max;
+		T lo = min(t0, t1);
+		T hi = max(t0, t1);
+		if(hi < 0 || lo > 1){
+			return none;
+		}
+		return max(lo, T(0));
+	}
+
+private:
+	// integer coordinates are extended to long long, so that cross products do not overflow
+	typedef std::conditional_t<std::is_integral_v<T>, long long, T> wide_type;
+
+	static wide_type cross(const vector2<T>& a, const vector2<T>& b)noexcept{
+		return wide_type(a.x()) * wide_type(b.y()) - wide_type(a.y()) * wide_type(b.x());
+	}
+
+	static bool within_box(const vector2<T>& a, const vector2<T>& b, const vector2<T>& c)noexcept{
+		using std::min;
+		using std::max;
+		return
+				c.x() >= min(a.x(), b.x()) && c.x() <= max(a.x(), b.x()) &&
+				c.y() >= min(a.y(), b.y()) && c.y() <= max(a.y(), b.y())
+			;
+	}
 };
 
 }
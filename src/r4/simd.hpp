@@ -0,0 +1,679 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+// SIMD instruction set selection.
+// Define R4_NO_SIMD before including any r4 header to force the scalar implementation.
+#if !defined(R4_NO_SIMD)
+#	if defined(__AVX__)
+#		define R4_SIMD_AVX
+#		define R4_SIMD_SSE2
+#	elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define R4_SIMD_SSE2
+#	elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#		define R4_SIMD_NEON
+#		if defined(__aarch64__) || defined(_M_ARM64)
+#			define R4_SIMD_NEON64
+#		endif
+#	endif
+#endif
+
+// Fused multiply-add instructions availability.
+// MSVC does not define __FMA__, but all CPUs supporting AVX2 also support FMA3.
+#if defined(R4_SIMD_AVX) && (defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#	define R4_SIMD_FMA
+#elif defined(R4_SIMD_NEON64)
+#	define R4_SIMD_FMA
+#endif
+
+#if defined(R4_SIMD_AVX)
+#	include <immintrin.h>
+#elif defined(R4_SIMD_SSE2)
+#	include <emmintrin.h>
+#elif defined(R4_SIMD_NEON)
+#	include <arm_neon.h>
+#endif
+
+namespace r4{
+namespace simd{
+
+/**
+ * @brief SIMD kernel for fixed size array of numbers.
+ * The kernel provides operations on a packed register holding S numbers of type T.
+ * The fma(a, b, c) operation calculates a * b + c, it is fused, i.e. with single rounding,
+ * only in case R4_SIMD_FMA is defined.
+ * The set(a, b, c, d) operation puts the numbers to the register lanes in the given order, i.e. 'a' goes to lane 0.
+ * The load_aligned(p) and store_aligned(p, a) operations require p to be aligned to S * sizeof(T) bytes,
+ * the load(p) and store(p, a) operations have no alignment requirement.
+ * The rsqrt(a) operation calculates approximate 1 / sqrt(a) for floats, with relative error below 2^-21,
+ * and exact one for doubles. The result for zero and denormal numbers is not specified.
+ * In case SIMD is not available for the given T and S, the kernel is disabled,
+ * i.e. the 'enabled' member is false, and the caller is supposed to use scalar implementation.
+ * @tparam T - type of the number.
+ * @tparam S - number of numbers in the packed register.
+ */
+template <typename T, size_t S> struct kernel{
+	static constexpr bool enabled = false;
+};
+
+#if defined(R4_SIMD_SSE2)
+
+template <> struct kernel<float, 4>{
+	static constexpr bool enabled = true;
+
+	typedef __m128 reg;
+
+	static reg load(const float* p)noexcept{
+		return _mm_loadu_ps(p);
+	}
+
+	static void store(float* p, reg a)noexcept{
+		_mm_storeu_ps(p, a);
+	}
+
+	static reg load_aligned(const float* p)noexcept{
+		return _mm_load_ps(p);
+	}
+
+	static void store_aligned(float* p, reg a)noexcept{
+		_mm_store_ps(p, a);
+	}
+
+	static reg set(float n)noexcept{
+		return _mm_set1_ps(n);
+	}
+
+	static reg set(float a, float b, float c, float d)noexcept{
+		return _mm_setr_ps(a, b, c, d);
+	}
+
+	static reg add(reg a, reg b)noexcept{
+		return _mm_add_ps(a, b);
+	}
+
+	static reg sub(reg a, reg b)noexcept{
+		return _mm_sub_ps(a, b);
+	}
+
+	static reg mul(reg a, reg b)noexcept{
+		return _mm_mul_ps(a, b);
+	}
+
+	static reg fma(reg a, reg b, reg c)noexcept{
+#	if defined(R4_SIMD_FMA)
+		return _mm_fmadd_ps(a, b, c);
+#	else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+#	endif
+	}
+
+	static reg div(reg a, reg b)noexcept{
+		return _mm_div_ps(a, b);
+	}
+
+	static reg sqrt(reg a)noexcept{
+		return _mm_sqrt_ps(a);
+	}
+
+	// approximate 1 / sqrt(a), hardware estimate refined by one Newton-Raphson step
+	static reg rsqrt(reg a)noexcept{
+		reg y = _mm_rsqrt_ps(a);
+		// y * (1.5 - 0.5 * a * y * y)
+		reg h = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(a, _mm_set1_ps(0.5f)), y), y);
+		return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), h));
+	}
+
+	// same semantics as std::min(a, b), i.e. (b < a) ? b : a
+	static reg min(reg a, reg b)noexcept{
+		return _mm_min_ps(b, a);
+	}
+
+	// same semantics as std::max(a, b), i.e. (a < b) ? b : a
+	static reg max(reg a, reg b)noexcept{
+		return _mm_max_ps(b, a);
+	}
+
+	// bit i of the result is set if a[i] < b[i]
+	static unsigned lt_mask(reg a, reg b)noexcept{
+		return unsigned(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+	}
+
+	static reg neg(reg a)noexcept{
+		return _mm_xor_ps(a, _mm_set1_ps(-0.0f));
+	}
+
+	static reg abs(reg a)noexcept{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+	}
+
+	// magnitude of a with sign of b
+	static reg copysign(reg a, reg b)noexcept{
+		__m128 m = _mm_set1_ps(-0.0f);
+		return _mm_or_ps(_mm_andnot_ps(m, a), _mm_and_ps(m, b));
+	}
+
+	// transpose 4x4 matrix given by rows
+	static void transpose(reg& r0, reg& r1, reg& r2, reg& r3)noexcept{
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	}
+
+	// sum of all components
+	static float hsum(reg a)noexcept{
+		// (x + z, y + w, ...)
+		reg s = _mm_add_ps(a, _mm_movehl_ps(a, a));
+		// (x + z + y + w, ...)
+		s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(s);
+	}
+};
+
+#	if defined(R4_SIMD_AVX)
+
+template <> struct kernel<double, 4>{
+	static constexpr bool enabled = true;
+
+	typedef __m256d reg;
+
+	static reg load(const double* p)noexcept{
+		return _mm256_loadu_pd(p);
+	}
+
+	static void store(double* p, reg a)noexcept{
+		_mm256_storeu_pd(p, a);
+	}
+
+	static reg load_aligned(const double* p)noexcept{
+		return _mm256_load_pd(p);
+	}
+
+	static void store_aligned(double* p, reg a)noexcept{
+		_mm256_store_pd(p, a);
+	}
+
+	static reg set(double n)noexcept{
+		return _mm256_set1_pd(n);
+	}
+
+	static reg set(double a, double b, double c, double d)noexcept{
+		return _mm256_setr_pd(a, b, c, d);
+	}
+
+	static reg add(reg a, reg b)noexcept{
+		return _mm256_add_pd(a, b);
+	}
+
+	static reg sub(reg a, reg b)noexcept{
+		return _mm256_sub_pd(a, b);
+	}
+
+	static reg mul(reg a, reg b)noexcept{
+		return _mm256_mul_pd(a, b);
+	}
+
+	static reg fma(reg a, reg b, reg c)noexcept{
+#		if defined(R4_SIMD_FMA)
+		return _mm256_fmadd_pd(a, b, c);
+#		else
+		return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#		endif
+	}
+
+	static reg div(reg a, reg b)noexcept{
+		return _mm256_div_pd(a, b);
+	}
+
+	static reg sqrt(reg a)noexcept{
+		return _mm256_sqrt_pd(a);
+	}
+
+	// there is no reciprocal square root estimate instruction for doubles
+	static reg rsqrt(reg a)noexcept{
+		return _mm256_div_pd(_mm256_set1_pd(1), _mm256_sqrt_pd(a));
+	}
+
+	static reg min(reg a, reg b)noexcept{
+		return _mm256_min_pd(b, a);
+	}
+
+	static reg max(reg a, reg b)noexcept{
+		return _mm256_max_pd(b, a);
+	}
+
+	static unsigned lt_mask(reg a, reg b)noexcept{
+		return unsigned(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+	}
+
+	static reg neg(reg a)noexcept{
+		return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+	}
+
+	static reg abs(reg a)noexcept{
+		return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+	}
+
+	static reg copysign(reg a, reg b)noexcept{
+		__m256d m = _mm256_set1_pd(-0.0);
+		return _mm256_or_pd(_mm256_andnot_pd(m, a), _mm256_and_pd(m, b));
+	}
+
+	static void transpose(reg& r0, reg& r1, reg& r2, reg& r3)noexcept{
+		reg t0 = _mm256_unpacklo_pd(r0, r1);
+		reg t1 = _mm256_unpackhi_pd(r0, r1);
+		reg t2 = _mm256_unpacklo_pd(r2, r3);
+		reg t3 = _mm256_unpackhi_pd(r2, r3);
+		r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+		r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+		r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+		r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+	}
+
+	static double hsum(reg a)noexcept{
+		__m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+		s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+		return _mm_cvtsd_f64(s);
+	}
+};
+
+#	else
+
+// SSE2 registers hold only two doubles, so use a pair of registers
+template <> struct kernel<double, 4>{
+	static constexpr bool enabled = true;
+
+	struct reg{
+		__m128d lo;
+		__m128d hi;
+	};
+
+	static reg load(const double* p)noexcept{
+		return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)};
+	}
+
+	static void store(double* p, reg a)noexcept{
+		_mm_storeu_pd(p, a.lo);
+		_mm_storeu_pd(p + 2, a.hi);
+	}
+
+	static reg load_aligned(const double* p)noexcept{
+		return {_mm_load_pd(p), _mm_load_pd(p + 2)};
+	}
+
+	static void store_aligned(double* p, reg a)noexcept{
+		_mm_store_pd(p, a.lo);
+		_mm_store_pd(p + 2, a.hi);
+	}
+
+	static reg set(double n)noexcept{
+		__m128d v = _mm_set1_pd(n);
+		return {v, v};
+	}
+
+	static reg set(double a, double b, double c, double d)noexcept{
+		return {_mm_setr_pd(a, b), _mm_setr_pd(c, d)};
+	}
+
+	static reg add(reg a, reg b)noexcept{
+		return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)};
+	}
+
+	static reg sub(reg a, reg b)noexcept{
+		return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)};
+	}
+
+	static reg mul(reg a, reg b)noexcept{
+		return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)};
+	}
+
+	static reg fma(reg a, reg b, reg c)noexcept{
+		return add(mul(a, b), c);
+	}
+
+	static reg div(reg a, reg b)noexcept{
+		return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)};
+	}
+
+	static reg sqrt(reg a)noexcept{
+		return {_mm_sqrt_pd(a.lo), _mm_sqrt_pd(a.hi)};
+	}
+
+	static reg rsqrt(reg a)noexcept{
+		return div(set(1), sqrt(a));
+	}
+
+	static reg min(reg a, reg b)noexcept{
+		return {_mm_min_pd(b.lo, a.lo), _mm_min_pd(b.hi, a.hi)};
+	}
+
+	static reg max(reg a, reg b)noexcept{
+		return {_mm_max_pd(b.lo, a.lo), _mm_max_pd(b.hi, a.hi)};
+	}
+
+	static unsigned lt_mask(reg a, reg b)noexcept{
+		return unsigned(_mm_movemask_pd(_mm_cmplt_pd(a.lo, b.lo)) | (_mm_movemask_pd(_mm_cmplt_pd(a.hi, b.hi)) << 2));
+	}
+
+	static reg neg(reg a)noexcept{
+		__m128d m = _mm_set1_pd(-0.0);
+		return {_mm_xor_pd(a.lo, m), _mm_xor_pd(a.hi, m)};
+	}
+
+	static reg abs(reg a)noexcept{
+		__m128d m = _mm_set1_pd(-0.0);
+		return {_mm_andnot_pd(m, a.lo), _mm_andnot_pd(m, a.hi)};
+	}
+
+	static reg copysign(reg a, reg b)noexcept{
+		__m128d m = _mm_set1_pd(-0.0);
+		return {
+				_mm_or_pd(_mm_andnot_pd(m, a.lo), _mm_and_pd(m, b.lo)),
+				_mm_or_pd(_mm_andnot_pd(m, a.hi), _mm_and_pd(m, b.hi))
+			};
+	}
+
+	static void transpose(reg& r0, reg& r1, reg& r2, reg& r3)noexcept{
+		reg t0 = {_mm_unpacklo_pd(r0.lo, r1.lo), _mm_unpacklo_pd(r2.lo, r3.lo)};
+		reg t1 = {_mm_unpackhi_pd(r0.lo, r1.lo), _mm_unpackhi_pd(r2.lo, r3.lo)};
+		reg t2 = {_mm_unpacklo_pd(r0.hi, r1.hi), _mm_unpacklo_pd(r2.hi, r3.hi)};
+		reg t3 = {_mm_unpackhi_pd(r0.hi, r1.hi), _mm_unpackhi_pd(r2.hi, r3.hi)};
+		r0 = t0;
+		r1 = t1;
+		r2 = t2;
+		r3 = t3;
+	}
+
+	static double hsum(reg a)noexcept{
+		__m128d s = _mm_add_pd(a.lo, a.hi);
+		s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+		return _mm_cvtsd_f64(s);
+	}
+};
+
+#	endif
+
+#elif defined(R4_SIMD_NEON)
+
+template <> struct kernel<float, 4>{
+	static constexpr bool enabled = true;
+
+	typedef float32x4_t reg;
+
+	static reg load(const float* p)noexcept{
+		return vld1q_f32(p);
+	}
+
+	static void store(float* p, reg a)noexcept{
+		vst1q_f32(p, a);
+	}
+
+	// NEON loads and stores have no separate aligned variants
+	static reg load_aligned(const float* p)noexcept{
+		return load(p);
+	}
+
+	static void store_aligned(float* p, reg a)noexcept{
+		store(p, a);
+	}
+
+	static reg set(float n)noexcept{
+		return vdupq_n_f32(n);
+	}
+
+	static reg set(float a, float b, float c, float d)noexcept{
+		const float p[] = {a, b, c, d};
+		return vld1q_f32(p);
+	}
+
+	static reg add(reg a, reg b)noexcept{
+		return vaddq_f32(a, b);
+	}
+
+	static reg sub(reg a, reg b)noexcept{
+		return vsubq_f32(a, b);
+	}
+
+	static reg mul(reg a, reg b)noexcept{
+		return vmulq_f32(a, b);
+	}
+
+	static reg fma(reg a, reg b, reg c)noexcept{
+#	if defined(R4_SIMD_FMA)
+		return vfmaq_f32(c, a, b);
+#	else
+		// ARMv7 NEON multiply-accumulate is not fused, so keep the separate operations
+		return vaddq_f32(vmulq_f32(a, b), c);
+#	endif
+	}
+
+	static reg div(reg a, reg b)noexcept{
+#	if defined(R4_SIMD_NEON64)
+		return vdivq_f32(a, b);
+#	else
+		// ARMv7 NEON has no division instruction
+		float pa[4];
+		float pb[4];
+		vst1q_f32(pa, a);
+		vst1q_f32(pb, b);
+		for(size_t i = 0; i != 4; ++i){
+			pa[i] /= pb[i];
+		}
+		return vld1q_f32(pa);
+#	endif
+	}
+
+	static reg sqrt(reg a)noexcept{
+#	if defined(R4_SIMD_NEON64)
+		return vsqrtq_f32(a);
+#	else
+		// ARMv7 NEON has no square root instruction
+		float pa[4];
+		vst1q_f32(pa, a);
+		for(size_t i = 0; i != 4; ++i){
+			pa[i] = std::sqrt(pa[i]);
+		}
+		return vld1q_f32(pa);
+#	endif
+	}
+
+	static reg min(reg a, reg b)noexcept{
+		return vbslq_f32(vcltq_f32(b, a), b, a);
+	}
+
+	// approximate 1 / sqrt(a), NEON estimate is less precise than SSE one, so two Newton-Raphson steps are done
+	static reg rsqrt(reg a)noexcept{
+		reg y = vrsqrteq_f32(a);
+		y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+		return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+	}
+
+	static reg max(reg a, reg b)noexcept{
+		return vbslq_f32(vcltq_f32(a, b), b, a);
+	}
+
+	static unsigned lt_mask(reg a, reg b)noexcept{
+		const uint32_t bits[] = {1, 2, 4, 8};
+		uint32x4_t m = vandq_u32(vcltq_f32(a, b), vld1q_u32(bits));
+#	if defined(R4_SIMD_NEON64)
+		return vaddvq_u32(m);
+#	else
+		uint32x2_t s = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+		return vget_lane_u32(vpadd_u32(s, s), 0);
+#	endif
+	}
+
+	static reg neg(reg a)noexcept{
+		return vnegq_f32(a);
+	}
+
+	static reg abs(reg a)noexcept{
+		return vabsq_f32(a);
+	}
+
+	static reg copysign(reg a, reg b)noexcept{
+		return vbslq_f32(vdupq_n_u32(0x80000000), b, a);
+	}
+
+	static void transpose(reg& r0, reg& r1, reg& r2, reg& r3)noexcept{
+		float32x4x2_t t01 = vtrnq_f32(r0, r1);
+		float32x4x2_t t23 = vtrnq_f32(r2, r3);
+		r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+	}
+
+	static float hsum(reg a)noexcept{
+		float32x2_t s = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+		return vget_lane_f32(vpadd_f32(s, s), 0);
+	}
+};
+
+#	if defined(R4_SIMD_NEON64)
+
+template <> struct kernel<double, 4>{
+	static constexpr bool enabled = true;
+
+	struct reg{
+		float64x2_t lo;
+		float64x2_t hi;
+	};
+
+	static reg load(const double* p)noexcept{
+		return {vld1q_f64(p), vld1q_f64(p + 2)};
+	}
+
+	static void store(double* p, reg a)noexcept{
+		vst1q_f64(p, a.lo);
+		vst1q_f64(p + 2, a.hi);
+	}
+
+	static reg load_aligned(const double* p)noexcept{
+		return load(p);
+	}
+
+	static void store_aligned(double* p, reg a)noexcept{
+		store(p, a);
+	}
+
+	static reg set(double n)noexcept{
+		float64x2_t v = vdupq_n_f64(n);
+		return {v, v};
+	}
+
+	static reg set(double a, double b, double c, double d)noexcept{
+		const double p[] = {a, b, c, d};
+		return {vld1q_f64(p), vld1q_f64(p + 2)};
+	}
+
+	static reg add(reg a, reg b)noexcept{
+		return {vaddq_f64(a.lo, b.lo), vaddq_f64(a.hi, b.hi)};
+	}
+
+	static reg sub(reg a, reg b)noexcept{
+		return {vsubq_f64(a.lo, b.lo), vsubq_f64(a.hi, b.hi)};
+	}
+
+	static reg mul(reg a, reg b)noexcept{
+		return {vmulq_f64(a.lo, b.lo), vmulq_f64(a.hi, b.hi)};
+	}
+
+	static reg fma(reg a, reg b, reg c)noexcept{
+		return {vfmaq_f64(c.lo, a.lo, b.lo), vfmaq_f64(c.hi, a.hi, b.hi)};
+	}
+
+	static reg div(reg a, reg b)noexcept{
+		return {vdivq_f64(a.lo, b.lo), vdivq_f64(a.hi, b.hi)};
+	}
+
+	static reg sqrt(reg a)noexcept{
+		return {vsqrtq_f64(a.lo), vsqrtq_f64(a.hi)};
+	}
+
+	static reg rsqrt(reg a)noexcept{
+		return div(set(1), sqrt(a));
+	}
+
+	static reg min(reg a, reg b)noexcept{
+		return {
+				vbslq_f64(vcltq_f64(b.lo, a.lo), b.lo, a.lo),
+				vbslq_f64(vcltq_f64(b.hi, a.hi), b.hi, a.hi)
+			};
+	}
+
+	static reg max(reg a, reg b)noexcept{
+		return {
+				vbslq_f64(vcltq_f64(a.lo, b.lo), b.lo, a.lo),
+				vbslq_f64(vcltq_f64(a.hi, b.hi), b.hi, a.hi)
+			};
+	}
+
+	static unsigned lt_mask(reg a, reg b)noexcept{
+		uint64x2_t lo = vcltq_f64(a.lo, b.lo);
+		uint64x2_t hi = vcltq_f64(a.hi, b.hi);
+		return unsigned(
+				(vgetq_lane_u64(lo, 0) & 1) | (vgetq_lane_u64(lo, 1) & 2) |
+				(vgetq_lane_u64(hi, 0) & 4) | (vgetq_lane_u64(hi, 1) & 8)
+			);
+	}
+
+	static reg neg(reg a)noexcept{
+		return {vnegq_f64(a.lo), vnegq_f64(a.hi)};
+	}
+
+	static reg abs(reg a)noexcept{
+		return {vabsq_f64(a.lo), vabsq_f64(a.hi)};
+	}
+
+	static reg copysign(reg a, reg b)noexcept{
+		uint64x2_t m = vdupq_n_u64(0x8000000000000000ull);
+		return {vbslq_f64(m, b.lo, a.lo), vbslq_f64(m, b.hi, a.hi)};
+	}
+
+	static void transpose(reg& r0, reg& r1, reg& r2, reg& r3)noexcept{
+		reg t0 = {vzip1q_f64(r0.lo, r1.lo), vzip1q_f64(r2.lo, r3.lo)};
+		reg t1 = {vzip2q_f64(r0.lo, r1.lo), vzip2q_f64(r2.lo, r3.lo)};
+		reg t2 = {vzip1q_f64(r0.hi, r1.hi), vzip1q_f64(r2.hi, r3.hi)};
+		reg t3 = {vzip2q_f64(r0.hi, r1.hi), vzip2q_f64(r2.hi, r3.hi)};
+		r0 = t0;
+		r1 = t1;
+		r2 = t2;
+		r3 = t3;
+	}
+
+	static double hsum(reg a)noexcept{
+		return vaddvq_f64(vaddq_f64(a.lo, a.hi));
+	}
+};
+
+#	endif
+
+#endif
+
+}
+}
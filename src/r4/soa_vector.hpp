@@ -0,0 +1,781 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <new>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "matrix.hpp"
+#include "simd.hpp"
+
+// Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
+#ifdef min
+#	undef min
+#endif
+#ifdef max
+#	undef max
+#endif
+
+namespace r4{
+
+/**
+ * @brief Structure-of-arrays container of vectors.
+ * Stores a sequence of S-component vectors, but instead of storing vectors one after another,
+ * each vector component is stored in its own contiguous array. I.e. all x components go first,
+ * then all y components and so on. Each component array is aligned to the cache line boundary
+ * and is padded up to the multiple of cache line size, so that bulk operations can process the
+ * component arrays with full width SIMD loads and stores.
+ * Elements are accessed through proxy objects which behave like r4::vector<T, S>.
+ * @tparam T - type of vector component.
+ * @tparam S - number of vector components.
+ */
+template <typename T, size_t S> class soa_vector{
+	static_assert(S > 0, "vector size template parameter S must be above zero");
+	static_assert(std::is_trivially_copyable_v<T>, "vector component type must be trivially copyable");
+
+public:
+	/**
+	 * @brief Alignment of each component array in bytes.
+	 */
+	static constexpr size_t alignment = 64;
+
+private:
+	static_assert(alignment % sizeof(T) == 0, "size of vector component type must divide the alignment");
+
+	// number of elements in one aligned block of component array
+	static constexpr size_t block_size = alignment / sizeof(T);
+
+	typedef simd::kernel<T, 4> simd_kernel;
+
+	// number of elements processed at once by bulk operations
+	static constexpr size_t lanes = simd_kernel::enabled ? 4 : 1;
+
+	static_assert(block_size % lanes == 0, "");
+
+	T* buf = nullptr;
+	size_t num_elements = 0;
+
+	// number of elements allocated for each component array, always multiple of block_size
+	size_t cap = 0;
+
+	static size_t padded(size_t n)noexcept{
+		return (n + block_size - 1) / block_size * block_size;
+	}
+
+	static T* allocate(size_t n){
+		return static_cast<T*>(::operator new(n * S * sizeof(T), std::align_val_t(alignment)));
+	}
+
+	static void deallocate(T* p)noexcept{
+		if(p){
+			::operator delete(p, std::align_val_t(alignment));
+		}
+	}
+
+	void realloc(size_t new_cap){
+		ASSERT(new_cap % block_size == 0)
+		ASSERT(new_cap >= this->num_elements)
+		T* new_buf = allocate(new_cap);
+		for(size_t c = 0; c != S; ++c){
+			if(this->num_elements != 0){
+				std::memcpy(new_buf + c * new_cap, this->data(c), this->num_elements * sizeof(T));
+			}
+		}
+		deallocate(this->buf);
+		this->buf = new_buf;
+		this->cap = new_cap;
+	}
+
+	// fill elements from given index up to the end of the padded component arrays with zeros
+	void zero_tail(size_t from)noexcept{
+		for(size_t c = 0; c != S; ++c){
+			std::fill(this->data(c) + from, this->data(c) + this->cap, T(0));
+		}
+	}
+
+public:
+	/**
+	 * @brief Proxy referencing an element of the soa_vector.
+	 * The proxy behaves like a reference to r4::vector<T, S>.
+	 */
+	class reference{
+		friend class soa_vector;
+
+		T* p;
+		size_t stride;
+
+		reference(T* p, size_t stride)noexcept :
+				p(p),
+				stride(stride)
+		{}
+	public:
+		reference(const reference&) = default;
+
+		/**
+		 * @brief Assign vector value to the referenced element.
+		 * @param v - vector to assign.
+		 * @return reference to this proxy.
+		 */
+		reference& operator=(const vector<T, S>& v)noexcept{
+			for(size_t c = 0; c != S; ++c){
+				(*this)[c] = v[c];
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Assign value of another element.
+		 * Note, that it assigns the element value, not rebinds the proxy.
+		 * @param r - element to assign value of.
+		 * @return reference to this proxy.
+		 */
+		reference& operator=(const reference& r)noexcept{
+			return this->operator=(vector<T, S>(r));
+		}
+
+		/**
+		 * @brief Get vector value of the referenced element.
+		 */
+		operator vector<T, S>()const noexcept{
+			vector<T, S> ret;
+			for(size_t c = 0; c != S; ++c){
+				ret[c] = (*this)[c];
+			}
+			return ret;
+		}
+
+		/**
+		 * @brief Get vector component.
+		 * @param c - index of the component.
+		 * @return reference to the vector component.
+		 */
+		T& operator[](size_t c)const noexcept{
+			ASSERT(c < S)
+			return this->p[c * this->stride];
+		}
+
+		/**
+		 * @brief First vector component.
+		 */
+		T& x()const noexcept{
+			return (*this)[0];
+		}
+
+		/**
+		 * @brief Second vector component.
+		 */
+		template <typename E = T>
+		std::enable_if_t<(S > 1), E&> y()const noexcept{
+			return (*this)[1];
+		}
+
+		/**
+		 * @brief Third vector component.
+		 */
+		template <typename E = T>
+		std::enable_if_t<(S > 2), E&> z()const noexcept{
+			return (*this)[2];
+		}
+
+		/**
+		 * @brief Fourth vector component.
+		 */
+		template <typename E = T>
+		std::enable_if_t<(S > 3), E&> w()const noexcept{
+			return (*this)[3];
+		}
+
+		/**
+		 * @brief Add and assign.
+		 * @param v - vector to add.
+		 * @return reference to this proxy.
+		 */
+		reference& operator+=(const vector<T, S>& v)noexcept{
+			for(size_t c = 0; c != S; ++c){
+				(*this)[c] += v[c];
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Subtract and assign.
+		 * @param v - vector to subtract.
+		 * @return reference to this proxy.
+		 */
+		reference& operator-=(const vector<T, S>& v)noexcept{
+			for(size_t c = 0; c != S; ++c){
+				(*this)[c] -= v[c];
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Multiply by scalar and assign.
+		 * @param num - scalar to multiply by.
+		 * @return reference to this proxy.
+		 */
+		reference& operator*=(T num)noexcept{
+			for(size_t c = 0; c != S; ++c){
+				(*this)[c] *= num;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Divide by scalar and assign.
+		 * @param num - scalar to divide by.
+		 * @return reference to this proxy.
+		 */
+		reference& operator/=(T num)noexcept{
+			ASSERT_INFO(num != 0, "soa_vector::reference::operator/=(): division by 0")
+			for(size_t c = 0; c != S; ++c){
+				(*this)[c] /= num;
+			}
+			return *this;
+		}
+
+		/**
+		 * @brief Calculate power 2 of vector norm.
+		 * @return Power 2 of the referenced vector norm.
+		 */
+		T norm_pow2()const noexcept{
+			return vector<T, S>(*this).norm_pow2();
+		}
+
+		/**
+		 * @brief Calculate vector norm.
+		 * @return Norm of the referenced vector.
+		 */
+		T norm()const noexcept{
+			return vector<T, S>(*this).norm();
+		}
+
+		bool operator==(const vector<T, S>& v)const noexcept{
+			return vector<T, S>(*this) == v;
+		}
+
+		friend std::ostream& operator<<(std::ostream& s, const reference& r){
+			return s << vector<T, S>(r);
+		}
+	};
+
+	/**
+	 * @brief Create empty container.
+	 */
+	soa_vector() = default;
+
+	/**
+	 * @brief Create container of given size.
+	 * All elements are initialized to zero vectors.
+	 * @param size - number of elements.
+	 */
+	explicit soa_vector(size_t size){
+		this->resize(size);
+	}
+
+	/**
+	 * @brief Create container from array of vectors.
+	 * @param vecs - vectors to initialize the container with.
+	 */
+	explicit soa_vector(utki::span<const vector<T, S>> vecs){
+		this->reserve(vecs.size());
+		for(const auto& v : vecs){
+			this->push_back(v);
+		}
+	}
+
+	soa_vector(const soa_vector& v){
+		this->operator=(v);
+	}
+
+	soa_vector(soa_vector&& v)noexcept{
+		this->operator=(std::move(v));
+	}
+
+	soa_vector& operator=(const soa_vector& v){
+		if(this == &v){
+			return *this;
+		}
+		if(this->cap < v.size()){
+			deallocate(this->buf);
+			this->buf = nullptr;
+			this->cap = 0;
+			this->num_elements = 0;
+			this->realloc(padded(v.size()));
+		}
+		this->num_elements = v.size();
+		for(size_t c = 0; c != S; ++c){
+			if(this->num_elements != 0){
+				std::memcpy(this->data(c), v.data(c), this->num_elements * sizeof(T));
+			}
+		}
+		this->zero_tail(this->num_elements);
+		return *this;
+	}
+
+	soa_vector& operator=(soa_vector&& v)noexcept{
+		std::swap(this->buf, v.buf);
+		std::swap(this->num_elements, v.num_elements);
+		std::swap(this->cap, v.cap);
+		return *this;
+	}
+
+	~soa_vector()noexcept{
+		deallocate(this->buf);
+	}
+
+	/**
+	 * @brief Get number of elements.
+	 * @return number of elements in the container.
+	 */
+	size_t size()const noexcept{
+		return this->num_elements;
+	}
+
+	/**
+	 * @brief Check if the container is empty.
+	 * @return true if the container has no elements.
+	 * @return false otherwise.
+	 */
+	bool empty()const noexcept{
+		return this->num_elements == 0;
+	}
+
+	/**
+	 * @brief Get number of elements the container can hold without reallocation.
+	 * @return capacity of the container.
+	 */
+	size_t capacity()const noexcept{
+		return this->cap;
+	}
+
+	/**
+	 * @brief Reserve memory for given number of elements.
+	 * @param size - number of elements to reserve memory for.
+	 */
+	void reserve(size_t size){
+		if(size <= this->cap){
+			return;
+		}
+		this->realloc(padded(size));
+		this->zero_tail(this->num_elements);
+	}
+
+	/**
+	 * @brief Change number of elements.
+	 * Added elements are initialized to zero vectors.
+	 * @param size - new number of elements.
+	 */
+	void resize(size_t size){
+		this->reserve(size);
+		if(size < this->num_elements){
+			this->num_elements = size;
+			this->zero_tail(size);
+		}
+		this->num_elements = size;
+	}
+
+	/**
+	 * @brief Remove all elements.
+	 */
+	void clear()noexcept{
+		this->zero_tail(0);
+		this->num_elements = 0;
+	}
+
+	/**
+	 * @brief Append element.
+	 * @param v - vector to append.
+	 */
+	void push_back(const vector<T, S>& v){
+		if(this->num_elements == this->cap){
+			this->reserve(std::max(this->cap * 2, block_size));
+		}
+		++this->num_elements;
+		this->operator[](this->num_elements - 1) = v;
+	}
+
+	/**
+	 * @brief Access element.
+	 * @param i - index of the element.
+	 * @return proxy referencing the element.
+	 */
+	reference operator[](size_t i)noexcept{
+		ASSERT(i < this->size())
+		return reference(this->buf + i, this->cap);
+	}
+
+	/**
+	 * @brief Get element.
+	 * @param i - index of the element.
+	 * @return value of the element.
+	 */
+	vector<T, S> operator[](size_t i)const noexcept{
+		ASSERT(i < this->size())
+		vector<T, S> ret;
+		for(size_t c = 0; c != S; ++c){
+			ret[c] = this->data(c)[i];
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Get component array.
+	 * The array is aligned to the 'alignment' boundary.
+	 * @param c - index of the vector component.
+	 * @return pointer to the first element of the component array.
+	 */
+	T* data(size_t c)noexcept{
+		ASSERT(c < S)
+		return this->buf + c * this->cap;
+	}
+
+	/**
+	 * @brief Get component array.
+	 * The array is aligned to the 'alignment' boundary.
+	 * @param c - index of the vector component.
+	 * @return pointer to the first element of the component array.
+	 */
+	const T* data(size_t c)const noexcept{
+		ASSERT(c < S)
+		return this->buf + c * this->cap;
+	}
+
+	/**
+	 * @brief Get component array.
+	 * @param c - index of the vector component.
+	 * @return span of the component array.
+	 */
+	utki::span<T> component(size_t c)noexcept{
+		return utki::make_span(this->data(c), this->size());
+	}
+
+	/**
+	 * @brief Get component array.
+	 * @param c - index of the vector component.
+	 * @return span of the component array.
+	 */
+	utki::span<const T> component(size_t c)const noexcept{
+		return utki::make_span(this->data(c), this->size());
+	}
+
+	/**
+	 * @brief Add and assign.
+	 * Adds elements of the given container to the elements of this container.
+	 * @param v - container to add, must be of the same size as this container.
+	 * @return reference to this container.
+	 */
+	soa_vector& operator+=(const soa_vector& v)noexcept{
+		ASSERT(v.size() == this->size())
+		for(size_t c = 0; c != S; ++c){
+			this->apply(c, [](auto k, auto a, auto b){return decltype(k)::add(a, b);}, [](T a, T b){return a + b;}, v.data(c));
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Subtract and assign.
+	 * Subtracts elements of the given container from the elements of this container.
+	 * @param v - container to subtract, must be of the same size as this container.
+	 * @return reference to this container.
+	 */
+	soa_vector& operator-=(const soa_vector& v)noexcept{
+		ASSERT(v.size() == this->size())
+		for(size_t c = 0; c != S; ++c){
+			this->apply(c, [](auto k, auto a, auto b){return decltype(k)::sub(a, b);}, [](T a, T b){return a - b;}, v.data(c));
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Add vector to each element.
+	 * @param vec - vector to add.
+	 * @return reference to this container.
+	 */
+	soa_vector& operator+=(const vector<T, S>& vec)noexcept{
+		for(size_t c = 0; c != S; ++c){
+			T n = vec[c];
+			this->apply(c, [n](auto k, auto a){return decltype(k)::add(a, decltype(k)::set(n));}, [n](T a){return a + n;});
+		}
+		// adding to the zero padding makes it non-zero, restore zeros
+		this->zero_tail(this->size());
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply each element by scalar.
+	 * @param num - scalar to multiply by.
+	 * @return reference to this container.
+	 */
+	soa_vector& operator*=(T num)noexcept{
+		for(size_t c = 0; c != S; ++c){
+			this->apply(c, [num](auto k, auto a){return decltype(k)::mul(a, decltype(k)::set(num));}, [num](T a){return a * num;});
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Component-wise multiplication of each element.
+	 * Performs component-wise multiplication of each element by given vector.
+	 * @param vec - vector to multiply by.
+	 * @return reference to this container.
+	 */
+	soa_vector& comp_multiply(const vector<T, S>& vec)noexcept{
+		for(size_t c = 0; c != S; ++c){
+			T n = vec[c];
+			this->apply(c, [n](auto k, auto a){return decltype(k)::mul(a, decltype(k)::set(n));}, [n](T a){return a * n;});
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Normalize each element.
+	 * Elements with zero norm are set to vector (1, 0, 0, ...), same as vector::normalize() does.
+	 * @return reference to this container.
+	 */
+	soa_vector& normalize()noexcept{
+		for(size_t i = 0; i < this->size(); i += lanes){
+			if constexpr (simd_kernel::enabled){
+				typename simd_kernel::reg comps[S];
+				auto n2 = simd_kernel::set(T(0));
+				for(size_t c = 0; c != S; ++c){
+					comps[c] = simd_kernel::load_aligned(this->data(c) + i);
+					n2 = simd_kernel::fma(comps[c], comps[c], n2);
+				}
+				auto norm = simd_kernel::sqrt(n2);
+				for(size_t c = 0; c != S; ++c){
+					simd_kernel::store_aligned(this->data(c) + i, simd_kernel::div(comps[c], norm));
+				}
+				T norms[lanes];
+				simd_kernel::store(norms, n2);
+				for(size_t j = 0; j != lanes; ++j){
+					if(norms[j] == 0){
+						this->set_unit_x(i + j);
+					}
+				}
+			}else{
+				using std::sqrt;
+				T n2 = 0;
+				for(size_t c = 0; c != S; ++c){
+					n2 += utki::pow2(this->data(c)[i]);
+				}
+				if(n2 == 0){
+					this->set_unit_x(i);
+					continue;
+				}
+				T norm = sqrt(n2);
+				for(size_t c = 0; c != S; ++c){
+					this->data(c)[i] /= norm;
+				}
+			}
+		}
+		// normalization of the zero padding produces (1, 0, ...) vectors, restore zeros
+		this->zero_tail(this->size());
+		return *this;
+	}
+
+	/**
+	 * @brief Transform each element by matrix.
+	 * Multiplies each element by the given matrix from the left (M * V).
+	 * Defined only for 3 and 4 component vectors. 3 component vectors are treated as points,
+	 * i.e. as 4 component vectors with w = 1, and after the transformation the w component is discarded.
+	 * @param m - transformation matrix.
+	 * @return reference to this container.
+	 */
+	template <typename E = T>
+	soa_vector& transform(const matrix<std::enable_if_t<S == 3 || S == 4, E>, 4, 4>& m)noexcept{
+		for(size_t i = 0; i < this->size(); i += lanes){
+			if constexpr (simd_kernel::enabled){
+				typename simd_kernel::reg comps[S];
+				for(size_t c = 0; c != S; ++c){
+					comps[c] = simd_kernel::load_aligned(this->data(c) + i);
+				}
+				for(size_t r = 0; r != S; ++r){
+					auto res = simd_kernel::set(S == 3 ? m[r][3] : T(0));
+					for(size_t c = 0; c != S; ++c){
+						res = simd_kernel::fma(simd_kernel::set(m[r][c]), comps[c], res);
+					}
+					simd_kernel::store_aligned(this->data(r) + i, res);
+				}
+			}else{
+				vector<T, 4> v;
+				for(size_t c = 0; c != S; ++c){
+					v[c] = this->data(c)[i];
+				}
+				if constexpr (S == 3){
+					v[3] = T(1);
+				}
+				v = m * v;
+				for(size_t c = 0; c != S; ++c){
+					this->data(c)[i] = v[c];
+				}
+			}
+		}
+		if constexpr (S == 3){
+			// translation part of the matrix has been added to the padding
+			this->zero_tail(this->size());
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Calculate dot products of elements.
+	 * @param a - first container.
+	 * @param b - second container, must be of the same size as the first one.
+	 * @param out - span to store dot products to, must be of the same size as the containers.
+	 */
+	friend void dot(const soa_vector& a, const soa_vector& b, utki::span<T> out)noexcept{
+		ASSERT(a.size() == b.size())
+		ASSERT(out.size() == a.size())
+		size_t i = 0;
+		if constexpr (simd_kernel::enabled){
+			for(; i + lanes <= a.size(); i += lanes){
+				auto res = simd_kernel::set(T(0));
+				for(size_t c = 0; c != S; ++c){
+					res = simd_kernel::fma(simd_kernel::load_aligned(a.data(c) + i), simd_kernel::load_aligned(b.data(c) + i), res);
+				}
+				simd_kernel::store(out.data() + i, res);
+			}
+		}
+		for(; i < a.size(); ++i){
+			T res = 0;
+			for(size_t c = 0; c != S; ++c){
+				res = internal::mul_add(a.data(c)[i], b.data(c)[i], res);
+			}
+			out[i] = res;
+		}
+	}
+
+	/**
+	 * @brief Calculate cross products of elements.
+	 * Defined only for 3 component vectors.
+	 * @param a - first container.
+	 * @param b - second container, must be of the same size as the first one.
+	 * @return container of cross products a[i] % b[i].
+	 */
+	template <typename E = soa_vector>
+	friend std::enable_if_t<S == 3, E> cross(const soa_vector& a, const soa_vector& b){
+		ASSERT(a.size() == b.size())
+		soa_vector ret(a.size());
+		for(size_t i = 0; i < a.size(); i += lanes){
+			if constexpr (simd_kernel::enabled){
+				auto ax = simd_kernel::load_aligned(a.data(0) + i);
+				auto ay = simd_kernel::load_aligned(a.data(1) + i);
+				auto az = simd_kernel::load_aligned(a.data(2) + i);
+				auto bx = simd_kernel::load_aligned(b.data(0) + i);
+				auto by = simd_kernel::load_aligned(b.data(1) + i);
+				auto bz = simd_kernel::load_aligned(b.data(2) + i);
+				simd_kernel::store_aligned(ret.data(0) + i, simd_kernel::sub(simd_kernel::mul(ay, bz), simd_kernel::mul(az, by)));
+				simd_kernel::store_aligned(ret.data(1) + i, simd_kernel::sub(simd_kernel::mul(az, bx), simd_kernel::mul(ax, bz)));
+				simd_kernel::store_aligned(ret.data(2) + i, simd_kernel::sub(simd_kernel::mul(ax, by), simd_kernel::mul(ay, bx)));
+			}else{
+				ret[i] = a[i] % b[i];
+			}
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Get component-wise minimum of all elements.
+	 * The container must not be empty.
+	 * @return vector whose components are minimal values of corresponding components among all elements.
+	 */
+	vector<T, S> min()const noexcept{
+		return this->reduce([](auto k, auto a, auto b){return decltype(k)::min(a, b);}, [](T a, T b){using std::min; return min(a, b);});
+	}
+
+	/**
+	 * @brief Get component-wise maximum of all elements.
+	 * The container must not be empty.
+	 * @return vector whose components are maximal values of corresponding components among all elements.
+	 */
+	vector<T, S> max()const noexcept{
+		return this->reduce([](auto k, auto a, auto b){return decltype(k)::max(a, b);}, [](T a, T b){using std::max; return max(a, b);});
+	}
+
+private:
+	void set_unit_x(size_t i)noexcept{
+		this->data(0)[i] = T(1);
+		for(size_t c = 1; c != S; ++c){
+			this->data(c)[i] = T(0);
+		}
+	}
+
+	// Apply operation to each element of the component array, the operation is applied to the padding as well.
+	// The simd_op is applied to packed registers and scalar_op is applied when SIMD is not available.
+	// The simd_op receives the SIMD kernel object as first argument, so that the kernel functions it calls are
+	// only looked up when SIMD is enabled.
+	template <typename simd_op_type, typename scalar_op_type, typename... A>
+	void apply(size_t c, simd_op_type simd_op, scalar_op_type scalar_op, const A*... args)noexcept{
+		T* p = this->data(c);
+		size_t end = padded(this->size());
+		if constexpr (simd_kernel::enabled){
+			for(size_t i = 0; i != end; i += lanes){
+				simd_kernel::store_aligned(p + i, simd_op(simd_kernel(), simd_kernel::load_aligned(p + i), simd_kernel::load_aligned(args + i)...));
+			}
+		}else{
+			for(size_t i = 0; i != end; ++i){
+				p[i] = scalar_op(p[i], args[i]...);
+			}
+		}
+	}
+
+	template <typename simd_op_type, typename scalar_op_type>
+	vector<T, S> reduce(simd_op_type simd_op, scalar_op_type scalar_op)const noexcept{
+		ASSERT(!this->empty())
+		vector<T, S> ret;
+		for(size_t c = 0; c != S; ++c){
+			const T* p = this->data(c);
+			T res = p[0];
+			size_t i = 0;
+			if constexpr (simd_kernel::enabled){
+				if(this->size() >= lanes){
+					auto acc = simd_kernel::load_aligned(p);
+					for(i = lanes; i + lanes <= this->size(); i += lanes){
+						acc = simd_op(simd_kernel(), acc, simd_kernel::load_aligned(p + i));
+					}
+					T packed[lanes];
+					simd_kernel::store(packed, acc);
+					for(size_t j = 0; j != lanes; ++j){
+						res = scalar_op(res, packed[j]);
+					}
+				}
+			}
+			for(; i < this->size(); ++i){
+				res = scalar_op(res, p[i]);
+			}
+			ret[c] = res;
+		}
+		return ret;
+	}
+};
+
+}
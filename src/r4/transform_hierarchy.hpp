@@ -0,0 +1,311 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+
+namespace r4{
+
+/**
+ * @brief Hierarchy of transformations.
+ * A tree, or a forest, of nodes, each node has a local transformation relative to its parent node,
+ * and a world transformation, which is the world transformation of the parent multiplied by the local transformation
+ * of the node. For root nodes the world transformation is the same as the local one.
+ * The nodes are stored in breadth-first order, so that each level of the hierarchy occupies contiguous range
+ * of the node arrays and parents precede their children.
+ * Changing the local transformation of a node marks the node dirty, update() recalculates world transformations
+ * of dirty nodes and their descendants only. The levels are processed one after another, nodes of one level
+ * are processed in parallel in case the level is big enough, see parallel_for() and parallel_threshold_bytes.
+ * The structure of the hierarchy is fixed at construction.
+ * Nodes are identified by ids, which are the indices of the nodes in the array of parents given to the constructor.
+ * @tparam T - type of transformation matrix elements.
+ */
+template <class T> class transform_hierarchy{
+	static_assert(std::is_floating_point_v<T>, "transform_hierarchy is only defined for floating point types");
+
+public:
+	/**
+	 * @brief Invalid id value, the parent id of root nodes.
+	 */
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+private:
+	// node arrays in breadth-first order
+
+	// index of the parent node, npos for root nodes
+	std::vector<size_t> parents;
+
+	std::vector<matrix4<T>> local_transforms;
+	std::vector<matrix4<T>> world_transforms;
+
+	// bytes instead of std::vector<bool>, so that flags of neighbouring nodes can be written by different threads
+	std::vector<uint8_t> dirty;
+
+	// id of the node
+	std::vector<size_t> ids;
+
+	// index of the node by its id
+	std::vector<size_t> indices;
+
+	// index of the first node of each level, the last element is the number of nodes
+	std::vector<size_t> levels;
+
+	// levels before this one have no dirty nodes, npos if there are no dirty nodes at all
+	size_t first_dirty_level = npos;
+
+public:
+	/**
+	 * @brief Construct hierarchy.
+	 * All local transformations are initialized to identity.
+	 * @param parents - ids of parent nodes, for root nodes the parent id is npos.
+	 *                  Id of the node is its index in this span. The parent links must not form cycles.
+	 */
+	explicit transform_hierarchy(utki::span<const size_t> parents) :
+			parents(parents.size()),
+			local_transforms(parents.size()),
+			world_transforms(parents.size()),
+			dirty(parents.size(), 1),
+			ids(parents.size()),
+			indices(parents.size(), npos)
+	{
+		// children of each node as ranges of one array, i.e. counting sort of nodes by parent
+		std::vector<size_t> child_begin(parents.size() + 1, 0);
+		for(auto p : parents){
+			ASSERT(p == npos || p < parents.size())
+			if(p != npos){
+				++child_begin[p + 1];
+			}
+		}
+		for(size_t i = 0; i != parents.size(); ++i){
+			child_begin[i + 1] += child_begin[i];
+		}
+		std::vector<size_t> children(child_begin.back());
+		{
+			auto pos = child_begin;
+			for(size_t i = 0; i != parents.size(); ++i){
+				if(parents[i] != npos){
+					children[pos[parents[i]]++] = i;
+				}
+			}
+		}
+
+		// breadth-first traversal, the ids array serves as the queue
+		size_t end = 0;
+		for(size_t i = 0; i != parents.size(); ++i){
+			if(parents[i] == npos){
+				this->ids[end++] = i;
+			}
+		}
+		for(size_t begin = 0; begin != end;){
+			this->levels.push_back(begin);
+			size_t level_end = end;
+			for(; begin != level_end; ++begin){
+				size_t id = this->ids[begin];
+				for(size_t c = child_begin[id]; c != child_begin[id + 1]; ++c){
+					this->ids[end++] = children[c];
+				}
+			}
+		}
+		this->levels.push_back(end);
+
+		// all nodes are reachable from roots in case there are no cycles
+		ASSERT(end == parents.size())
+
+		for(size_t i = 0; i != this->ids.size(); ++i){
+			this->indices[this->ids[i]] = i;
+		}
+		for(size_t i = 0; i != this->ids.size(); ++i){
+			size_t p = parents[this->ids[i]];
+			this->parents[i] = p == npos ? npos : this->indices[p];
+			this->local_transforms[i].set_identity();
+		}
+
+		if(!this->ids.empty()){
+			this->first_dirty_level = 0;
+		}
+	}
+
+	/**
+	 * @brief Get number of nodes.
+	 * @return number of nodes in the hierarchy.
+	 */
+	size_t size()const noexcept{
+		return this->ids.size();
+	}
+
+	/**
+	 * @brief Get number of levels.
+	 * Root nodes are at level 0, their children at level 1 and so on.
+	 * @return number of levels in the hierarchy.
+	 */
+	size_t num_levels()const noexcept{
+		return this->levels.size() - 1;
+	}
+
+	/**
+	 * @brief Get parent node.
+	 * @param id - id of the node.
+	 * @return id of the parent node.
+	 * @return npos if the node is a root node.
+	 */
+	size_t parent(size_t id)const noexcept{
+		ASSERT(id < this->size())
+		size_t p = this->parents[this->indices[id]];
+		return p == npos ? npos : this->ids[p];
+	}
+
+	/**
+	 * @brief Get local transformation of the node.
+	 * @param id - id of the node.
+	 * @return local transformation of the node.
+	 */
+	const matrix4<T>& local(size_t id)const noexcept{
+		ASSERT(id < this->size())
+		return this->local_transforms[this->indices[id]];
+	}
+
+	/**
+	 * @brief Set local transformation of the node.
+	 * Marks the node dirty, so that its world transformation and world transformations of its descendants
+	 * are recalculated by the next update().
+	 * @param id - id of the node.
+	 * @param m - local transformation.
+	 */
+	void set_local(size_t id, const matrix4<T>& m)noexcept{
+		ASSERT(id < this->size())
+		size_t i = this->indices[id];
+		this->local_transforms[i] = m;
+		this->mark_dirty(i);
+	}
+
+	/**
+	 * @brief Set local transformation of the node from translation, rotation and scale.
+	 * The local transformation is set to T * R * S, where T, R and S are translation, rotation and scaling matrices,
+	 * i.e. the node is scaled first, then rotated and then translated.
+	 * @param id - id of the node.
+	 * @param translation - translation.
+	 * @param rotation - unit quaternion defining the rotation.
+	 * @param scale - scaling factors along the axes.
+	 */
+	void set_local(
+			size_t id,
+			const vector3<T>& translation,
+			const quaternion<T>& rotation,
+			const vector3<T>& scale = vector3<T>(1)
+		)noexcept
+	{
+		// translation matrix multiplied by matrix without translation only sets its last column
+		matrix4<T> m(rotation);
+		m.scale(scale);
+		for(size_t r = 0; r != 3; ++r){
+			m[r][3] = translation[r];
+		}
+		this->set_local(id, m);
+	}
+
+	/**
+	 * @brief Get world transformation of the node.
+	 * The world transformation is up to date only if there were no changes of local transformations
+	 * of the node and its ancestors since the last update().
+	 * @param id - id of the node.
+	 * @return world transformation of the node.
+	 */
+	const matrix4<T>& world(size_t id)const noexcept{
+		ASSERT(id < this->size())
+		return this->world_transforms[this->indices[id]];
+	}
+
+	/**
+	 * @brief Recalculate world transformations.
+	 * Recalculates world transformations of the dirty nodes and of all their descendants, then clears the dirty flags.
+	 * Levels before the first level having a dirty node are not visited at all.
+	 * @param num_threads - number of threads to use, 0 means number of hardware threads.
+	 */
+	void update(size_t num_threads = 0){
+		if(this->first_dirty_level == npos){
+			return;
+		}
+
+		for(size_t l = this->first_dirty_level; l != this->num_levels(); ++l){
+			size_t level_begin = this->levels[l];
+			size_t level_size = this->levels[l + 1] - level_begin;
+			parallel_for(
+					level_size,
+					parallel_grain<matrix4<T>>(),
+					[this, level_begin](size_t begin, size_t end){
+						this->update_nodes(level_begin + begin, level_begin + end);
+					},
+					internal::span_num_threads(level_size * sizeof(matrix4<T>), num_threads)
+				);
+		}
+
+		std::fill(std::next(this->dirty.begin(), this->levels[this->first_dirty_level]), this->dirty.end(), uint8_t(0));
+		this->first_dirty_level = npos;
+	}
+
+private:
+	void mark_dirty(size_t i)noexcept{
+		this->dirty[i] = 1;
+
+		// levels array is sorted, the level of the node is the last level starting not after the node
+		size_t l = size_t(std::distance(
+				this->levels.begin(),
+				std::upper_bound(this->levels.begin(), this->levels.end(), i)
+			)) - 1;
+		if(this->first_dirty_level == npos || l < this->first_dirty_level){
+			this->first_dirty_level = l;
+		}
+	}
+
+	// Recalculates world transformations of dirty nodes of the range and of nodes having dirty parent,
+	// such nodes are marked dirty to propagate the flag to the next level.
+	// The range is within one level, so the parents are already up to date.
+	void update_nodes(size_t begin, size_t end)noexcept{
+		for(size_t i = begin; i != end; ++i){
+			size_t p = this->parents[i];
+			if(p == npos){
+				if(this->dirty[i]){
+					this->world_transforms[i] = this->local_transforms[i];
+				}
+			}else if(this->dirty[i] || this->dirty[p]){
+				this->dirty[i] = 1;
+				this->world_transforms[i] = this->world_transforms[p] * this->local_transforms[i];
+			}
+		}
+	}
+};
+
+}
@@ -0,0 +1,335 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* ================ LICENSE END ================ */
+
+#pragma once
+
+#include <type_traits>
+
+#include <utki/span.hpp>
+
+#include "matrix.hpp"
+
+namespace r4{
+
+/**
+ * @brief Translation, rotation and scale transformation.
+ * Compact alternative to 4x4 transformation matrix for rigid and similarity transformations.
+ * The transformation scales first, then rotates and then translates, i.e. it is the same as matrix T * R * S,
+ * where T, R and S are translation, rotation and scaling matrices.
+ * With uniform scale the transformation of floats takes 32 bytes, half of the matrix4<float> size, and
+ * such transformations are closed under composition and inversion, which are done in a few operations.
+ * With non-uniform scale the composition is exact only if the scale of the left operand is uniform,
+ * because in general case rotated non-uniform scale is a shear, which cannot be represented by the
+ * translation, rotation and scale. The inverse is not defined for non-uniform scale for the same reason.
+ * @tparam T - type of the components.
+ * @tparam S - type of the scale, either T for uniform scale or vector3<T> for non-uniform scale.
+ */
+template <class T, class S = T> class trs{
+	static_assert(std::is_floating_point_v<T>, "trs is only defined for floating point types");
+	static_assert(
+			std::is_same_v<S, T> || std::is_same_v<S, vector3<T>>,
+			"trs scale must be either T or vector3<T>"
+		);
+
+public:
+	/**
+	 * @brief Translation.
+	 */
+	vector3<T> translation;
+
+	/**
+	 * @brief Rotation.
+	 * Must be a unit quaternion.
+	 */
+	quaternion<T> rotation;
+
+	/**
+	 * @brief Scale.
+	 */
+	S scale;
+
+	constexpr trs() = default;
+
+	/**
+	 * @brief Construct transformation.
+	 * @param translation - translation.
+	 * @param rotation - unit quaternion defining the rotation.
+	 * @param scale - scale.
+	 */
+	constexpr trs(const vector3<T>& translation, const quaternion<T>& rotation, const S& scale = S(1))noexcept :
+			translation(translation),
+			rotation(rotation),
+			scale(scale)
+	{}
+
+	/**
+	 * @brief Construct transformation from matrix.
+	 * The matrix must be a product of translation, rotation and positive scale matrices, i.e. T * R * S,
+	 * for uniform scale the scale matrix must be uniform. Reflections, shears and projections are not supported.
+	 * For uniform scale, the scale is the average of the scales along the axes.
+	 * @param m - matrix to decompose.
+	 */
+	constexpr explicit trs(const matrix4<T>& m)noexcept :
+			translation(m[0][3], m[1][3], m[2][3]),
+			rotation(),
+			scale()
+	{
+		// columns of the upper-left 3x3 sub-matrix are the rotated axes scaled by the scale factors
+		vector3<T> s{};
+		for(size_t c = 0; c != 3; ++c){
+			s[c] = vector3<T>(m[0][c], m[1][c], m[2][c]).norm();
+		}
+
+		if constexpr (std::is_same_v<S, T>){
+			this->scale = (s[0] + s[1] + s[2]) / T(3);
+		}else{
+			this->scale = s;
+		}
+
+		matrix3<T> r{};
+		for(size_t i = 0; i != 3; ++i){
+			for(size_t c = 0; c != 3; ++c){
+				r[i][c] = m[i][c] / s[c];
+			}
+		}
+		this->rotation = to_quaternion(r);
+	}
+
+	/**
+	 * @brief Set to identity transformation.
+	 * @return reference to this transformation.
+	 */
+	constexpr trs& set_identity()noexcept{
+		this->translation.set(T(0));
+		this->rotation.set_identity();
+		this->scale = S(1);
+		return *this;
+	}
+
+	/**
+	 * @brief Convert to matrix.
+	 * @return transformation matrix T * R * S.
+	 */
+	constexpr matrix4<T> to_matrix()const noexcept{
+		matrix4<T> m(this->rotation);
+		m.scale(this->scale);
+		for(size_t r = 0; r != 3; ++r){
+			m[r][3] = this->translation[r];
+		}
+		return m;
+	}
+
+	/**
+	 * @brief Transform point.
+	 * @param p - point to transform.
+	 * @return transformed point.
+	 */
+	constexpr vector3<T> operator*(const vector3<T>& p)const noexcept{
+		return this->transform_vector(p) + this->translation;
+	}
+
+	/**
+	 * @brief Transform vector.
+	 * Same as transforming a point, but without translation, i.e. the vector is scaled and rotated.
+	 * Note, that normals should not be transformed this way in case of non-uniform scale.
+	 * @param v - vector to transform.
+	 * @return transformed vector.
+	 */
+	constexpr vector3<T> transform_vector(const vector3<T>& v)const noexcept{
+		return scaled(v, this->scale).rotate(this->rotation);
+	}
+
+	/**
+	 * @brief Compose transformations.
+	 * Calculates transformation which is the same as applying the given transformation first and then this one,
+	 * i.e. the same as multiplication of corresponding matrices in the same order.
+	 * With non-uniform scale of this transformation the result is exact only if the scale is uniform
+	 * or the rotation of the given transformation is identity.
+	 * @param t - transformation to compose with from the right.
+	 * @return composed transformation.
+	 */
+	constexpr trs operator*(const trs& t)const noexcept{
+		S s{};
+		if constexpr (std::is_same_v<S, T>){
+			s = this->scale * t.scale;
+		}else{
+			s = this->scale.comp_mul(t.scale);
+		}
+		return trs((*this) * t.translation, this->rotation % t.rotation, s);
+	}
+
+	/**
+	 * @brief Compose transformations and assign.
+	 * See operator*(const trs&).
+	 * @param t - transformation to compose with from the right.
+	 * @return reference to this transformation.
+	 */
+	constexpr trs& operator*=(const trs& t)noexcept{
+		return this->operator=((*this) * t);
+	}
+
+	/**
+	 * @brief Calculate inverse transformation.
+	 * Defined only for uniform scale. The scale must not be zero.
+	 * @return inverse transformation.
+	 */
+	template <typename E = S>
+	constexpr std::enable_if_t<std::is_same_v<E, T>, trs> inv()const noexcept{
+		// (T * R * S)^-1 = S^-1 * R^-1 * T^-1, uniform scale commutes with rotation
+		T s = T(1) / this->scale;
+		auto r = !this->rotation;
+		return trs(-(vector3<T>(this->translation).rotate(r) * s), r, s);
+	}
+
+	/**
+	 * @brief Invert this transformation.
+	 * See inv().
+	 * @return reference to this transformation.
+	 */
+	template <typename E = S>
+	constexpr std::enable_if_t<std::is_same_v<E, T>, trs&> invert()noexcept{
+		return this->operator=(this->inv());
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const trs& t){
+		return s << "t = " << t.translation << ", r = " << t.rotation << ", s = " << t.scale;
+	}
+
+private:
+	static constexpr vector3<T> scaled(const vector3<T>& v, const S& s)noexcept{
+		if constexpr (std::is_same_v<S, T>){
+			return v * s;
+		}else{
+			return v.comp_mul(s);
+		}
+	}
+
+	// Shepperd's method, the square root is taken of the largest of 4 possible values to avoid
+	// loss of precision for rotation angles close to 180 degrees.
+	static constexpr quaternion<T> to_quaternion(const matrix3<T>& r)noexcept{
+		T trace = r[0][0] + r[1][1] + r[2][2];
+		if(trace > T(0)){
+			T s = T(2) * internal::sqrt(trace + T(1));
+			return quaternion<T>(
+					(r[2][1] - r[1][2]) / s,
+					(r[0][2] - r[2][0]) / s,
+					(r[1][0] - r[0][1]) / s,
+					s / T(4)
+				);
+		}else if(r[0][0] > r[1][1] && r[0][0] > r[2][2]){
+			T s = T(2) * internal::sqrt(T(1) + r[0][0] - r[1][1] - r[2][2]);
+			return quaternion<T>(
+					s / T(4),
+					(r[0][1] + r[1][0]) / s,
+					(r[0][2] + r[2][0]) / s,
+					(r[2][1] - r[1][2]) / s
+				);
+		}else if(r[1][1] > r[2][2]){
+			T s = T(2) * internal::sqrt(T(1) + r[1][1] - r[0][0] - r[2][2]);
+			return quaternion<T>(
+					(r[0][1] + r[1][0]) / s,
+					s / T(4),
+					(r[1][2] + r[2][1]) / s,
+					(r[0][2] - r[2][0]) / s
+				);
+		}
+		T s = T(2) * internal::sqrt(T(1) + r[2][2] - r[0][0] - r[1][1]);
+		return quaternion<T>(
+				(r[0][2] + r[2][0]) / s,
+				(r[1][2] + r[2][1]) / s,
+				s / T(4),
+				(r[1][0] - r[0][1]) / s
+			);
+	}
+};
+
+/**
+ * @brief Transform points.
+ * Transforms each point of the input span and stores the result to the output span.
+ * The transformation is converted to matrix once, then the points are transformed by the matrix,
+ * see transform(const matrix4&, utki::span<const vector3>, utki::span<vector3>).
+ * Output span can be the same as the input span.
+ * @param t - transformation.
+ * @param in - points to transform.
+ * @param out - span to store the transformed points to. Must be of the same size as the input span.
+ */
+template <class T, class S>
+void transform(const trs<T, S>& t, utki::span<const vector3<std::common_type_t<T>>> in, utki::span<vector3<std::common_type_t<T>>> out)noexcept{
+	transform(t.to_matrix(), in, out);
+}
+
+/**
+ * @brief Convert transformations to matrices.
+ * The template arguments are deduced from the output span only, so the scale type S
+ * has to be specified explicitly in case it is not T, i.e. for non-uniform scale.
+ * @param in - transformations to convert.
+ * @param out - span to store the matrices to. Must be of the same size as the input span.
+ */
+template <class T, class S = T>
+void to_matrix(utki::span<const trs<std::common_type_t<T>, std::common_type_t<S>>> in, utki::span<matrix4<T>> out)noexcept{
+	ASSERT(in.size() == out.size())
+	for(size_t i = 0; i != in.size(); ++i){
+		out[i] = in[i].to_matrix();
+	}
+}
+
+/**
+ * @brief Compose transformations.
+ * Composes each transformation of the left span with the transformation of the same index in the right span,
+ * i.e. out[i] = left[i] * right[i]. Typical use is calculation of world transformations from parent world
+ * transformations and local transformations.
+ * Output span can be the same as one of the input spans.
+ * @param left - left operands of the composition.
+ * @param right - right operands of the composition. Must be of the same size as the left span.
+ * @param out - span to store the composed transformations to. Must be of the same size as the left span.
+ */
+template <class T, class S>
+void compose(
+		utki::span<const trs<std::common_type_t<T>, std::common_type_t<S>>> left,
+		utki::span<const trs<std::common_type_t<T>, std::common_type_t<S>>> right,
+		utki::span<trs<T, S>> out
+	)noexcept
+{
+	ASSERT(left.size() == right.size())
+	ASSERT(left.size() == out.size())
+	for(size_t i = 0; i != out.size(); ++i){
+		out[i] = left[i] * right[i];
+	}
+}
+
+/**
+ * @brief Invert transformations.
+ * Inverts each transformation of the span, see trs::inv().
+ * @param ts - transformations to invert.
+ */
+template <class T>
+void invert(utki::span<trs<T>> ts)noexcept{
+	for(auto& t : ts){
+		t.invert();
+	}
+}
+
+}
@@ -0,0 +1,498 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2022 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+
+#include <utki/span.hpp>
+
+#include "rectangle.hpp"
+
+namespace r4{
+
+/**
+ * @brief Uniform grid broadphase.
+ * Divides a box shaped region of D-dimensional space into a grid of equal cubic cells
+ * and stores ids of objects in the cells which the objects' bounding boxes overlap.
+ * Objects are axis aligned boxes, points or, in 2d case, rectangles.
+ * Ids of objects of all cells are stored in a single array, each cell occupies a contiguous range of the array
+ * with some spare slots for objects moving into the cell. A cell which runs out of spare slots is moved to
+ * the end of the array with doubled capacity. When the slots left behind by moved cells make up half
+ * of the array or half of the cells have been moved, the array is compacted by a counting pass and a fill pass,
+ * which puts the cells back in order.
+ * Objects outside of the grid region are stored in the border cells, this is correct,
+ * but the more objects are outside the less efficient the grid is.
+ * Moving an object only touches the grid cells when the object crosses cell boundaries, then the object
+ * is removed from its old cells and added to the new ones, other objects are only touched by an occasional compaction.
+ * So, updating positions of many moving objects per frame is cheap, as long as
+ * the objects are not too big compared to the cell size.
+ * The grid is good for many objects of similar sizes, the cell size is supposed to be about the typical object size.
+ * @tparam T - type of coordinates.
+ * @tparam D - number of dimensions, 2 or 3.
+ */
+template <class T, size_t D> class uniform_grid{
+	static_assert(D == 2 || D == 3, "only 2d and 3d grids are supported");
+
+public:
+	/**
+	 * @brief Invalid id value.
+	 */
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	typedef vector<T, D> vector_type;
+
+private:
+	vector_type origin;
+	T cell_size;
+	std::array<size_t, D> dims;
+
+	// Ids of objects of the cell are cell_ids[offset : offset + size),
+	// slots cell_ids[offset + size : offset + capacity) are spare.
+	struct cell_type{
+		size_t offset = 0;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+
+	std::vector<cell_type> cells;
+	std::vector<size_t> cell_ids;
+
+	// number of slots of cell_ids not belonging to any cell, left behind by cells moved to the end of the array
+	size_t num_lost_slots = 0;
+
+	// number of cells moved to the end of the array since the last compaction, i.e. cells out of order
+	size_t num_moved_cells = 0;
+
+	// reused to avoid memory allocation on each compaction
+	std::vector<size_t> compacted_ids;
+
+	struct object{
+		vector_type min;
+		vector_type max;
+
+		// range of cells overlapped by the object, max_cell[0] is npos for removed objects
+		std::array<size_t, D> min_cell;
+		std::array<size_t, D> max_cell;
+	};
+
+	std::vector<object> objects;
+
+	std::vector<size_t> free_ids;
+
+	size_t num_objects = 0;
+
+public:
+	/**
+	 * @brief Constructor.
+	 * @param origin - minimum corner of the grid region.
+	 * @param cell_size - size of a grid cell, must be greater than zero.
+	 * @param dims - number of cells along each axis, each must be greater than zero.
+	 */
+	uniform_grid(const vector_type& origin, T cell_size, const std::array<size_t, D>& dims) :
+			origin(origin),
+			cell_size(cell_size),
+			dims(dims)
+	{
+		ASSERT(cell_size > 0)
+		size_t num_cells = 1;
+		for(auto d : dims){
+			ASSERT(d > 0)
+			num_cells *= d;
+		}
+		this->cells.resize(num_cells);
+	}
+
+	/**
+	 * @brief Get number of objects in the grid.
+	 * @return number of objects.
+	 */
+	size_t size()const noexcept{
+		return this->num_objects;
+	}
+
+	/**
+	 * @brief Remove all objects.
+	 */
+	void clear()noexcept{
+		std::fill(this->cells.begin(), this->cells.end(), cell_type());
+		this->cell_ids.clear();
+		this->num_lost_slots = 0;
+		this->num_moved_cells = 0;
+		this->objects.clear();
+		this->free_ids.clear();
+		this->num_objects = 0;
+	}
+
+	/**
+	 * @brief Insert box shaped object.
+	 * @param min - minimum corner of the object's bounding box.
+	 * @param max - maximum corner of the object's bounding box.
+	 * @return id of the inserted object.
+	 */
+	size_t insert(const vector_type& min, const vector_type& max){
+		size_t id;
+		if(this->free_ids.empty()){
+			id = this->objects.size();
+			this->objects.emplace_back();
+		}else{
+			id = this->free_ids.back();
+			this->free_ids.pop_back();
+		}
+
+		auto& o = this->objects[id];
+		o.min = min;
+		o.max = max;
+		o.min_cell = this->cell_of(min);
+		o.max_cell = this->cell_of(max);
+		this->add_to_cells(id, o.min_cell, o.max_cell);
+
+		++this->num_objects;
+		return id;
+	}
+
+	/**
+	 * @brief Insert point object.
+	 * @param point - position of the object.
+	 * @return id of the inserted object.
+	 */
+	size_t insert(const vector_type& point){
+		return this->insert(point, point);
+	}
+
+	/**
+	 * @brief Insert rectangle object.
+	 * Only for 2d grids.
+	 * @param rect - the rectangle.
+	 * @return id of the inserted object.
+	 */
+	template <typename E = T>
+	size_t insert(const rectangle<std::enable_if_t<D == 2, E>>& rect){
+		return this->insert(rect.p, rect.x2_y2());
+	}
+
+	/**
+	 * @brief Remove object.
+	 * After removal the id of the object becomes invalid and can be reused by later insertions.
+	 * @param id - id of the object to remove.
+	 */
+	void remove(size_t id){
+		ASSERT(this->is_valid(id))
+		auto& o = this->objects[id];
+		this->remove_from_cells(id, o.min_cell, o.max_cell);
+		o.max_cell[0] = npos;
+		this->free_ids.push_back(id);
+		--this->num_objects;
+	}
+
+	/**
+	 * @brief Move box shaped object.
+	 * The object is moved to other cells only if it has crossed cell boundaries.
+	 * @param id - id of the object to move.
+	 * @param min - new minimum corner of the object's bounding box.
+	 * @param max - new maximum corner of the object's bounding box.
+	 * @return true if the object was moved to other cells.
+	 * @return false if the object stays in the same cells.
+	 */
+	bool update(size_t id, const vector_type& min, const vector_type& max){
+		ASSERT(this->is_valid(id))
+		auto& o = this->objects[id];
+		o.min = min;
+		o.max = max;
+
+		auto min_cell = this->cell_of(min);
+		auto max_cell = this->cell_of(max);
+		if(min_cell == o.min_cell && max_cell == o.max_cell){
+			return false;
+		}
+
+		this->remove_from_cells(id, o.min_cell, o.max_cell);
+		o.min_cell = min_cell;
+		o.max_cell = max_cell;
+		this->add_to_cells(id, min_cell, max_cell);
+		return true;
+	}
+
+	/**
+	 * @brief Move point object.
+	 * @param id - id of the object to move.
+	 * @param point - new position of the object.
+	 * @return true if the object was moved to another cell.
+	 * @return false if the object stays in the same cell.
+	 */
+	bool update(size_t id, const vector_type& point){
+		return this->update(id, point, point);
+	}
+
+	/**
+	 * @brief Move rectangle object.
+	 * Only for 2d grids.
+	 * @param id - id of the object to move.
+	 * @param rect - new rectangle of the object.
+	 * @return true if the object was moved to other cells.
+	 * @return false if the object stays in the same cells.
+	 */
+	template <typename E = T>
+	bool update(size_t id, const rectangle<std::enable_if_t<D == 2, E>>& rect){
+		return this->update(id, rect.p, rect.x2_y2());
+	}
+
+	/**
+	 * @brief Find pairs of overlapping objects.
+	 * Objects overlap if their bounding boxes overlap, boxes which touch each other
+	 * by boundaries are also considered overlapping, so that point objects at
+	 * the same position overlap.
+	 * Each pair is reported only once.
+	 * @param func - function to call for each overlapping pair, takes ids of the two objects as arguments.
+	 */
+	template <class F> void for_each_pair(F func)const{
+		for(size_t c = 0; c != this->cells.size(); ++c){
+			auto cell = this->cell(c);
+			for(auto i = cell.begin(); i != cell.end(); ++i){
+				const auto& a = this->objects[*i];
+				for(auto j = std::next(i); j != cell.end(); ++j){
+					const auto& b = this->objects[*j];
+					if(!overlap(a, b)){
+						continue;
+					}
+
+					if(this->home_cell(a, b) != c){
+						continue;
+					}
+
+					func(*i, *j);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Find objects overlapping the box.
+	 * Overlapping is tested in the same way as in for_each_pair().
+	 * Each object is reported only once.
+	 * @param min - minimum corner of the box.
+	 * @param max - maximum corner of the box.
+	 * @param func - function to call for each found object, takes id of the object as argument.
+	 */
+	template <class F> void query(const vector_type& min, const vector_type& max, F func)const{
+		object q;
+		q.min = min;
+		q.max = max;
+		q.min_cell = this->cell_of(min);
+		q.max_cell = this->cell_of(max);
+
+		this->for_each_cell(q.min_cell, q.max_cell, [&](size_t c){
+			for(auto id : this->cell(c)){
+				const auto& o = this->objects[id];
+				if(!overlap(o, q)){
+					continue;
+				}
+				if(this->home_cell(o, q) != c){
+					continue;
+				}
+				func(id);
+			}
+		});
+	}
+
+	/**
+	 * @brief Find objects overlapping the rectangle.
+	 * Only for 2d grids.
+	 * @param rect - the rectangle.
+	 * @param func - function to call for each found object, takes id of the object as argument.
+	 */
+	template <class F, typename E = T>
+	void query(const rectangle<std::enable_if_t<D == 2, E>>& rect, F func)const{
+		this->query(rect.p, rect.x2_y2(), std::move(func));
+	}
+
+	/**
+	 * @brief Get ids of objects in a cell.
+	 * The returned span is valid until the grid is modified.
+	 * @param cell - cell coordinates.
+	 * @return ids of the objects in the cell.
+	 */
+	utki::span<const size_t> get_cell(const std::array<size_t, D>& cell)const noexcept{
+		return this->cell(this->cell_index(cell));
+	}
+
+	/**
+	 * @brief Get coordinates of the cell containing the point.
+	 * Points outside of the grid region belong to the nearest border cell.
+	 * @param point - point to get the cell of.
+	 * @return cell coordinates.
+	 */
+	std::array<size_t, D> cell_of(const vector_type& point)const noexcept{
+		std::array<size_t, D> ret;
+		for(size_t i = 0; i != D; ++i){
+			// compare before subtraction to support unsigned types
+			if(!(this->origin[i] < point[i])){
+				ret[i] = 0;
+				continue;
+			}
+			T c = (point[i] - this->origin[i]) / this->cell_size;
+			if(!(c < T(this->dims[i]))){
+				ret[i] = this->dims[i] - 1;
+			}else{
+				ret[i] = size_t(c);
+			}
+		}
+		return ret;
+	}
+
+private:
+	bool is_valid(size_t id)const noexcept{
+		return id < this->objects.size() && this->objects[id].max_cell[0] != npos;
+	}
+
+	static bool overlap(const object& a, const object& b)noexcept{
+		for(size_t i = 0; i != D; ++i){
+			if(a.max[i] < b.min[i] || b.max[i] < a.min[i]){
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Index of the cell containing minimum corner of intersection of the two overlapping objects.
+	// Objects which share several cells are reported only from this cell.
+	size_t home_cell(const object& a, const object& b)const noexcept{
+		std::array<size_t, D> c;
+		for(size_t i = 0; i != D; ++i){
+			c[i] = std::max(a.min_cell[i], b.min_cell[i]);
+		}
+		return this->cell_index(c);
+	}
+
+	size_t cell_index(const std::array<size_t, D>& cell)const noexcept{
+		size_t ret = cell[D - 1];
+		for(size_t i = D - 1; i != 0; --i){
+			ret = ret * this->dims[i - 1] + cell[i - 1];
+		}
+		return ret;
+	}
+
+	template <class F> void for_each_cell(const std::array<size_t, D>& min_cell, const std::array<size_t, D>& max_cell, F func)const{
+		std::array<size_t, D> c;
+		if constexpr (D == 2){
+			for(c[1] = min_cell[1]; c[1] <= max_cell[1]; ++c[1]){
+				for(c[0] = min_cell[0]; c[0] <= max_cell[0]; ++c[0]){
+					func(this->cell_index(c));
+				}
+			}
+		}else{
+			for(c[2] = min_cell[2]; c[2] <= max_cell[2]; ++c[2]){
+				for(c[1] = min_cell[1]; c[1] <= max_cell[1]; ++c[1]){
+					for(c[0] = min_cell[0]; c[0] <= max_cell[0]; ++c[0]){
+						func(this->cell_index(c));
+					}
+				}
+			}
+		}
+	}
+
+	utki::span<const size_t> cell(size_t c)const noexcept{
+		const auto& cell = this->cells[c];
+		return utki::make_span(this->cell_ids.data() + cell.offset, cell.size);
+	}
+
+	void add_to_cells(size_t id, const std::array<size_t, D>& min_cell, const std::array<size_t, D>& max_cell){
+		this->for_each_cell(min_cell, max_cell, [this, id](size_t c){
+			auto& cell = this->cells[c];
+			if(cell.size == cell.capacity){
+				this->grow(c);
+			}
+			this->cell_ids[cell.offset + cell.size] = id;
+			++cell.size;
+		});
+	}
+
+	void remove_from_cells(size_t id, const std::array<size_t, D>& min_cell, const std::array<size_t, D>& max_cell)noexcept{
+		this->for_each_cell(min_cell, max_cell, [this, id](size_t c){
+			auto& cell = this->cells[c];
+			auto begin = std::next(this->cell_ids.begin(), cell.offset);
+			auto end = std::next(begin, cell.size);
+			auto i = std::find(begin, end, id);
+			ASSERT(i != end)
+			--cell.size;
+			*i = *std::next(begin, cell.size);
+		});
+	}
+
+	// Double capacity of the cell, the cell is moved to the end of the ids array unless it is there already.
+	void grow(size_t c){
+		constexpr size_t min_capacity = 2;
+
+		auto& cell = this->cells[c];
+		size_t capacity = std::max(cell.capacity * 2, min_capacity);
+
+		if(cell.offset + cell.capacity != this->cell_ids.size()){
+			size_t offset = this->cell_ids.size();
+			this->cell_ids.resize(offset + capacity);
+			auto begin = std::next(this->cell_ids.begin(), cell.offset);
+			std::copy(begin, std::next(begin, cell.size), std::next(this->cell_ids.begin(), offset));
+			this->num_lost_slots += cell.capacity;
+			++this->num_moved_cells;
+			cell.offset = offset;
+		}else{
+			this->cell_ids.resize(cell.offset + capacity);
+		}
+		cell.capacity = capacity;
+
+		if(this->num_lost_slots > this->cell_ids.size() / 2 || this->num_moved_cells > this->cells.size() / 2){
+			this->compact();
+		}
+	}
+
+	// Remove lost slots from the ids array and put the cells in order.
+	void compact(){
+		auto& ids = this->compacted_ids;
+
+		// counting pass
+		size_t num_slots = 0;
+		for(const auto& cell : this->cells){
+			num_slots += cell.capacity;
+		}
+		ids.resize(num_slots);
+
+		// fill pass
+		size_t offset = 0;
+		for(auto& cell : this->cells){
+			auto begin = std::next(this->cell_ids.begin(), cell.offset);
+			std::copy(begin, std::next(begin, cell.size), std::next(ids.begin(), offset));
+			cell.offset = offset;
+			offset += cell.capacity;
+		}
+
+		std::swap(this->cell_ids, ids);
+		this->num_lost_slots = 0;
+		this->num_moved_cells = 0;
+	}
+};
+
+}
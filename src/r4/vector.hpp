@@ -27,10 +27,14 @@ SOFTWARE.
 #pragma once
 
 #include <array>
+#include <utility>
 
 #include <utki/math.hpp>
+#include <utki/span.hpp>
 
 #include "quaternion.hpp"
+#include "simd.hpp"
+#include "constexpr_math.hpp"
 
 // Under Windows and MSVC compiler there are 'min' and 'max' macros defined for some reason, get rid of them.
 #ifdef min
@@ -46,32 +50,35 @@ template <class T, size_t S> class vector : public std::array<T, S>{
 	static_assert(S > 0, "vector size template parameter S must be above zero");
 
 	typedef std::array<T, S> base_type;
+
+	// SIMD kernel for this vector type, the kernel is disabled for vector types which have no SIMD support
+	typedef simd::kernel<T, S> simd_kernel;
 public:
 	/**
 	 * @brief First vector component.
 	 */
-	T& x()noexcept{
+	constexpr T& x()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& x()const noexcept{
+	constexpr const T& x()const noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	T& r()noexcept{
+	constexpr T& r()noexcept{
 		return this->operator[](0);
 	}
 
 	/**
 	 * @brief First vector component.
 	 */
-	const T& r()const noexcept{
+	constexpr const T& r()const noexcept{
 		return this->operator[](0);
 	}
 
@@ -79,7 +86,7 @@ public:
 	 * @brief Second vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 1), E&> y()noexcept{
+	constexpr std::enable_if_t<(S > 1), E&> y()noexcept{
 		return this->operator[](1);
 	}
 
@@ -87,7 +94,7 @@ public:
 	 * @brief Second vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 1), const E&> y()const noexcept{
+	constexpr std::enable_if_t<(S > 1), const E&> y()const noexcept{
 		return this->operator[](1);
 	}
 
@@ -95,7 +102,7 @@ public:
 	 * @brief Second vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 1), E&> g()noexcept{
+	constexpr std::enable_if_t<(S > 1), E&> g()noexcept{
 		return this->operator[](1);
 	}
 
@@ -103,7 +110,7 @@ public:
 	 * @brief Second vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 1), const E&> g()const noexcept{
+	constexpr std::enable_if_t<(S > 1), const E&> g()const noexcept{
 		return this->operator[](1);
 	}
 
@@ -111,7 +118,7 @@ public:
 	 * @brief Third vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 2), E&> z()noexcept{
+	constexpr std::enable_if_t<(S > 2), E&> z()noexcept{
 		return this->operator[](2);
 	}
 
@@ -119,7 +126,7 @@ public:
 	 * @brief Third vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 2), const E&> z()const noexcept{
+	constexpr std::enable_if_t<(S > 2), const E&> z()const noexcept{
 		return this->operator[](2);
 	}
 
@@ -127,7 +134,7 @@ public:
 	 * @brief Third vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 2), E&> b()noexcept{
+	constexpr std::enable_if_t<(S > 2), E&> b()noexcept{
 		return this->operator[](2);
 	}
 
@@ -135,7 +142,7 @@ public:
 	 * @brief Third vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 2), const E&> b()const noexcept{
+	constexpr std::enable_if_t<(S > 2), const E&> b()const noexcept{
 		return this->operator[](2);
 	}
 
@@ -143,7 +150,7 @@ public:
 	 * @brief Fourth vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 3), E&> w()noexcept{
+	constexpr std::enable_if_t<(S > 3), E&> w()noexcept{
 		return this->operator[](3);
 	}
 
@@ -151,7 +158,7 @@ public:
 	 * @brief Fourth vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 3), const E&> w()const noexcept{
+	constexpr std::enable_if_t<(S > 3), const E&> w()const noexcept{
 		return this->operator[](3);
 	}
 
@@ -159,7 +166,7 @@ public:
 	 * @brief Fourth vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 3), E&> a()noexcept{
+	constexpr std::enable_if_t<(S > 3), E&> a()noexcept{
 		return this->operator[](3);
 	}
 
@@ -167,7 +174,7 @@ public:
 	 * @brief Fourth vector component.
 	 */
 	template <typename E = T>
-	std::enable_if_t<(S > 3), const E&> a()const noexcept{
+	constexpr std::enable_if_t<(S > 3), const E&> a()const noexcept{
 		return this->operator[](3);
 	}
 
@@ -219,7 +226,9 @@ public:
 	 * Initializes all vector components to a given value.
 	 * @param num - value to initialize all vector compone with.
 	 */
-	constexpr vector(T num)noexcept{
+	constexpr vector(T num)noexcept :
+			base_type{}
+	{
 		for(auto& c : *this){
 			c = num;
 		}
@@ -232,7 +241,9 @@ public:
 	 * @param num - value to use for initialization of first three vector components.
 	 * @param w - value to use for initialization of fourth vector component.
 	 */
-	template <typename E = T> constexpr vector(std::enable_if_t<S == 4, E> num, T w)noexcept{
+	template <typename E = T> constexpr vector(std::enable_if_t<S == 4, E> num, T w)noexcept :
+			base_type{}
+	{
 		for(size_t i = 0; i != S - 1; ++i){
 			this->operator[](i) = num;
 		}
@@ -255,7 +266,9 @@ public:
 	 * Initializes components to a given values.
 	 * @param vec - 4d vector to use for initialization of first two vector components.
 	 */
-	template <size_t SS> constexpr vector(const vector<T, SS>& vec)noexcept{
+	template <size_t SS> constexpr vector(const vector<T, SS>& vec)noexcept :
+			base_type{}
+	{
 		this->operator=(vec);
 	}
 
@@ -289,8 +302,8 @@ public:
 	 * component as argument of the target type constructor.
 	 * @return converted vector.
 	 */
-	template <typename TT> vector<TT, S> to()const noexcept{
-		vector<TT, S> ret;
+	template <typename TT> constexpr vector<TT, S> to()const noexcept{
+		vector<TT, S> ret{};
 		for(size_t i = 0; i != S; ++i){
 			ret[i] = TT(this->operator[](i));
 		}
@@ -303,7 +316,7 @@ public:
 	 * @param vec - 2d vector to assign first two components from.
 	 * @return Reference to this vector object.
 	 */
-	template <size_t SS> vector& operator=(const vector<T, SS>& vec)noexcept{
+	template <size_t SS> constexpr vector& operator=(const vector<T, SS>& vec)noexcept{
 		if constexpr (SS >= S){
 			for(size_t i = 0; i != S; ++i){
 				this->operator[](i) = vec[i];
@@ -341,7 +354,7 @@ public:
 	 * @param num - number to use for assignment.
 	 * @return Reference to this vector object.
 	 */
-	vector& operator=(T num)noexcept{
+	constexpr vector& operator=(T num)noexcept{
 		this->set(num);
 		return *this;
 	}
@@ -351,7 +364,7 @@ public:
 	 * @param a - parameter pack of values to set the vector to.
 	 * @return Reference to this vector object.
 	 */
-	template <typename... A> vector& set(A... a)noexcept{
+	template <typename... A> constexpr vector& set(A... a)noexcept{
 		this->base_type::operator=(base_type{T(a)...});
 		return *this;
 	}
@@ -361,7 +374,7 @@ public:
 	 * @param val - value to set vector components to.
 	 * @return Reference to this vector object.
 	 */
-	vector& set(T val)noexcept{
+	constexpr vector& set(T val)noexcept{
 		for(auto& c : *this){
 			c = val;
 		}
@@ -374,8 +387,14 @@ public:
 	 * @param vec - vector to use for addition.
 	 * @return Reference to this vector object.
 	 */
-	template <size_t SS> vector& operator+=(const vector<T, SS>& vec)noexcept{
+	template <size_t SS> constexpr vector& operator+=(const vector<T, SS>& vec)noexcept{
 		if constexpr (SS >= S){
+			if constexpr (simd_kernel::enabled){
+				if(!internal::is_constant_evaluated()){
+					simd_kernel::store(this->data(), simd_kernel::add(simd_kernel::load(this->data()), simd_kernel::load(vec.data())));
+					return *this;
+				}
+			}
 			for(size_t i = 0; i != S; ++i){
 				this->operator[](i) += vec[i];
 			}
@@ -401,7 +420,7 @@ public:
 	 * @param vec - vector to add.
 	 * @return Vector resulting from vector addition.
 	 */
-	vector operator+(const vector& vec)const noexcept{
+	constexpr vector operator+(const vector& vec)const noexcept{
 		return (vector(*this) += vec);
 	}
 
@@ -411,7 +430,13 @@ public:
 	 * @param number - number to use for addition.
 	 * @return Reference to this vector object.
 	 */
-	vector& operator+=(T number)noexcept{
+	constexpr vector& operator+=(T number)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::add(simd_kernel::load(this->data()), simd_kernel::set(number)));
+				return *this;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			this->operator[](i) += number;
 		}
@@ -424,7 +449,7 @@ public:
 	 * @param number - number to use for addition.
 	 * @return Vector resulting from vector and number addition.
 	 */
-	vector operator+(T number) noexcept{
+	constexpr vector operator+(T number) noexcept{
 		return (vector(*this) += number);
 	}	
 
@@ -434,8 +459,14 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Reference to this vector object.
 	 */
-	template <size_t SS> vector& operator-=(const vector<T, SS>& vec)noexcept{
+	template <size_t SS> constexpr vector& operator-=(const vector<T, SS>& vec)noexcept{
 		if constexpr (SS >= S){
+			if constexpr (simd_kernel::enabled){
+				if(!internal::is_constant_evaluated()){
+					simd_kernel::store(this->data(), simd_kernel::sub(simd_kernel::load(this->data()), simd_kernel::load(vec.data())));
+					return *this;
+				}
+			}
 			for(size_t i = 0; i != S; ++i){
 				this->operator[](i) -= vec[i];
 			}
@@ -461,7 +492,7 @@ public:
 	 * @param vec - vector to subtract.
 	 * @return Vector resulting from vector subtraction.
 	 */
-	vector operator-(const vector& vec)const noexcept{
+	constexpr vector operator-(const vector& vec)const noexcept{
 		return (vector(*this) -= vec);
 	}
 	
@@ -471,7 +502,13 @@ public:
 	 * @param number - number to subtract.
 	 * @return Reference to this vector object.
 	 */
-	vector& operator-=(T number)noexcept{
+	constexpr vector& operator-=(T number)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::sub(simd_kernel::load(this->data()), simd_kernel::set(number)));
+				return *this;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			this->operator[](i) -= number;
 		}
@@ -484,7 +521,7 @@ public:
 	 * @param number - number to subtract.
 	 * @return Vector resulting from number subtraction.
 	 */
-	vector operator-(T number)noexcept{
+	constexpr vector operator-(T number)noexcept{
 		return (vector(*this) -= number);
 	}	
 
@@ -492,7 +529,7 @@ public:
 	 * @brief Unary minus.
 	 * @return Negated vector.
 	 */
-	vector operator-()const noexcept{
+	constexpr vector operator-()const noexcept{
 		return vector(*this).negate();
 	}
 
@@ -502,7 +539,13 @@ public:
 	 * @param num - scalar to multiply by.
 	 * @return Reference to this vector object.
 	 */
-	vector& operator*=(T num)noexcept{
+	constexpr vector& operator*=(T num)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::mul(simd_kernel::load(this->data()), simd_kernel::set(num)));
+				return *this;
+			}
+		}
 		for(auto& c : *this){
 			c *= num;
 		}
@@ -515,7 +558,7 @@ public:
 	 * @param num - scalar to multiply by.
 	 * @return Vector resulting from multiplication of this vector by scalar.
 	 */
-	vector operator*(T num)const noexcept{
+	constexpr vector operator*(T num)const noexcept{
 		return (vector(*this) *= num);
 	}
 
@@ -525,7 +568,7 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Vector resulting from division of this vector by scalar.
 	 */
-	vector operator/(T num)const noexcept{
+	constexpr vector operator/(T num)const noexcept{
 		return vector(*this) /= num;
 	}
 
@@ -535,7 +578,7 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from multiplication of given scalar by given vector.
 	 */
-	friend vector operator*(T num, const vector& vec)noexcept{
+	friend constexpr vector operator*(T num, const vector& vec)noexcept{
 		return vec * num;
 	}
 
@@ -545,8 +588,14 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Reference to this vector object.
 	 */
-	vector& operator/=(T num)noexcept{
-		ASSERT_INFO(num != 0, "vector::operator/=(): division by 0")
+	constexpr vector& operator/=(T num)noexcept{
+		ASSERT(num != 0)
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::div(simd_kernel::load(this->data()), simd_kernel::set(num)));
+				return *this;
+			}
+		}
 		for(auto& c : *this){
 			c /= num;
 		}
@@ -559,8 +608,8 @@ public:
 	 * @param num - scalar to divide by.
 	 * @return Vector resulting from division of this vector by scalars.
 	 */
-	vector operator/(T num)noexcept{
-		ASSERT_INFO(num != 0, "vector::operator/(): division by 0")
+	constexpr vector operator/(T num)noexcept{
+		ASSERT(num != 0)
 		return (vector(*this) /= num);
 	}
 
@@ -569,10 +618,15 @@ public:
 	 * @param vec -vector to multiply by.
 	 * @return Dot product of this vector and given vector.
 	 */
-	T operator*(const vector& vec)const noexcept{
+	constexpr T operator*(const vector& vec)const noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				return simd_kernel::hsum(simd_kernel::mul(simd_kernel::load(this->data()), simd_kernel::load(vec.data())));
+			}
+		}
 		T res = 0;
 		for(size_t i = 0; i != S; ++i){
-			res += this->operator[](i) * vec[i];
+			res = internal::mul_add(this->operator[](i), vec[i], res);
 		}
 		return res;
 	}
@@ -585,21 +639,21 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Four-dimensional vector resulting from the cross product.
 	 */
-	template <typename E = vector> std::enable_if_t<S >= 3, E> operator%(const vector& vec)const noexcept{
+	template <typename E = vector> constexpr std::enable_if_t<S >= 3, E> operator%(const vector& vec)const noexcept{
 		static_assert(S >= 3, "cross product makes no sense for vectors with less than 3 components");
 		if constexpr (S == 3){
-			return vector{
+			return vector(
 					this->y() * vec.z() - this->z() * vec.y(),
 					this->z() * vec.x() - this->x() * vec.z(),
 					this->x() * vec.y() - this->y() * vec.x()
-				};
+				);
 		}else{
-			return vector{
+			return vector(
 				this->y() * vec.z() - this->z() * vec.y(),
 				this->z() * vec.x() - this->x() * vec.z(),
 				this->x() * vec.y() - this->y() * vec.x(),
 				this->w() * vec.w()
-			};
+			);
 		}
 	}
 
@@ -610,8 +664,14 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return Vector resulting from component-wise multiplication.
 	 */
-	vector comp_mul(const vector& vec)const noexcept{
-		vector res;
+	constexpr vector comp_mul(const vector& vec)const noexcept{
+		vector res{};
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(res.data(), simd_kernel::mul(simd_kernel::load(this->data()), simd_kernel::load(vec.data())));
+				return res;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			res[i] = this->operator[](i) * vec[i];
 		}
@@ -625,7 +685,13 @@ public:
 	 * @param vec - vector to multiply by.
 	 * @return reference to this vector.
 	 */
-	vector& comp_multiply(const vector& vec)noexcept{
+	constexpr vector& comp_multiply(const vector& vec)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::mul(simd_kernel::load(this->data()), simd_kernel::load(vec.data())));
+				return *this;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			this->operator[](i) *= vec[i];
 		}
@@ -640,8 +706,14 @@ public:
 	 * @param v - vector to divide by.
 	 * @return Vector resulting from component-wise division.
 	 */
-	vector comp_div(const vector& v)const noexcept{
-		vector res;
+	constexpr vector comp_div(const vector& v)const noexcept{
+		vector res{};
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(res.data(), simd_kernel::div(simd_kernel::load(this->data()), simd_kernel::load(v.data())));
+				return res;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			res[i] = this->operator[](i) / v[i];
 		}
@@ -655,7 +727,13 @@ public:
 	 * @param v - vector to divide by.
 	 * @return reference to this vector instance.
 	 */
-	vector& comp_divide(const vector& v)noexcept{
+	constexpr vector& comp_divide(const vector& v)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::div(simd_kernel::load(this->data()), simd_kernel::load(v.data())));
+				return *this;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
 			this->operator[](i) /= v[i];
 		}
@@ -667,7 +745,13 @@ public:
 	 * Negates this vector.
 	 * @return Reference to this vector object.
 	 */
-	vector& negate()noexcept{
+	constexpr vector& negate()noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::neg(simd_kernel::load(this->data())));
+				return *this;
+			}
+		}
 		for(auto& c : *this){
 			c = -c;
 		}
@@ -678,10 +762,16 @@ public:
 	 * @brief Calculate power 2 of vector norm.
 	 * @return Power 2 of this vector norm.
 	 */
-	T norm_pow2()const noexcept{
+	constexpr T norm_pow2()const noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				auto v = simd_kernel::load(this->data());
+				return simd_kernel::hsum(simd_kernel::mul(v, v));
+			}
+		}
 		T res = 0;
 		for(size_t i = 0; i != S; ++i){
-			res += utki::pow2(this->operator[](i));
+			res = internal::mul_add(this->operator[](i), this->operator[](i), res);
 		}
 		return res;
 	}
@@ -690,8 +780,8 @@ public:
 	 * @brief Calculate vector norm.
 	 * @return Vector norm.
 	 */
-	T norm()const noexcept{
-		return sqrt(this->norm_pow2());
+	constexpr T norm()const noexcept{
+		return internal::sqrt(this->norm_pow2());
 	}
 
 	/**
@@ -700,7 +790,7 @@ public:
 	 * If norm is 0 then the result is vector (1, 0, 0, 0).
 	 * @return Reference to this vector object.
 	 */
-	vector& normalize()noexcept{
+	constexpr vector& normalize()noexcept{
 		T mag = this->norm();
 		if(mag == 0){
 			this->x() = 1;
@@ -710,17 +800,48 @@ public:
 			return *this;
 		}
 
-		return (*this) /= this->norm();
+		return (*this) /= mag;
 	}
 
 	/**
 	 * @brief Calculate normalized vector.
 	 * @return normalized vector.
 	 */
-	vector normed()const noexcept{
+	constexpr vector normed()const noexcept{
 		return vector(*this).normalize();
 	}
 
+	/**
+	 * @brief Normalize this vector, fast version.
+	 * Defined only for floating point vectors.
+	 * Same as normalize(), but instead of division by the norm the vector is multiplied by
+	 * reciprocal of the norm, which is calculated by internal::rsqrt().
+	 * For float vectors the relative error of the resulting norm is below 2^-21, i.e. the result
+	 * differs from the one of normalize() by a few ULPs. For double vectors the error is same as of normalize().
+	 * Vectors with power 2 of norm below std::numeric_limits<T>::min() are normalized by normalize(),
+	 * so zero vector becomes (1, 0, 0, 0).
+	 * On CPUs with fast square root and division the gain for a single vector is small,
+	 * normalizing many vectors with r4::normalize_fast() over a span is considerably faster.
+	 * @return Reference to this vector object.
+	 */
+	template <typename E = T> constexpr std::enable_if_t<std::is_floating_point_v<E>, vector&> normalize_fast()noexcept{
+		T n2 = this->norm_pow2();
+		if(n2 < std::numeric_limits<T>::min()){
+			return this->normalize();
+		}
+		return (*this) *= internal::rsqrt(n2);
+	}
+
+	/**
+	 * @brief Calculate normalized vector, fast version.
+	 * Defined only for floating point vectors.
+	 * See normalize_fast().
+	 * @return normalized vector.
+	 */
+	template <typename E = T> constexpr std::enable_if_t<std::is_floating_point_v<E>, vector> normed_fast()const noexcept{
+		return vector(*this).normalize_fast();
+	}
+
 	/**
 	 * @brief Rotate vector.
 	 * Defined only for 2 component vector.
@@ -729,11 +850,9 @@ public:
 	 * @param angle - angle of rotation in radians.
 	 * @return Reference to this vector object.
 	 */
-	template <typename E = T> vector& rotate(std::enable_if_t<S == 2, E> angle)noexcept{
-		using std::sin;
-		using std::cos;
-		T cosa = cos(angle);
-		T sina = sin(angle);
+	template <typename E = T> constexpr vector& rotate(std::enable_if_t<S == 2, E> angle)noexcept{
+		T cosa = internal::cos(angle);
+		T sina = internal::sin(angle);
 		T tmp = this->x() * cosa - this->y() * sina;
 		this->y() = this->y() * cosa + this->x() * sina;
 		this->x() = tmp;
@@ -748,7 +867,7 @@ public:
 	 * @param angle - angle of rotation in radians.
 	 * @return Vector resulting from rotation of this vector.
 	 */
-	template <typename E = T> vector rot(std::enable_if_t<S == 2, E> angle)const noexcept{
+	template <typename E = T> constexpr vector rot(std::enable_if_t<S == 2, E> angle)const noexcept{
 		return vector(*this).rotate(angle);
 	}
 
@@ -815,7 +934,7 @@ public:
 	 * @return true if all vector components are zero.
 	 * @return false otherwise.
 	 */
-	bool is_zero()const noexcept{
+	constexpr bool is_zero()const noexcept{
 		for(auto& c : *this){
 			if(c != 0){
 				return false;
@@ -829,7 +948,7 @@ public:
 	 * @return true if all vector components are not zero.
 	 * @return false otherwise.
 	 */
-	bool is_not_zero()const noexcept{
+	constexpr bool is_not_zero()const noexcept{
 		for(auto& c : *this){
 			if(c == 0){
 				return false;
@@ -843,7 +962,7 @@ public:
 	 * @return true if all vector components are positive or zero.
 	 * @return false otherwise.
 	 */
-	bool is_positive_or_zero()const noexcept{
+	constexpr bool is_positive_or_zero()const noexcept{
 		for(auto& c : *this){
 			if(c < 0){
 				return false;
@@ -857,7 +976,7 @@ public:
 	 * @return true if all vector components are positive.
 	 * @return false otherwise.
 	 */
-	bool is_positive()const noexcept{
+	constexpr bool is_positive()const noexcept{
 		for(auto& c : *this){
 			if(c <= 0){
 				return false;
@@ -871,7 +990,7 @@ public:
 	 * @return true if all vector components are negative.
 	 * @return false otherwise.
 	 */
-	bool is_negative()const noexcept{
+	constexpr bool is_negative()const noexcept{
 		for(auto& c : *this){
 			if(c >= 0){
 				return false;
@@ -880,16 +999,85 @@ public:
 		return true;
 	}
 
+	/**
+	 * @brief Multiply-add.
+	 * Adds component-wise product of two vectors to this vector, i.e. this = a.comp_mul(b) + this.
+	 * In case the hardware supports fused multiply-add the operation is done with single rounding.
+	 * @param a - vector to multiply.
+	 * @param b - vector to multiply by.
+	 * @return Reference to this vector object.
+	 */
+	constexpr vector& mul_add(const vector& a, const vector& b)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::fma(simd_kernel::load(a.data()), simd_kernel::load(b.data()), simd_kernel::load(this->data())));
+				return *this;
+			}
+		}
+		for(size_t i = 0; i != S; ++i){
+			this->operator[](i) = internal::mul_add(a[i], b[i], this->operator[](i));
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Multiply-add.
+	 * Adds product of a vector and a scalar to this vector, i.e. this = a * b + this.
+	 * In case the hardware supports fused multiply-add the operation is done with single rounding.
+	 * @param a - vector to multiply.
+	 * @param b - scalar to multiply by.
+	 * @return Reference to this vector object.
+	 */
+	constexpr vector& mul_add(const vector& a, T b)noexcept{
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(this->data(), simd_kernel::fma(simd_kernel::load(a.data()), simd_kernel::set(b), simd_kernel::load(this->data())));
+				return *this;
+			}
+		}
+		for(size_t i = 0; i != S; ++i){
+			this->operator[](i) = internal::mul_add(a[i], b, this->operator[](i));
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Fused multiply-add.
+	 * @param a - vector to multiply.
+	 * @param b - vector to multiply by.
+	 * @param c - vector to add.
+	 * @return a.comp_mul(b) + c.
+	 */
+	friend constexpr vector fma(const vector& a, const vector& b, const vector& c)noexcept{
+		return vector(c).mul_add(a, b);
+	}
+
+	/**
+	 * @brief Fused multiply-add.
+	 * @param a - vector to multiply.
+	 * @param b - scalar to multiply by.
+	 * @param c - vector to add.
+	 * @return a * b + c.
+	 */
+	friend constexpr vector fma(const vector& a, T b, const vector& c)noexcept{
+		return vector(c).mul_add(a, b);
+	}
+
 	/**
 	 * @brief Absolute vector value.
 	 * @param v - vector to take absolute value of.
 	 * @return vector holding absolute values of this vector's components.
 	 */
-	friend vector abs(const vector& v)noexcept{
-		using std::abs;
-		vector ret;
+	friend constexpr vector abs(const vector& v)noexcept{
+		vector ret{};
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(ret.data(), simd_kernel::abs(simd_kernel::load(v.data())));
+				return ret;
+			}
+		}
 		for(size_t i = 0; i != S; ++i){
-			ret[i] = abs(v[i]);
+			ret[i] = internal::abs(v[i]);
 		}
 		return ret;
 	}
@@ -899,7 +1087,7 @@ public:
 	 * @param vec - vector to project onto, it does not have to be normalized.
 	 * @return Reference to this vector object.
 	 */
-	vector& project(const vector& vec)noexcept{
+	constexpr vector& project(const vector& vec)noexcept{
 		ASSERT(this->norm_pow2() != 0)
 		(*this) = vec * (vec * (*this)) / vec.norm_pow2();
 		return *this;
@@ -911,7 +1099,7 @@ public:
 	 * @param q - quaternion which defines the rotation.
 	 * @return Reference to this vector object.
 	 */
-	template <typename E = T> vector& rotate(const quaternion<std::enable_if_t<S == 3 || S == 4, E>>& q)noexcept;
+	template <typename E = T> constexpr vector& rotate(const quaternion<std::enable_if_t<S == 3 || S == 4, E>>& q)noexcept;
 
 	/**
 	 * @brief Get component-wise minimum of two vectors.
@@ -919,9 +1107,15 @@ public:
 	 * @param vb - second vector.
 	 * @return vector whose components are component-wise minimum of initial vectors.
 	 */
-	friend vector min(const vector& va, const vector& vb)noexcept{
+	friend constexpr vector min(const vector& va, const vector& vb)noexcept{
+		vector ret{};
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(ret.data(), simd_kernel::min(simd_kernel::load(va.data()), simd_kernel::load(vb.data())));
+				return ret;
+			}
+		}
 		using std::min;
-		vector ret;
 		for(size_t i = 0; i != S; ++i){
 			ret[i] = min(va[i], vb[i]);
 		}
@@ -934,9 +1128,15 @@ public:
 	 * @param vb - second vector.
 	 * @return vector whose components are component-wise maximum of initial vectors.
 	 */
-	friend vector max(const vector& va, const vector& vb)noexcept{
+	friend constexpr vector max(const vector& va, const vector& vb)noexcept{
+		vector ret{};
+		if constexpr (simd_kernel::enabled){
+			if(!internal::is_constant_evaluated()){
+				simd_kernel::store(ret.data(), simd_kernel::max(simd_kernel::load(va.data()), simd_kernel::load(vb.data())));
+				return ret;
+			}
+		}
 		using std::max;
-		vector ret;
 		for(size_t i = 0; i != S; ++i){
 			ret[i] = max(va[i], vb[i]);
 		}
@@ -968,9 +1168,107 @@ namespace r4{
 
 template <class T, size_t S>
 template <typename E>
-vector<T, S>& vector<T, S>::rotate(const quaternion<std::enable_if_t<S == 3 || S == 4, E>>& q)noexcept{
-	*this = q.template to_matrix<S>() * (*this);
+constexpr vector<T, S>& vector<T, S>::rotate(const quaternion<std::enable_if_t<S == 3 || S == 4, E>>& q)noexcept{
+	// Rotation of vector v by unit quaternion q = (u, w), where u is the vector part, is
+	// v' = q * v * q^-1 = v + 2w(u x v) + 2u x (u x v).
+	// With t = 2(u x v) it becomes v' = v + w * t + u x t.
+	T x = this->x();
+	T y = this->y();
+	T z = this->z();
+
+	T tx = T(2) * (q.y() * z - q.z() * y);
+	T ty = T(2) * (q.z() * x - q.x() * z);
+	T tz = T(2) * (q.x() * y - q.y() * x);
+
+	this->x() = x + q.w() * tx + (q.y() * tz - q.z() * ty);
+	this->y() = y + q.w() * ty + (q.z() * tx - q.x() * tz);
+	this->z() = z + q.w() * tz + (q.x() * ty - q.y() * tx);
 	return *this;
 }
 
+/**
+ * @brief Rotate vectors.
+ * Rotate each vector of the given span with the same unit quaternion.
+ * The quaternion is converted to a rotation matrix only once for the whole span,
+ * after that each vector is rotated by multiplying it by the rotation matrix.
+ * For 4 component vectors only first 3 components are rotated.
+ * @param vecs - vectors to rotate.
+ * @param q - unit quaternion which defines the rotation.
+ */
+template <class T, size_t S>
+std::enable_if_t<S == 3 || S == 4> rotate(utki::span<vector<T, S>> vecs, const quaternion<T>& q)noexcept{
+	auto m = q.template to_matrix<3>();
+
+	for(auto& vec : vecs){
+		T x = vec.x();
+		T y = vec.y();
+		T z = vec.z();
+		vec.x() = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+		vec.y() = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+		vec.z() = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+	}
+}
+
+/**
+ * @brief Batch fast normalization.
+ * Defined only for floating point vectors.
+ * Normalizes each vector of the span, see vector::normalize_fast().
+ * Reciprocals of the norms are calculated for 4 vectors at once.
+ * @param vecs - vectors to normalize.
+ */
+template <class T, size_t S>
+std::enable_if_t<std::is_floating_point_v<T>> normalize_fast(utki::span<vector<T, S>> vecs)noexcept{
+	internal::normalize_fast(vecs);
+}
+
+namespace internal{
+
+// Returns component-wise minimum and maximum of non-empty span of 2d points.
+template <class T> std::pair<vector<T, 2>, vector<T, 2>> min_max(utki::span<const vector<T, 2>> points)noexcept{
+	ASSERT(!points.empty())
+
+	vector<T, 2> lo = points[0];
+	vector<T, 2> hi = points[0];
+
+	size_t i = 0;
+
+	if constexpr (simd::kernel<T, 4>::enabled){
+		typedef simd::kernel<T, 4> simd_kernel;
+		static_assert(sizeof(vector<T, 2>) == 2 * sizeof(T), "2d vectors are expected to be tightly packed");
+
+		// each register holds two points, two pairs of accumulators hide latency of min/max instructions
+		if(points.size() >= 4){
+			const T* p = points[0].data();
+			auto min0 = simd_kernel::load(p);
+			auto max0 = min0;
+			auto min1 = min0;
+			auto max1 = min0;
+			for(; i + 4 <= points.size(); i += 4){
+				auto a = simd_kernel::load(p + i * 2);
+				auto b = simd_kernel::load(p + i * 2 + 4);
+				min0 = simd_kernel::min(min0, a);
+				max0 = simd_kernel::max(max0, a);
+				min1 = simd_kernel::min(min1, b);
+				max1 = simd_kernel::max(max1, b);
+			}
+
+			// horizontal reduction of the two points held in each register
+			std::array<T, 4> r;
+			simd_kernel::store(r.data(), simd_kernel::min(min0, min1));
+			lo = min(vector<T, 2>(r[0], r[1]), vector<T, 2>(r[2], r[3]));
+			simd_kernel::store(r.data(), simd_kernel::max(max0, max1));
+			hi = max(vector<T, 2>(r[0], r[1]), vector<T, 2>(r[2], r[3]));
+		}
+	}
+
+	for(; i < points.size(); ++i){
+		lo = min(lo, points[i]);
+		hi = max(hi, points[i]);
+	}
+
+	return std::make_pair(lo, hi);
+}
+
+}
+
 }
@@ -0,0 +1,65 @@
+#include "../../../src/r4/aligned.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_vectors = 1024;
+
+template <typename T> r4::matrix4<T> make_matrix(){
+	r4::matrix4<T> m;
+	m.set_identity();
+	m.translate(T(3), T(-4), T(5));
+	m.rotate(r4::vector3<T>(T(0.3), T(-0.2), T(0.7)));
+	return m;
+}
+
+// Fills span of vectors which may start at any address, to compare with aligned arrays.
+template <typename T, typename V> void fill(utki::span<V> vecs){
+	for(size_t i = 0; i != vecs.size(); ++i){
+		vecs[i] = r4::vector4<T>(T(i), T(i % 7), T(i % 13), T(1));
+	}
+}
+
+// Transform benchmarks are per vector.
+template <typename T> void add_aligned_benchmarks(const std::string& type_name){
+	auto m = make_matrix<T>();
+
+	// vectors are shifted by one component from the allocation start, so that some of them cross
+	// cache line boundaries, this is what happens to vector4 arrays inside of other structures
+	bench::add("transform(matrix4<" + type_name + ">, span<vector4>) (unaligned)", [m](size_t n){
+		std::vector<T> buf((num_vectors + 1) * 4);
+		utki::span<r4::vector4<T>> in(reinterpret_cast<r4::vector4<T>*>(buf.data() + 1), num_vectors);
+		fill<T>(in);
+		std::vector<r4::vector4<T>> out(num_vectors);
+		for(size_t i = 0; i < n; i += num_vectors){
+			r4::transform(m, utki::span<const r4::vector4<T>>(in), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("transform(matrix4<" + type_name + ">, span<vector4>)", [m](size_t n){
+		std::vector<r4::vector4<T>> in(num_vectors);
+		fill<T>(utki::make_span(in));
+		std::vector<r4::vector4<T>> out(num_vectors);
+		for(size_t i = 0; i < n; i += num_vectors){
+			r4::transform(m, utki::make_span(std::as_const(in)), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("transform(matrix4<" + type_name + ">, span<aligned_vector4>)", [m](size_t n){
+		std::vector<r4::aligned_vector4<T>> in(num_vectors);
+		fill<T>(utki::make_span(in));
+		std::vector<r4::aligned_vector4<T>> out(num_vectors);
+		for(size_t i = 0; i < n; i += num_vectors){
+			r4::transform(m, utki::make_span(std::as_const(in)), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+const bench::set set([](){
+	add_aligned_benchmarks<float>("float");
+	add_aligned_benchmarks<double>("double");
+});
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench{
+
+/**
+ * @brief Benchmark function.
+ * The function has to perform the benchmarked operation given number of times.
+ */
+typedef std::function<void(size_t num_iterations)> function_type;
+
+struct result{
+	std::string name;
+	size_t num_iterations;
+	double ns_per_op;
+
+	double ops_per_s()const noexcept{
+		return 1e9 / this->ns_per_op;
+	}
+};
+
+/**
+ * @brief Register benchmark.
+ * @param name - benchmark name.
+ * @param func - benchmark function.
+ */
+void add(std::string name, function_type func);
+
+/**
+ * @brief Prevent compiler from optimizing away the value computation.
+ * @param v - value which is a result of the benchmarked computation.
+ */
+template <typename T> inline void do_not_optimize(const T& v){
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "m"(v) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &v;
+#endif
+}
+
+/**
+ * @brief Prevent compiler from assuming the value does not change.
+ * Used on benchmark input values so that the benchmarked computation cannot be hoisted out of the loop.
+ * @param v - value which is an input of the benchmarked computation.
+ */
+template <typename T> inline void do_not_optimize(T& v){
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : "+m"(v) : : "memory");
+#else
+	static volatile void* sink;
+	sink = &v;
+#endif
+}
+
+/**
+ * @brief Helper to register benchmarks from static initializers.
+ */
+struct set{
+	set(std::function<void()> register_benchmarks){
+		register_benchmarks();
+	}
+};
+
+}
@@ -0,0 +1,93 @@
+#include "../../../src/r4/bvh.hpp"
+
+#include "bench.hpp"
+
+#include "../../common/lcg.hpp"
+
+namespace{
+const size_t num_rects = 20000;
+
+std::vector<r4::rectangle<float>> make_rects(){
+	std::vector<r4::rectangle<float>> ret;
+	r4_tests::lcg rnd(1);
+	for(size_t i = 0; i != num_rects; ++i){
+		ret.push_back(r4::rectangle<float>(rnd.next(10000.0f), rnd.next(10000.0f), rnd.next(50.0f), rnd.next(50.0f)));
+	}
+	return ret;
+}
+
+r4::vector2<float> query_point(size_t i){
+	return r4::vector2<float>(float(i * 7919 % 10000), float(i * 104729 % 10000));
+}
+
+// all query benchmarks are per query
+const bench::set set([](){
+	bench::add("bvh<float> point query", [](size_t n){
+		auto rects = make_rects();
+		r4::bvh<float> tree(utki::make_span(rects));
+		size_t num_found = 0;
+		for(size_t i = 0; i != n; ++i){
+			tree.query(query_point(i), [&num_found](size_t){++num_found;});
+		}
+		bench::do_not_optimize(num_found);
+	});
+
+	bench::add("bvh<float> point query (incrementally built)", [](size_t n){
+		auto rects = make_rects();
+		r4::bvh<float> tree;
+		for(const auto& r : rects){
+			tree.insert(r);
+		}
+		size_t num_found = 0;
+		for(size_t i = 0; i != n; ++i){
+			tree.query(query_point(i), [&num_found](size_t){++num_found;});
+		}
+		bench::do_not_optimize(num_found);
+	});
+
+	bench::add("linear scan point query", [](size_t n){
+		auto rects = make_rects();
+		size_t num_found = 0;
+		for(size_t i = 0; i != n; ++i){
+			auto p = query_point(i);
+			for(const auto& r : rects){
+				if(r.overlaps(p)){
+					++num_found;
+				}
+			}
+		}
+		bench::do_not_optimize(num_found);
+	});
+
+	bench::add("bvh<float> rectangle query", [](size_t n){
+		auto rects = make_rects();
+		r4::bvh<float> tree(utki::make_span(rects));
+		size_t num_found = 0;
+		for(size_t i = 0; i != n; ++i){
+			tree.query(r4::rectangle<float>(query_point(i), r4::vector2<float>(100, 100)), [&num_found](size_t){++num_found;});
+		}
+		bench::do_not_optimize(num_found);
+	});
+
+	bench::add("bvh<float> nearest 8", [](size_t n){
+		auto rects = make_rects();
+		r4::bvh<float> tree(utki::make_span(rects));
+		std::array<size_t, 8> found;
+		for(size_t i = 0; i != n; ++i){
+			tree.nearest(query_point(i), utki::make_span(found));
+			bench::do_not_optimize(found);
+		}
+	});
+
+	bench::add("bvh<float>::update", [](size_t n){
+		auto rects = make_rects();
+		r4::bvh<float> tree(utki::make_span(rects));
+		for(size_t i = 0; i != n; ++i){
+			size_t id = i % num_rects;
+			rects[id].p += r4::vector2<float>(1, -1);
+			tree.update(id, rects[id]);
+		}
+		bench::do_not_optimize(tree);
+	});
+});
+}
@@ -0,0 +1,105 @@
+#include "../../../src/r4/clip.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_points = 4096;
+
+template <class T> std::vector<r4::vector2<T>> make_points(){
+	std::vector<r4::vector2<T>> ret;
+	for(size_t i = 0; i != num_points; ++i){
+		ret.emplace_back(T(int(i * 7) % 101 - 50), T(int(i * 13) % 97 - 48));
+	}
+	return ret;
+}
+
+// triangles of size up to 10, each is formed by 3 consecutive points
+template <class T> std::vector<r4::vector2<T>> make_triangles(){
+	std::vector<r4::vector2<T>> ret;
+	for(size_t i = 0; i != num_points / 3; ++i){
+		r4::vector2<T> p(T(int(i * 7) % 101 - 50), T(int(i * 13) % 97 - 48));
+		ret.push_back(p);
+		ret.push_back(p + r4::vector2<T>(T(i % 11), T(i % 3)));
+		ret.push_back(p + r4::vector2<T>(T(i % 5), T(i % 7 + 3)));
+	}
+	return ret;
+}
+
+const r4::rectangle<float> tile(-30, -30, 60, 60);
+
+template <class T> void add_clip_benchmarks(const std::string& type_name){
+	r4::rectangle<T> rect(T(tile.p.x()), T(tile.p.y()), T(tile.d.x()), T(tile.d.y()));
+
+	// outcodes benchmarks are per point
+	bench::add("outcodes(span<vector2<" + type_name + ">>)", [rect](size_t n){
+		auto points = make_points<T>();
+		std::vector<uint8_t> codes(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::outcodes(utki::make_span(std::as_const(points)), rect, utki::make_span(codes));
+			bench::do_not_optimize(codes.front());
+		}
+	});
+
+	bench::add("outcode(vector2<" + type_name + ">) over span (reference)", [rect](size_t n){
+		auto points = make_points<T>();
+		std::vector<uint8_t> codes(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			for(size_t j = 0; j != points.size(); ++j){
+				codes[j] = r4::outcode(points[j], rect);
+			}
+			bench::do_not_optimize(codes.front());
+		}
+	});
+
+	if constexpr (std::is_floating_point_v<T>){
+		// polyline benchmarks are per polyline edge
+		bench::add("clip_polyline(vector2<" + type_name + ">)", [rect](size_t n){
+			auto points = make_points<T>();
+			std::vector<r4::segment2<T>> out(points.size() - 1);
+			for(size_t i = 0; i < n; i += num_points){
+				bench::do_not_optimize(r4::clip_polyline(utki::make_span(std::as_const(points)), rect, utki::make_span(out)));
+			}
+		});
+
+		bench::add("clip(segment2<" + type_name + ">) over polyline (reference)", [rect](size_t n){
+			auto points = make_points<T>();
+			std::vector<r4::segment2<T>> out(points.size() - 1);
+			for(size_t i = 0; i < n; i += num_points){
+				size_t num = 0;
+				for(size_t j = 1; j != points.size(); ++j){
+					out[num] = r4::segment2<T>{points[j - 1], points[j]};
+					if(r4::clip(out[num], rect)){
+						++num;
+					}
+				}
+				bench::do_not_optimize(num);
+			}
+		});
+
+		// polygon benchmark is per triangle
+		bench::add("clip_polygon(triangle<" + type_name + ">)", [rect](size_t n){
+			auto triangles = make_triangles<T>();
+			std::array<r4::vector2<T>, r4::clip_polygon_capacity(3)> out;
+			std::array<r4::vector2<T>, r4::clip_polygon_capacity(3)> buffer;
+			for(size_t i = 0; i < n; ){
+				size_t num = 0;
+				for(size_t j = 0; j != triangles.size() && i < n; j += 3, ++i){
+					num += r4::clip_polygon(
+							utki::make_span(std::as_const(triangles).data() + j, 3),
+							rect,
+							utki::make_span(out),
+							utki::make_span(buffer)
+						);
+				}
+				bench::do_not_optimize(num);
+			}
+		});
+	}
+}
+
+const bench::set set([](){
+	add_clip_benchmarks<float>("float");
+	add_clip_benchmarks<double>("double");
+	add_clip_benchmarks<int>("int");
+});
+}
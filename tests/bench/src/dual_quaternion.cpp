@@ -0,0 +1,89 @@
+#include "../../../src/r4/dual_quaternion.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_bones = 64;
+const size_t num_vertices = 4096;
+
+template <size_t N> struct mesh{
+	std::vector<r4::dual_quaternion<float>> bones;
+	std::vector<r4::matrix4<float>> bone_matrices;
+	std::vector<r4::bone_influences<float, N>> influences;
+	std::vector<r4::vector3<float>> vertices;
+
+	mesh(){
+		for(size_t i = 0; i != num_bones; ++i){
+			this->bones.emplace_back(
+					r4::quaternion<float>(r4::vector3<float>(0.3f * float(i % 7), 0.2f, -0.1f * float(i % 11))),
+					r4::vector3<float>(float(i % 5), float(i % 3) - 1, 0.5f * float(i % 13))
+				);
+			this->bone_matrices.push_back(this->bones.back().to_matrix());
+		}
+		for(size_t i = 0; i != num_vertices; ++i){
+			r4::bone_influences<float, N> inf{};
+			for(size_t j = 0; j != N; ++j){
+				inf.bones[j] = uint32_t((i * 7 + j * 13) % num_bones);
+				inf.weights[j] = 1.0f / float(N);
+			}
+			this->influences.push_back(inf);
+			this->vertices.emplace_back(float(i % 10), float(i % 7), float(i % 3));
+		}
+	}
+};
+
+template <size_t N> void add_skin_benchmarks(){
+	std::string suffix = ", " + std::to_string(N) + " bones per vertex";
+
+	// all benchmarks are per vertex
+	bench::add("skin(span<dual_quaternion<float>>)" + suffix, [](size_t n){
+		mesh<N> m;
+		std::vector<r4::vector3<float>> out(num_vertices);
+		for(size_t i = 0; i < n; i += num_vertices){
+			r4::skin(
+					utki::make_span(std::as_const(m.bones)),
+					utki::make_span(std::as_const(m.influences)),
+					utki::make_span(std::as_const(m.vertices)),
+					utki::make_span(out)
+				);
+			bench::do_not_optimize(out.back());
+		}
+	});
+
+	// linear blend skinning with matrix palette
+	bench::add("matrix palette skinning (reference)" + suffix, [](size_t n){
+		mesh<N> m;
+		std::vector<r4::vector3<float>> out(num_vertices);
+		for(size_t i = 0; i < n; i += num_vertices){
+			for(size_t v = 0; v != num_vertices; ++v){
+				const auto& inf = m.influences[v];
+				// the last row of affine matrix is always (0, 0, 0, 1), so only 3 rows are blended
+				std::array<r4::vector4<float>, 3> b;
+				for(size_t r = 0; r != 3; ++r){
+					b[r] = m.bone_matrices[inf.bones[0]][r] * inf.weights[0];
+					for(size_t j = 1; j != N; ++j){
+						b[r] += m.bone_matrices[inf.bones[j]][r] * inf.weights[j];
+					}
+				}
+				r4::vector4<float> p(m.vertices[v], 1);
+				out[v] = r4::vector3<float>(b[0] * p, b[1] * p, b[2] * p);
+			}
+			bench::do_not_optimize(out.back());
+		}
+	});
+}
+
+const bench::set set([](){
+	add_skin_benchmarks<4>();
+	add_skin_benchmarks<8>();
+
+	bench::add("dual_quaternion<float>::operator%", [](size_t n){
+		r4::dual_quaternion<float> a(r4::quaternion<float>(r4::vector3<float>(0.1f, 0.2f, 0.3f)), r4::vector3<float>(1, 2, 3));
+		auto q = a;
+		for(size_t i = 0; i != n; ++i){
+			q = a % q;
+			bench::do_not_optimize(q);
+		}
+	});
+});
+}
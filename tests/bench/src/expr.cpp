@@ -0,0 +1,90 @@
+#include "../../../src/r4/expr.hpp"
+
+#include "bench.hpp"
+
+using r4::expr::lazy;
+
+namespace{
+const size_t num_particles = 4096;
+
+template <typename T> struct particles{
+	std::vector<r4::vector3<T>> pos;
+	std::vector<r4::vector3<T>> vel;
+	std::vector<r4::vector3<T>> acc;
+
+	particles(){
+		for(size_t i = 0; i != num_particles; ++i){
+			this->pos.push_back(r4::vector3<T>(T(i % 13), T(i % 7), T(i % 5)));
+			this->vel.push_back(r4::vector3<T>(T(i % 3), T(1), T(i % 11)));
+			this->acc.push_back(r4::vector3<T>(T(0), T(-10), T(i % 2)));
+		}
+	}
+};
+
+// all benchmarks are per particle
+template <typename T> void add_integrator_benchmarks(const std::string& type_name){
+	bench::add("pos + vel * dt + acc * (dt * dt / 2), vector3<" + type_name + ">", [](size_t n){
+		particles<T> p;
+		T dt = T(0.01);
+		for(size_t i = 0; i < n; i += num_particles){
+			for(size_t j = 0; j != num_particles; ++j){
+				p.pos[j] = p.pos[j] + p.vel[j] * dt + p.acc[j] * (dt * dt / 2);
+				p.vel[j] += p.acc[j] * dt;
+			}
+			bench::do_not_optimize(p.pos.front());
+		}
+	});
+
+	bench::add("pos + vel * dt + acc * (dt * dt / 2), vector3<" + type_name + "> (expr)", [](size_t n){
+		particles<T> p;
+		T dt = T(0.01);
+		for(size_t i = 0; i < n; i += num_particles){
+			for(size_t j = 0; j != num_particles; ++j){
+				p.pos[j] += lazy(p.vel[j]) * dt + lazy(p.acc[j]) * (dt * dt / 2);
+				p.vel[j] += lazy(p.acc[j]) * dt;
+			}
+			bench::do_not_optimize(p.pos.front());
+		}
+	});
+}
+
+const bench::set set([](){
+	add_integrator_benchmarks<float>("float");
+	add_integrator_benchmarks<double>("double");
+
+	bench::add("a * 2 - b + c / 2, matrix4<float>", [](size_t n){
+		r4::matrix4<float> a;
+		a.set_identity();
+		a.translate(1, 2, 3);
+		r4::matrix4<float> b = a;
+		b.scale(2);
+		r4::matrix4<float> c = b;
+		c.translate(3, 4, 5);
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			r4::matrix4<float> r = a;
+			r *= 2;
+			r = r - b;
+			for(size_t j = 0; j != r.size(); ++j){
+				r[j] += c[j] / 2;
+			}
+			bench::do_not_optimize(r);
+		}
+	});
+
+	bench::add("a * 2 - b + c / 2, matrix4<float> (expr)", [](size_t n){
+		r4::matrix4<float> a;
+		a.set_identity();
+		a.translate(1, 2, 3);
+		r4::matrix4<float> b = a;
+		b.scale(2);
+		r4::matrix4<float> c = b;
+		c.translate(3, 4, 5);
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			r4::matrix4<float> r = lazy(a) * 2.0f - b + lazy(c) / 2.0f;
+			bench::do_not_optimize(r);
+		}
+	});
+});
+}
@@ -0,0 +1,96 @@
+#include "../../../src/r4/frustum.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_objects = 500000;
+
+template <typename T> r4::frustum<T> make_frustum(){
+	r4::matrix4<T> m;
+	m.set_frustum(-1, 1, -1, 1, 1, 100);
+	m.translate(0, 0, -50);
+	m.rotate(r4::vector3<T>(T(0.1), T(0.2), T(0.3)));
+	return r4::frustum<T>(m);
+}
+
+template <typename T> std::vector<r4::vector4<T>> make_spheres(){
+	std::vector<r4::vector4<T>> ret;
+	for(size_t i = 0; i != num_objects; ++i){
+		ret.push_back(r4::vector4<T>(
+				T(int(i * 7) % 161 - 80),
+				T(int(i * 3) % 101 - 50),
+				T(int(i * 11) % 200 - 120),
+				T(i % 4) * T(1.5)
+			));
+	}
+	return ret;
+}
+
+// all culling benchmarks are per object
+template <typename T> void add_cull_benchmarks(const std::string& type_name){
+	bench::add("frustum<" + type_name + ">::overlaps(sphere) (loop)", [](size_t n){
+		auto f = make_frustum<T>();
+		auto spheres = make_spheres<T>();
+		std::vector<uint32_t> mask(f.mask_size(spheres.size()));
+		for(size_t i = 0; i < n; i += num_objects){
+			std::fill(mask.begin(), mask.end(), 0);
+			for(size_t j = 0; j != spheres.size(); ++j){
+				if(f.overlaps(r4::vector3<T>(spheres[j]), spheres[j].w())){
+					mask[j / 32] |= uint32_t(1) << (j % 32);
+				}
+			}
+			bench::do_not_optimize(mask.front());
+		}
+	});
+
+	bench::add("frustum<" + type_name + ">::cull(span<sphere>)", [](size_t n){
+		auto f = make_frustum<T>();
+		auto spheres = make_spheres<T>();
+		std::vector<uint32_t> mask(f.mask_size(spheres.size()));
+		for(size_t i = 0; i < n; i += num_objects){
+			bench::do_not_optimize(f.cull(utki::make_span(spheres), utki::make_span(mask)));
+		}
+	});
+
+	bench::add("frustum<" + type_name + ">::overlaps(box) (loop)", [](size_t n){
+		auto f = make_frustum<T>();
+		auto spheres = make_spheres<T>();
+		std::vector<r4::vector3<T>> min;
+		std::vector<r4::vector3<T>> max;
+		for(const auto& s : spheres){
+			min.push_back(r4::vector3<T>(s) - s.w());
+			max.push_back(r4::vector3<T>(s) + s.w());
+		}
+		std::vector<uint32_t> mask(f.mask_size(spheres.size()));
+		for(size_t i = 0; i < n; i += num_objects){
+			std::fill(mask.begin(), mask.end(), 0);
+			for(size_t j = 0; j != min.size(); ++j){
+				if(f.overlaps(min[j], max[j])){
+					mask[j / 32] |= uint32_t(1) << (j % 32);
+				}
+			}
+			bench::do_not_optimize(mask.front());
+		}
+	});
+
+	bench::add("frustum<" + type_name + ">::cull(span<box>)", [](size_t n){
+		auto f = make_frustum<T>();
+		auto spheres = make_spheres<T>();
+		std::vector<r4::vector3<T>> min;
+		std::vector<r4::vector3<T>> max;
+		for(const auto& s : spheres){
+			min.push_back(r4::vector3<T>(s) - s.w());
+			max.push_back(r4::vector3<T>(s) + s.w());
+		}
+		std::vector<uint32_t> mask(f.mask_size(spheres.size()));
+		for(size_t i = 0; i < n; i += num_objects){
+			bench::do_not_optimize(f.cull(utki::make_span(min), utki::make_span(max), utki::make_span(mask)));
+		}
+	});
+}
+
+const bench::set set([](){
+	add_cull_benchmarks<float>("float");
+	add_cull_benchmarks<double>("double");
+});
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+#include "../../../src/r4/simd.hpp"
+
+#include "bench.hpp"
+
+namespace{
+std::map<std::string, bench::function_type>& get_registry(){
+	static std::map<std::string, bench::function_type> registry;
+	return registry;
+}
+
+// minimal time for one measurement
+const std::chrono::milliseconds min_measurement_time(200);
+
+bench::result measure(const std::string& name, const bench::function_type& func){
+	using clock = std::chrono::steady_clock;
+
+	// warm up caches
+	func(1);
+
+	for(size_t n = 1;; n *= 2){
+		auto start = clock::now();
+		func(n);
+		auto duration = clock::now() - start;
+
+		if(duration >= min_measurement_time){
+			return bench::result{
+				name,
+				n,
+				double(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / double(n)
+			};
+		}
+	}
+}
+}
+
+void bench::add(std::string name, function_type func){
+	get_registry().insert(std::make_pair(std::move(name), std::move(func)));
+}
+
+namespace{
+// name of the SIMD instruction set used by r4, it is included in JSON output,
+// since results measured with different instruction sets are not comparable
+const char* simd_name(){
+#if defined(R4_SIMD_AVX)
+	return "avx";
+#elif defined(R4_SIMD_SSE2)
+	return "sse2";
+#elif defined(R4_SIMD_NEON64)
+	return "neon64";
+#elif defined(R4_SIMD_NEON)
+	return "neon";
+#else
+	return "none";
+#endif
+}
+
+std::string escape_json(const std::string& str){
+	std::string ret;
+	for(auto c : str){
+		if(c == '"' || c == '\\'){
+			ret += '\\';
+		}
+		ret += c;
+	}
+	return ret;
+}
+
+void print_json(std::ostream& o, const std::vector<bench::result>& results){
+	o << "{" << std::endl;
+	o << "  \"simd\": \"" << simd_name() << "\"," << std::endl;
+	o << "  \"benchmarks\": [";
+	for(auto i = results.begin(); i != results.end(); ++i){
+		o << (i == results.begin() ? "" : ",") << std::endl;
+		o << "    {"
+				<< "\"name\": \"" << escape_json(i->name) << "\", "
+				<< "\"iterations\": " << i->num_iterations << ", "
+				<< std::setprecision(3) << std::fixed
+				<< "\"ns_per_op\": " << i->ns_per_op << ", "
+				<< std::setprecision(0)
+				<< "\"ops_per_s\": " << i->ops_per_s()
+				<< "}";
+	}
+	o << std::endl << "  ]" << std::endl;
+	o << "}" << std::endl;
+}
+}
+
+int main(int argc, char** argv){
+	// Arguments are optional, those are:
+	// --json - print results in JSON format to stdout, human readable results are printed to stderr in this case,
+	// any other argument is a substring of benchmark names to run.
+	bool json = false;
+	std::string filter;
+	for(int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if(arg == "--json"){
+			json = true;
+		}else{
+			filter = arg;
+		}
+	}
+
+	std::ostream& o = json ? std::cerr : std::cout;
+
+	std::vector<bench::result> results;
+
+	for(const auto& b : get_registry()){
+		if(b.first.find(filter) == std::string::npos){
+			continue;
+		}
+
+		auto r = measure(b.first, b.second);
+
+		o << std::left << std::setw(56) << r.name
+				<< std::right << std::setw(12) << std::fixed << std::setprecision(2) << r.ns_per_op << " ns/op"
+				<< std::setw(16) << std::setprecision(0) << r.ops_per_s() << " ops/s"
+				<< std::endl;
+
+		results.push_back(std::move(r));
+	}
+
+	if(json){
+		print_json(std::cout, results);
+	}
+
+	return 0;
+}
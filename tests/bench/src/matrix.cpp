@@ -0,0 +1,351 @@
+#include "../../../src/r4/matrix.hpp"
+
+#include "bench.hpp"
+
+namespace{
+template <typename T, size_t N> r4::matrix<T, N - 1, N - 1> sub_matrix(const r4::matrix<T, N, N>& m, size_t row, size_t col){
+	r4::matrix<T, N - 1, N - 1> ret;
+	for(size_t r = 0; r != N - 1; ++r){
+		for(size_t c = 0; c != N - 1; ++c){
+			ret[r][c] = m[r < row ? r : r + 1][c < col ? c : c + 1];
+		}
+	}
+	return ret;
+}
+
+// Reference implementation of determinant calculation by recursive Laplace expansion,
+// used to compare the closed-form implementation with.
+template <typename T, size_t N> T laplace_det(const r4::matrix<T, N, N>& m){
+	if constexpr (N == 1){
+		return m[0][0];
+	}else{
+		T ret = 0;
+		T sign = 1;
+		for(size_t i = 0; i != N; ++i, sign = -sign){
+			ret += sign * m[0][i] * laplace_det(sub_matrix(m, 0, i));
+		}
+		return ret;
+	}
+}
+
+// Reference implementation of matrix inversion through matrix of minors.
+template <typename T, size_t N> r4::matrix<T, N, N> laplace_inv(const r4::matrix<T, N, N>& m){
+	r4::matrix<T, N, N> mm;
+	for(size_t r = 0; r != N; ++r){
+		T sign = r % 2 == 0 ? T(1) : T(-1);
+		for(size_t c = 0; c != N; ++c){
+			mm[r][c] = sign * laplace_det(sub_matrix(m, r, c));
+			sign = -sign;
+		}
+	}
+	mm.transpose();
+	mm /= laplace_det(m);
+	return mm;
+}
+
+template <typename T, size_t N> r4::matrix<T, N, N> make_matrix(){
+	r4::matrix<T, N, N> m;
+	for(size_t r = 0; r != N; ++r){
+		for(size_t c = 0; c != N; ++c){
+			m[r][c] = T((r * N + c * 7) % 11 + (r == c ? 10 : 0));
+		}
+	}
+	return m;
+}
+
+template <typename T, size_t N> void add_det_inv_benchmarks(const std::string& type_name){
+	std::string name = "matrix" + std::to_string(N) + "<" + type_name + ">::";
+
+	bench::add(name + "det", [](size_t n){
+		auto m = make_matrix<T, N>();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(m.det());
+		}
+	});
+
+	bench::add(name + "det (laplace reference)", [](size_t n){
+		auto m = make_matrix<T, N>();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(laplace_det(m));
+		}
+	});
+
+	bench::add(name + "inv", [](size_t n){
+		auto m = make_matrix<T, N>();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(m.inv());
+		}
+	});
+
+	bench::add(name + "inv (laplace reference)", [](size_t n){
+		auto m = make_matrix<T, N>();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(laplace_inv(m));
+		}
+	});
+}
+
+const size_t num_points = 4096;
+
+// all transform benchmarks are per point
+template <typename T> void add_transform_benchmarks(const std::string& type_name){
+	r4::matrix4<T> m;
+	m.set_identity();
+	m.translate(1, 2, 3);
+	m.rotate(r4::vector3<T>(T(0.1), T(0.2), T(0.3)));
+
+	std::vector<r4::vector3<T>> points;
+	for(size_t i = 0; i != num_points; ++i){
+		points.push_back(r4::vector3<T>(T(i % 13), T(i % 7) - 3, T(i % 5) / 2));
+	}
+
+	bench::add("matrix4<" + type_name + "> * vector3 (loop)", [m, points](size_t n){
+		std::vector<r4::vector3<T>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			for(size_t j = 0; j != points.size(); ++j){
+				out[j] = m * r4::vector4<T>(points[j]);
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("transform(matrix4<" + type_name + ">, span<vector3>)", [m, points](size_t n){
+		std::vector<r4::vector3<T>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::transform(m, utki::make_span(points), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("project(matrix4<" + type_name + ">, span<vector3>)", [m, points](size_t n){
+		std::vector<r4::vector3<T>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::project(m, utki::make_span(points), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("transform(matrix4<" + type_name + ">, span<vector4>)", [m, points](size_t n){
+		std::vector<r4::vector4<T>> in;
+		for(const auto& p : points){
+			in.push_back(r4::vector4<T>(p));
+		}
+		std::vector<r4::vector4<T>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::transform(m, utki::make_span(in), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("transform(matrix2<" + type_name + ">, span<vector2>)", [points](size_t n){
+		r4::matrix2<T> m2;
+		m2.set_identity();
+		m2.rotate(T(0.3));
+		m2.translate(T(1), T(2));
+		std::vector<r4::vector2<T>> in;
+		for(const auto& p : points){
+			in.push_back(r4::vector2<T>(p.x(), p.y()));
+		}
+		std::vector<r4::vector2<T>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::transform(m2, utki::make_span(in), utki::make_span(out));
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+const size_t batch_size = 1024;
+
+template <typename T, size_t R, size_t C> std::vector<r4::matrix<T, R, C>> make_matrices(size_t seed){
+	std::vector<r4::matrix<T, R, C>> ret(batch_size);
+	for(size_t i = 0; i != ret.size(); ++i){
+		for(size_t r = 0; r != R; ++r){
+			for(size_t c = 0; c != C; ++c){
+				ret[i][r][c] = T((i * 5 + r * C + c * 7 + seed) % 11 + (r == c ? 10 : 0));
+			}
+		}
+	}
+	return ret;
+}
+
+// Adds benchmarks of matrix multiplication, single and batched,
+// batched benchmarks are per matrix of the batch.
+template <typename T, size_t R, size_t C> void add_multiply_benchmarks(const std::string& type_name){
+	std::string name = (R == 2 && C == 3 ? "matrix2" : "matrix" + std::to_string(R)) + "<" + type_name + ">::";
+
+	// 2x3 matrix is multiplied by 2d vector, square matrix by vector of same dimension
+	typedef r4::vector<T, R == C ? C : 2> vector_type;
+
+	bench::add(name + "operator*(matrix)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0).front();
+		auto b = make_matrices<T, R, C>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(a * b);
+		}
+	});
+
+	bench::add(name + "operator*=(matrix)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0).front();
+		auto b = make_matrices<T, R, C>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			auto m = a;
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(m *= b);
+		}
+	});
+
+	bench::add(name + "left_mul(matrix)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0).front();
+		auto b = make_matrices<T, R, C>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			auto m = a;
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(m.left_mul(b));
+		}
+	});
+
+	bench::add(name + "operator*(vector)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0).front();
+		vector_type v(T(1));
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			bench::do_not_optimize(v);
+			bench::do_not_optimize(a * v);
+		}
+	});
+
+	bench::add(name + "operator*(matrix) (batch)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0);
+		auto b = make_matrices<T, R, C>(1);
+		std::vector<r4::matrix<T, R, C>> out(a.size());
+		for(size_t i = 0; i < n; i += batch_size){
+			for(size_t j = 0; j != out.size(); ++j){
+				out[j] = a[j] * b[j];
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add(name + "operator*(vector) (batch)", [](size_t n){
+		auto a = make_matrices<T, R, C>(0).front();
+		std::vector<vector_type> in(batch_size);
+		for(size_t i = 0; i != in.size(); ++i){
+			in[i] = vector_type(T(i % 13));
+		}
+		std::vector<vector_type> out(in.size());
+		for(size_t i = 0; i < n; i += batch_size){
+			for(size_t j = 0; j != out.size(); ++j){
+				out[j] = a * in[j];
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+const size_t num_nodes = 100000;
+
+// Adds benchmark of transform hierarchy concatenation, i.e. calculating world transformation of each node of
+// a scene graph as world transformation of its parent multiplied by the local transformation of the node.
+// Parents always precede their children. The benchmark is per node.
+template <typename T, size_t R, size_t C> void add_hierarchy_benchmarks(const std::string& type_name){
+	std::string name = (R == 2 && C == 3 ? "matrix2" : "matrix" + std::to_string(R)) + "<" + type_name + ">";
+
+	struct scene{
+		std::vector<size_t> parents;
+		std::vector<r4::matrix<T, R, C>> local;
+		std::vector<r4::matrix<T, R, C>> world;
+
+		scene() :
+				parents(num_nodes),
+				world(num_nodes)
+		{
+			auto m = make_matrices<T, R, C>(0);
+			for(size_t i = 0; i != num_nodes; ++i){
+				// pseudo-random parent among preceding nodes
+				this->parents[i] = i == 0 ? 0 : ((i * 2654435761u) >> 8) % i;
+				this->local.push_back(m[i % m.size()]);
+				this->local.back() *= T(0.05);
+			}
+			this->world[0] = this->local[0];
+		}
+	};
+
+	bench::add("hierarchy of " + name + " (operator*)", [](size_t n){
+		scene s;
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 1; j != num_nodes; ++j){
+				s.world[j] = s.world[s.parents[j]] * s.local[j];
+			}
+			bench::do_not_optimize(s.world.back());
+		}
+	});
+
+	bench::add("hierarchy of " + name + " (left_mul)", [](size_t n){
+		scene s;
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 1; j != num_nodes; ++j){
+				s.world[j] = s.local[j];
+				s.world[j].left_mul(s.world[s.parents[j]]);
+			}
+			bench::do_not_optimize(s.world.back());
+		}
+	});
+}
+
+const bench::set set([](){
+	add_hierarchy_benchmarks<float, 4, 4>("float");
+	add_hierarchy_benchmarks<float, 3, 3>("float");
+	add_hierarchy_benchmarks<float, 2, 3>("float");
+	add_hierarchy_benchmarks<double, 4, 4>("double");
+
+	add_transform_benchmarks<float>("float");
+	add_transform_benchmarks<double>("double");
+
+	add_multiply_benchmarks<float, 4, 4>("float");
+	add_multiply_benchmarks<float, 3, 3>("float");
+	add_multiply_benchmarks<float, 2, 3>("float");
+	add_multiply_benchmarks<double, 4, 4>("double");
+	add_multiply_benchmarks<double, 3, 3>("double");
+	add_multiply_benchmarks<double, 2, 3>("double");
+	add_multiply_benchmarks<int, 4, 4>("int");
+	add_multiply_benchmarks<int, 3, 3>("int");
+	add_multiply_benchmarks<int, 2, 3>("int");
+
+	add_det_inv_benchmarks<float, 3>("float");
+	add_det_inv_benchmarks<float, 4>("float");
+	add_det_inv_benchmarks<double, 3>("double");
+	add_det_inv_benchmarks<double, 4>("double");
+	add_det_inv_benchmarks<int, 3>("int");
+	add_det_inv_benchmarks<int, 4>("int");
+
+	bench::add("matrix4<float>::inv_affine", [](size_t n){
+		r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		m.rotate(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(m.inv_affine());
+		}
+	});
+
+	bench::add("matrix2<float>::inv", [](size_t n){
+		r4::matrix2<float> m{
+			{1, 2, 3},
+			{4, 5, 6}
+		};
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(m);
+			bench::do_not_optimize(m.inv());
+		}
+	});
+});
+}
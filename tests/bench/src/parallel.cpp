@@ -0,0 +1,66 @@
+#include <cstdio>
+
+#include "../../../src/r4/parallel.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_points = 1 << 22;
+
+std::vector<r4::vector3<float>> make_points(){
+	std::vector<r4::vector3<float>> ret;
+	ret.reserve(num_points);
+	for(size_t i = 0; i != num_points; ++i){
+		ret.push_back(r4::vector3<float>(float(i % 13), float(i % 7) - 3, float(i % 5) * 0.5f));
+	}
+	return ret;
+}
+
+// thread count is zero padded to keep the benchmarks sorted by it
+std::string threads_suffix(size_t num_threads){
+	std::array<char, 16> buf;
+	std::snprintf(buf.data(), buf.size(), " threads=%02zu", num_threads);
+	return buf.data();
+}
+
+// all benchmarks are per point
+void add_scaling_benchmarks(size_t num_threads){
+	bench::add("parallel_transform(matrix4<float>, span<vector3>)" + threads_suffix(num_threads), [num_threads](size_t n){
+		r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		m.rotate(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		auto points = make_points();
+		std::vector<r4::vector3<float>> out(points.size());
+		for(size_t i = 0; i < n; i += num_points){
+			r4::parallel_transform(m, utki::make_span(points), utki::make_span(out), num_threads);
+			bench::do_not_optimize(out.front());
+		}
+	});
+
+	bench::add("parallel_rotate(span<vector3<float>>, quaternion)" + threads_suffix(num_threads), [num_threads](size_t n){
+		r4::quaternion<float> q(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		auto points = make_points();
+		for(size_t i = 0; i < n; i += num_points){
+			r4::parallel_rotate(utki::make_span(points), q, num_threads);
+			bench::do_not_optimize(points.front());
+		}
+	});
+
+	bench::add("parallel_min_max(span<vector3<float>>)" + threads_suffix(num_threads), [num_threads](size_t n){
+		auto points = make_points();
+		for(size_t i = 0; i < n; i += num_points){
+			bench::do_not_optimize(r4::parallel_min_max(utki::make_span(points), num_threads));
+		}
+	});
+}
+
+const bench::set set([](){
+	// up to at least 32 threads to see the scaling on big machines,
+	// on machines with less cores the extra threads only show the oversubscription overhead
+	size_t max_threads = std::max(size_t(32), size_t(std::thread::hardware_concurrency()));
+	for(size_t t = 1; t <= max_threads; t *= 2){
+		add_scaling_benchmarks(t);
+	}
+});
+}
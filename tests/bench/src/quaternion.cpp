@@ -0,0 +1,114 @@
+#include "../../../src/r4/quaternion.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_bones = 1024;
+
+struct keyframes{
+	std::vector<r4::quaternion<float>> from;
+	std::vector<r4::quaternion<float>> to;
+	std::vector<r4::quaternion<float>> out;
+
+	keyframes(){
+		for(size_t i = 0; i != num_bones; ++i){
+			this->from.push_back(r4::quaternion<float>().set_rotation(r4::vector3<float>(float(i % 7), 1, float(i % 3)).normalize(), float(i % 11) * 0.3f));
+			this->to.push_back(r4::quaternion<float>().set_rotation(r4::vector3<float>(1, float(i % 5), float(i % 13)).normalize(), float(i % 17) * 0.2f));
+		}
+		this->out.resize(num_bones);
+	}
+};
+
+template <typename T> std::vector<r4::quaternion<T>> make_quaternions(size_t seed){
+	std::vector<r4::quaternion<T>> ret;
+	for(size_t i = 0; i != num_bones; ++i){
+		if constexpr (std::is_floating_point_v<T>){
+			ret.push_back(r4::quaternion<T>().set_rotation(r4::vector3<T>(T(i % 7), 1, T((i + seed) % 3)).normalize(), T((i + seed) % 11) * T(0.3)));
+		}else{
+			ret.push_back(r4::quaternion<T>(T(i % 7), T(1), T((i + seed) % 3), T((i + seed) % 11)));
+		}
+	}
+	return ret;
+}
+
+// Adds benchmarks of binary quaternion operation applied to single pair of quaternions
+// and to a batch of quaternion pairs, batched benchmarks are per quaternion pair.
+template <typename T, typename F> void add_op_benchmarks(const std::string& name, F op){
+	bench::add(name, [op](size_t n){
+		auto a = make_quaternions<T>(0).front();
+		auto b = make_quaternions<T>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(op(a, b));
+		}
+	});
+
+	bench::add(name + " (batch)", [op](size_t n){
+		auto a = make_quaternions<T>(0);
+		auto b = make_quaternions<T>(1);
+		std::vector<decltype(op(a.front(), b.front()))> out(a.size());
+		for(size_t i = 0; i < n; i += num_bones){
+			for(size_t j = 0; j != out.size(); ++j){
+				out[j] = op(a[j], b[j]);
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+template <typename T> void add_quaternion_benchmarks(const std::string& type_name){
+	std::string name = "quaternion<" + type_name + ">::";
+
+	add_op_benchmarks<T>(name + "operator%(quaternion)", [](const auto& a, const auto& b){return a % b;});
+	add_op_benchmarks<T>(name + "operator*(quaternion)", [](const auto& a, const auto& b){return a * b;});
+	add_op_benchmarks<T>(name + "to_matrix<3>()", [](const auto& a, const auto&){return a.template to_matrix<3>();});
+	add_op_benchmarks<T>(name + "to_matrix<4>()", [](const auto& a, const auto&){return a.template to_matrix<4>();});
+	if constexpr (std::is_floating_point_v<T>){
+		add_op_benchmarks<T>(name + "slerp()", [](const auto& a, const auto& b){return a.slerp(b, T(0.3));});
+		add_op_benchmarks<T>(name + "nlerp()", [](const auto& a, const auto& b){return a.nlerp(b, T(0.3));});
+		add_op_benchmarks<T>(name + "slerp_fast()", [](const auto& a, const auto& b){return a.slerp_fast(b, T(0.3));});
+		add_op_benchmarks<T>(name + "normalize()", [](const auto& a, const auto&){return r4::quaternion<T>(a).normalize();});
+		add_op_benchmarks<T>(name + "normalize_fast()", [](const auto& a, const auto&){return r4::quaternion<T>(a).normalize_fast();});
+	}
+}
+
+const bench::set set([](){
+	add_quaternion_benchmarks<float>("float");
+	add_quaternion_benchmarks<double>("double");
+	add_quaternion_benchmarks<int>("int");
+
+	// all benchmarks below are per quaternion
+	bench::add("slerp(span<quaternion<float>>)", [](size_t n){
+		keyframes k;
+		for(size_t i = 0; i < n; i += num_bones){
+			r4::slerp(utki::make_span(k.from), utki::make_span(k.to), 0.3f, utki::make_span(k.out));
+			bench::do_not_optimize(k.out.front());
+		}
+	});
+
+	bench::add("nlerp(span<quaternion<float>>)", [](size_t n){
+		keyframes k;
+		for(size_t i = 0; i < n; i += num_bones){
+			r4::nlerp(utki::make_span(k.from), utki::make_span(k.to), 0.3f, utki::make_span(k.out));
+			bench::do_not_optimize(k.out.front());
+		}
+	});
+
+	bench::add("normalize_fast(span<quaternion<float>>)", [](size_t n){
+		keyframes k;
+		for(size_t i = 0; i < n; i += num_bones){
+			r4::normalize_fast(utki::make_span(k.from));
+			bench::do_not_optimize(k.from.front());
+		}
+	});
+
+	bench::add("slerp_fast(span<quaternion<float>>)", [](size_t n){
+		keyframes k;
+		for(size_t i = 0; i < n; i += num_bones){
+			r4::slerp_fast(utki::make_span(k.from), utki::make_span(k.to), 0.3f, utki::make_span(k.out));
+			bench::do_not_optimize(k.out.front());
+		}
+	});
+});
+}
@@ -0,0 +1,125 @@
+#include "../../../src/r4/ray2.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_objects = 4096;
+
+template <class T> std::vector<r4::rectangle<T>> make_rectangles(){
+	std::vector<r4::rectangle<T>> ret;
+	for(size_t i = 0; i != num_objects; ++i){
+		ret.emplace_back(T(int(i * 7) % 101 - 50), T(int(i * 13) % 97 - 48), T(i % 4 + 1), T(i % 3 + 1));
+	}
+	return ret;
+}
+
+template <class T> std::vector<r4::ray2<T>> make_rays(){
+	std::vector<r4::ray2<T>> ret;
+	for(size_t i = 0; i != num_objects; ++i){
+		ret.emplace_back(
+				r4::vector2<T>(T(int(i * 3) % 31 - 15), T(int(i * 11) % 29 - 14)),
+				r4::vector2<T>(T(int(i % 5) - 2) + T(0.5), T(int(i * 7) % 5 - 2) + T(0.25))
+			);
+	}
+	return ret;
+}
+
+template <class T> std::vector<r4::segment2<T>> make_segments(){
+	std::vector<r4::segment2<T>> ret;
+	for(size_t i = 0; i != num_objects; ++i){
+		r4::vector2<T> p(T(int(i * 3) % 31 - 15), T(int(i * 11) % 29 - 14));
+		ret.push_back(r4::segment2<T>{p, p + r4::vector2<T>(T(int(i % 9) - 4), T(int(i * 7) % 9 - 4))});
+	}
+	return ret;
+}
+
+template <class T> void add_ray_benchmarks(const std::string& type_name){
+	// all benchmarks are per ray-rectangle test
+	bench::add("ray2<" + type_name + ">::intersects(span<rectangle>)", [](size_t n){
+		auto rects = make_rectangles<T>();
+		auto rays = make_rays<T>();
+		std::vector<uint32_t> hits(r4::ray2<T>::mask_size(num_objects));
+		for(size_t i = 0; i < n; i += num_objects){
+			bench::do_not_optimize(rays[(i / num_objects) % num_objects].intersects(utki::make_span(std::as_const(rects)), utki::make_span(hits)));
+		}
+	});
+
+	bench::add("ray2<" + type_name + ">::intersects(rectangle) over span (reference)", [](size_t n){
+		auto rects = make_rectangles<T>();
+		auto rays = make_rays<T>();
+		for(size_t i = 0; i < n; i += num_objects){
+			const auto& r = rays[(i / num_objects) % num_objects];
+			size_t num_hits = 0;
+			for(const auto& rect : rects){
+				if(r.intersects(rect)){
+					++num_hits;
+				}
+			}
+			bench::do_not_optimize(num_hits);
+		}
+	});
+
+	bench::add("intersects(span<ray2<" + type_name + ">>, rectangle)", [](size_t n){
+		auto rects = make_rectangles<T>();
+		auto rays = make_rays<T>();
+		std::vector<uint32_t> hits(r4::ray2<T>::mask_size(num_objects));
+		for(size_t i = 0; i < n; i += num_objects){
+			const auto& rect = rects[(i / num_objects) % num_objects];
+			bench::do_not_optimize(r4::intersects(utki::make_span(std::as_const(rays)), rect, utki::make_span(hits)));
+		}
+	});
+
+	// packets of 16 rays against many rectangles
+	bench::add("intersects(span<ray2<" + type_name + ">> of 16 rays, rectangle)", [](size_t n){
+		auto rects = make_rectangles<T>();
+		auto rays = make_rays<T>();
+		std::array<uint32_t, 1> hits;
+		size_t p = 0;
+		for(size_t i = 0; i < n; i += 16){
+			const auto& rect = rects[(i / 16) % num_objects];
+			bench::do_not_optimize(r4::intersects(utki::make_span(std::as_const(rays)).subspan(p, 16), rect, utki::make_span(hits)));
+			p = (p + 16) % num_objects;
+		}
+	});
+}
+
+template <class T> void add_segment_benchmarks(const std::string& type_name){
+	bench::add("segment2<" + type_name + ">::intersects(segment2)", [](size_t n){
+		auto segments = make_segments<T>();
+		size_t num_hits = 0;
+		for(size_t i = 0; i != n; ++i){
+			if(segments[i % num_objects].intersects(segments[(i * 7 + 1) % num_objects])){
+				++num_hits;
+			}
+		}
+		bench::do_not_optimize(num_hits);
+	});
+
+	bench::add("intersects(segment2<" + type_name + ">, rectangle)", [](size_t n){
+		auto segments = make_segments<T>();
+		auto rects = make_rectangles<T>();
+		size_t num_hits = 0;
+		for(size_t i = 0; i != n; ++i){
+			if(r4::intersects(segments[i % num_objects], rects[(i * 7 + 1) % num_objects])){
+				++num_hits;
+			}
+		}
+		bench::do_not_optimize(num_hits);
+	});
+}
+
+const bench::set set([](){
+	add_ray_benchmarks<float>("float");
+	add_ray_benchmarks<double>("double");
+
+	add_segment_benchmarks<int>("int");
+	add_segment_benchmarks<float>("float");
+
+	bench::add("segment2<float>::intersect(segment2)", [](size_t n){
+		auto segments = make_segments<float>();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(segments[i % num_objects].intersect(segments[(i * 7 + 1) % num_objects]));
+		}
+	});
+});
+}
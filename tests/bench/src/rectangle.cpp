@@ -0,0 +1,63 @@
+#include "../../../src/r4/rectangle.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t batch_size = 1024;
+
+template <typename T> std::vector<r4::rectangle<T>> make_rectangles(size_t seed){
+	std::vector<r4::rectangle<T>> ret;
+	for(size_t i = 0; i != batch_size; ++i){
+		ret.push_back(r4::rectangle<T>(
+				T((i * 7 + seed) % 31),
+				T((i * 3 + seed) % 29),
+				T((i + seed) % 13 + 1),
+				T((i * 5 + seed) % 11 + 1)
+			));
+	}
+	return ret;
+}
+
+// Adds benchmarks of binary rectangle operation applied to single pair of rectangles
+// and to a batch of rectangle pairs, batched benchmarks are per rectangle pair.
+template <typename T, typename F> void add_op_benchmarks(const std::string& name, F op){
+	bench::add(name, [op](size_t n){
+		auto a = make_rectangles<T>(0).front();
+		auto b = make_rectangles<T>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(op(a, b));
+		}
+	});
+
+	bench::add(name + " (batch)", [op](size_t n){
+		auto a = make_rectangles<T>(0);
+		auto b = make_rectangles<T>(1);
+		typedef decltype(op(a.front(), b.front())) result_type;
+		// std::vector<bool> is bit-packed, so store boolean results as chars
+		std::vector<std::conditional_t<std::is_same_v<result_type, bool>, char, result_type>> out(a.size());
+		for(size_t i = 0; i < n; i += batch_size){
+			for(size_t j = 0; j != out.size(); ++j){
+				out[j] = op(a[j], b[j]);
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+template <typename T> void add_rectangle_benchmarks(const std::string& type_name){
+	std::string name = "rectangle<" + type_name + ">::";
+
+	add_op_benchmarks<T>(name + "intersect()", [](auto a, const auto& b){return a.intersect(b);});
+	add_op_benchmarks<T>(name + "unite()", [](auto a, const auto& b){return a.unite(b);});
+	add_op_benchmarks<T>(name + "overlaps(rectangle)", [](const auto& a, const auto& b){return a.overlaps(b);});
+	add_op_benchmarks<T>(name + "overlaps(vector2)", [](const auto& a, const auto& b){return a.overlaps(b.p);});
+}
+
+const bench::set set([](){
+	add_rectangle_benchmarks<float>("float");
+	add_rectangle_benchmarks<double>("double");
+	add_rectangle_benchmarks<int>("int");
+});
+}
@@ -0,0 +1,50 @@
+#include "../../../src/r4/rectangle_packer.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_rects = 4096;
+
+// glyph-like sizes
+std::vector<r4::vector2<int>> make_dims(){
+	std::vector<r4::vector2<int>> ret;
+	for(size_t i = 0; i != num_rects; ++i){
+		ret.emplace_back(int(i * 7) % 17 + 6, int(i * 13) % 11 + 12);
+	}
+	return ret;
+}
+
+// Benchmarks are per packed rectangle, the packer is cleared when it is full.
+template <class P> void add_packer_benchmarks(const std::string& name, const r4::vector2<int>& bin_dims){
+	std::string suffix = " (" + std::to_string(bin_dims.x()) + "x" + std::to_string(bin_dims.y()) + ")";
+
+	bench::add(name + "::insert()" + suffix, [bin_dims](size_t n){
+		auto dims = make_dims();
+		P packer(bin_dims);
+		for(size_t i = 0; i != n; ++i){
+			auto r = packer.insert(dims[i % dims.size()]);
+			if(!r){
+				packer.clear();
+			}
+			bench::do_not_optimize(r);
+		}
+	});
+
+	bench::add("pack(" + name + ")" + suffix, [bin_dims](size_t n){
+		auto dims = make_dims();
+		std::vector<r4::rectangle<int>> out(dims.size());
+		P packer(bin_dims);
+		for(size_t i = 0; i < n; i += num_rects){
+			packer.clear();
+			bench::do_not_optimize(r4::pack(packer, utki::make_span(std::as_const(dims)), utki::make_span(out)));
+		}
+	});
+}
+
+const bench::set set([](){
+	add_packer_benchmarks<r4::skyline_packer<int>>("skyline_packer", {512, 512});
+	add_packer_benchmarks<r4::skyline_packer<int>>("skyline_packer", {2048, 2048});
+	add_packer_benchmarks<r4::max_rects_packer<int>>("max_rects_packer", {512, 512});
+	add_packer_benchmarks<r4::max_rects_packer<int>>("max_rects_packer", {2048, 2048});
+});
+}
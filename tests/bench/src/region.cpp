@@ -0,0 +1,79 @@
+#include "../../../src/r4/region.hpp"
+
+#include "bench.hpp"
+
+#include "../../common/lcg.hpp"
+
+namespace{
+const size_t num_rects = 1024;
+
+// small damaged areas scattered over a 1920x1080 window
+std::vector<r4::rectangle<int>> make_rects(){
+	std::vector<r4::rectangle<int>> ret;
+	r4_tests::lcg rnd(1);
+	for(size_t i = 0; i != num_rects; ++i){
+		ret.push_back(r4::rectangle<int>(rnd.next(1900), rnd.next(1060), rnd.next(64) + 1, rnd.next(32) + 1));
+	}
+	return ret;
+}
+
+// Add benchmarks are per added rectangle, the region is cleared each 'frame' of rectangles.
+void add_region_benchmarks(size_t max_rects, size_t rects_per_frame){
+	std::string suffix = " (" + std::to_string(max_rects) + " max, " + std::to_string(rects_per_frame) + " per frame)";
+
+	bench::add("region<int>::add()" + suffix, [=](size_t n){
+		auto rects = make_rects();
+		r4::region<int> reg(max_rects);
+		for(size_t i = 0; i != n; ++i){
+			if(i % rects_per_frame == 0){
+				reg.clear();
+			}
+			reg.add(rects[i % num_rects]);
+		}
+		bench::do_not_optimize(reg);
+	});
+
+	bench::add("region<int>::overlaps(rectangle)" + suffix, [=](size_t n){
+		auto rects = make_rects();
+		r4::region<int> reg(max_rects);
+		for(size_t i = 0; i != rects_per_frame; ++i){
+			reg.add(rects[i]);
+		}
+		size_t num_found = 0;
+		for(size_t i = 0; i != n; ++i){
+			if(reg.overlaps(rects[i % num_rects])){
+				++num_found;
+			}
+		}
+		bench::do_not_optimize(num_found);
+	});
+}
+
+const bench::set set([](){
+	add_region_benchmarks(8, 16);
+	add_region_benchmarks(16, 64);
+	add_region_benchmarks(32, 64);
+
+	bench::add("region<int>::subtract() (16 max, 16 per frame)", [](size_t n){
+		auto rects = make_rects();
+		r4::region<int> reg(16);
+		for(size_t i = 0; i != n; ++i){
+			if(i % 16 == 0){
+				reg.clear();
+				reg.add(r4::rectangle<int>(0, 0, 1920, 1080));
+			}
+			reg.subtract(rects[i % num_rects]);
+		}
+		bench::do_not_optimize(reg);
+	});
+
+	bench::add("rectangle<int>::unite() (bounding box accumulation)", [](size_t n){
+		auto rects = make_rects();
+		auto bb = rects.front();
+		for(size_t i = 0; i != n; ++i){
+			bb.unite(rects[i % num_rects]);
+			bench::do_not_optimize(bb);
+		}
+	});
+});
+}
@@ -0,0 +1,51 @@
+#include "../../../src/r4/parallel.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_points = 1 << 20;
+
+template <typename T> std::vector<r4::vector2<T>> make_points(){
+	std::vector<r4::vector2<T>> ret;
+	ret.reserve(num_points);
+	for(size_t i = 0; i != num_points; ++i){
+		ret.push_back(r4::vector2<T>(T(int(i * 7) % 1023) - 500, T(int(i * 5) % 517) / 2));
+	}
+	return ret;
+}
+
+// all benchmarks are per point
+template <typename T> void add_bounding_box_benchmarks(const std::string& type_name){
+	bench::add("segment2<" + type_name + ">::unite() (loop)", [](size_t n){
+		auto points = make_points<T>();
+		for(size_t i = 0; i < n; i += num_points){
+			r4::segment2<T> bb;
+			bb.set_empty_bounding_box();
+			for(const auto& p : points){
+				bb.unite(r4::segment2<T>{p, p});
+			}
+			bench::do_not_optimize(bb);
+		}
+	});
+
+	bench::add("segment2<" + type_name + ">::from_points()", [](size_t n){
+		auto points = make_points<T>();
+		for(size_t i = 0; i < n; i += num_points){
+			bench::do_not_optimize(r4::segment2<T>::from_points(utki::make_span(points)));
+		}
+	});
+
+	bench::add("parallel_bounding_box(span<vector2<" + type_name + ">>)", [](size_t n){
+		auto points = make_points<T>();
+		for(size_t i = 0; i < n; i += num_points){
+			bench::do_not_optimize(r4::parallel_bounding_box(utki::make_span(points)));
+		}
+	});
+}
+
+const bench::set set([](){
+	add_bounding_box_benchmarks<float>("float");
+	add_bounding_box_benchmarks<double>("double");
+	add_bounding_box_benchmarks<int>("int");
+});
+}
@@ -0,0 +1,66 @@
+#include "../../../src/r4/soa_vector.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_points = 4096;
+
+std::vector<r4::vector3<float>> make_points(){
+	std::vector<r4::vector3<float>> ret;
+	for(size_t i = 0; i != num_points; ++i){
+		ret.push_back(r4::vector3<float>(float(i % 13), float(i % 7) - 3, float(i % 5) * 0.5f));
+	}
+	return ret;
+}
+
+r4::matrix4<float> make_matrix(){
+	r4::matrix4<float> m;
+	m.set_identity();
+	m.translate(1, 2, 3);
+	m.rotate(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+	return m;
+}
+
+// all benchmarks are per point
+const bench::set set([](){
+	bench::add("soa_vector<float, 3>::normalize", [](size_t n){
+		auto points = make_points();
+		r4::soa_vector<float, 3> soa(utki::make_span(points));
+		for(size_t i = 0; i < n; i += num_points){
+			soa.normalize();
+			bench::do_not_optimize(soa);
+		}
+	});
+
+	bench::add("std::vector<vector3<float>> normalize", [](size_t n){
+		auto points = make_points();
+		for(size_t i = 0; i < n; i += num_points){
+			for(auto& p : points){
+				p.normalize();
+			}
+			bench::do_not_optimize(points.front());
+		}
+	});
+
+	bench::add("soa_vector<float, 3>::transform(matrix4)", [](size_t n){
+		auto points = make_points();
+		r4::soa_vector<float, 3> soa(utki::make_span(points));
+		auto m = make_matrix();
+		for(size_t i = 0; i < n; i += num_points){
+			soa.transform(m);
+			bench::do_not_optimize(soa);
+		}
+	});
+
+	bench::add("std::vector<vector3<float>> matrix4 * vector3", [](size_t n){
+		auto points = make_points();
+		auto m = make_matrix();
+		for(size_t i = 0; i < n; i += num_points){
+			for(auto& p : points){
+				p = m * r4::vector4<float>(p);
+			}
+			bench::do_not_optimize(points.front());
+		}
+	});
+});
+}
@@ -0,0 +1,95 @@
+#include "../../../src/r4/transform_hierarchy.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_nodes = 100000;
+
+const auto npos = r4::transform_hierarchy<float>::npos;
+
+// Parents are pseudo-random preceding nodes, so the ids are in parent-before-child order,
+// but not in breadth-first order.
+std::vector<size_t> make_parents(){
+	std::vector<size_t> ret(num_nodes);
+	for(size_t i = 0; i != num_nodes; ++i){
+		ret[i] = i < 4 ? npos : ((i * 2654435761u) >> 8) % i;
+	}
+	return ret;
+}
+
+r4::matrix4<float> make_local(size_t id){
+	r4::matrix4<float> m;
+	m.set_identity();
+	m.translate(float(id % 5), float(id % 3) - 1, 0.5f);
+	m.rotate(r4::quaternion<float>(r4::vector3<float>(0.1f * float(id % 7), 0.2f, 0)));
+	return m;
+}
+
+struct hierarchy{
+	std::vector<size_t> parents = make_parents();
+	r4::transform_hierarchy<float> h;
+
+	hierarchy() :
+			h(utki::make_span(this->parents))
+	{
+		for(size_t i = 0; i != num_nodes; ++i){
+			this->h.set_local(i, make_local(i));
+		}
+		this->h.update();
+	}
+};
+
+// all benchmarks are per node of the hierarchy
+const bench::set set([](){
+	bench::add("world transforms by parent index loop (reference)", [](size_t n){
+		auto parents = make_parents();
+		std::vector<r4::matrix4<float>> local;
+		for(size_t i = 0; i != num_nodes; ++i){
+			local.push_back(make_local(i));
+		}
+		std::vector<r4::matrix4<float>> world(num_nodes);
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 0; j != num_nodes; ++j){
+				world[j] = parents[j] == npos ? local[j] : world[parents[j]] * local[j];
+			}
+			bench::do_not_optimize(world.back());
+		}
+	});
+
+	// changing roots makes whole hierarchy dirty
+	bench::add("transform_hierarchy<float>::update() (all dirty)", [](size_t n){
+		hierarchy s;
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 0; j != 4; ++j){
+				s.h.set_local(j, make_local(i + j));
+			}
+			s.h.update(1);
+			bench::do_not_optimize(s.h.world(num_nodes - 1));
+		}
+	});
+
+	bench::add("transform_hierarchy<float>::update() (all dirty, multithreaded)", [](size_t n){
+		hierarchy s;
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 0; j != 4; ++j){
+				s.h.set_local(j, make_local(i + j));
+			}
+			s.h.update();
+			bench::do_not_optimize(s.h.world(num_nodes - 1));
+		}
+	});
+
+	// 100 pseudo-random nodes are changed before each update
+	bench::add("transform_hierarchy<float>::update() (100 dirty nodes)", [](size_t n){
+		hierarchy s;
+		for(size_t i = 0; i < n; i += num_nodes){
+			for(size_t j = 0; j != 100; ++j){
+				size_t id = ((i + j) * 40503) % num_nodes;
+				s.h.set_local(id, make_local(i + j));
+			}
+			s.h.update(1);
+			bench::do_not_optimize(s.h.world(num_nodes - 1));
+		}
+	});
+});
+}
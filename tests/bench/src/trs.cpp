@@ -0,0 +1,102 @@
+#include "../../../src/r4/trs.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_objects = 4096;
+
+r4::trs<float> make_trs(size_t i){
+	return {
+		r4::vector3<float>(float(i % 5), float(i % 3) - 1, 0.5f * float(i % 11)),
+		r4::quaternion<float>(r4::vector3<float>(0.3f * float(i % 7), 0.2f, -0.1f * float(i % 13))),
+		0.5f + 0.25f * float(i % 4)
+	};
+}
+
+struct objects{
+	std::vector<r4::trs<float>> parents;
+	std::vector<r4::trs<float>> locals;
+	std::vector<r4::matrix4<float>> parent_matrices;
+	std::vector<r4::matrix4<float>> local_matrices;
+
+	objects(){
+		for(size_t i = 0; i != num_objects; ++i){
+			this->parents.push_back(make_trs(i));
+			this->locals.push_back(make_trs(i + 17));
+			this->parent_matrices.push_back(this->parents.back().to_matrix());
+			this->local_matrices.push_back(this->locals.back().to_matrix());
+		}
+	}
+};
+
+// the compose and inverse benchmarks are per object, the matrix ones are the reference
+const bench::set set([](){
+	bench::add("compose(span<trs<float>>)", [](size_t n){
+		objects o;
+		std::vector<r4::trs<float>> out(num_objects);
+		for(size_t i = 0; i < n; i += num_objects){
+			r4::compose(utki::make_span(std::as_const(o.parents)), utki::make_span(std::as_const(o.locals)), utki::make_span(out));
+			bench::do_not_optimize(out.back());
+		}
+	});
+
+	bench::add("matrix4<float>::operator*(matrix4) over span (reference)", [](size_t n){
+		objects o;
+		std::vector<r4::matrix4<float>> out(num_objects);
+		for(size_t i = 0; i < n; i += num_objects){
+			for(size_t j = 0; j != num_objects; ++j){
+				out[j] = o.parent_matrices[j] * o.local_matrices[j];
+			}
+			bench::do_not_optimize(out.back());
+		}
+	});
+
+	bench::add("trs<float>::inv", [](size_t n){
+		objects o;
+		for(size_t i = 0; i < n; i += num_objects){
+			for(size_t j = 0; j != num_objects; ++j){
+				o.locals[j] = o.locals[j].inv();
+			}
+			bench::do_not_optimize(o.locals.back());
+		}
+	});
+
+	bench::add("matrix4<float>::inv_affine (reference)", [](size_t n){
+		objects o;
+		for(size_t i = 0; i < n; i += num_objects){
+			for(size_t j = 0; j != num_objects; ++j){
+				o.local_matrices[j] = o.local_matrices[j].inv_affine();
+			}
+			bench::do_not_optimize(o.local_matrices.back());
+		}
+	});
+
+	bench::add("matrix4<float>::inv (reference)", [](size_t n){
+		objects o;
+		for(size_t i = 0; i < n; i += num_objects){
+			for(size_t j = 0; j != num_objects; ++j){
+				o.local_matrices[j] = o.local_matrices[j].inv();
+			}
+			bench::do_not_optimize(o.local_matrices.back());
+		}
+	});
+
+	bench::add("trs<float>::operator*(vector3)", [](size_t n){
+		auto t = make_trs(3);
+		r4::vector3<float> p(1, 2, 3);
+		for(size_t i = 0; i != n; ++i){
+			p = t * p;
+			bench::do_not_optimize(p);
+		}
+	});
+
+	bench::add("transform(trs<float>, span<vector3>)", [](size_t n){
+		auto t = make_trs(3);
+		std::vector<r4::vector3<float>> v(num_objects, r4::vector3<float>(1, 2, 3));
+		for(size_t i = 0; i < n; i += num_objects){
+			r4::transform(t, utki::make_span(std::as_const(v)), utki::make_span(v));
+			bench::do_not_optimize(v.back());
+		}
+	});
+});
+}
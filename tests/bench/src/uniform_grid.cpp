@@ -0,0 +1,52 @@
+#include "../../../src/r4/uniform_grid.hpp"
+
+#include "bench.hpp"
+
+#include "../../common/lcg.hpp"
+
+namespace{
+const size_t num_objects = 200000;
+
+struct world{
+	r4::uniform_grid<float, 2> grid;
+	std::vector<r4::vector2<float>> pos;
+	std::vector<r4::vector2<float>> vel;
+
+	// 2000 x 2000 area with 4 x 4 cells, about 0.8 objects per cell
+	world() :
+			grid(r4::vector2<float>(0), 4, {{500, 500}})
+	{
+		r4_tests::lcg rnd(1);
+		for(size_t i = 0; i != num_objects; ++i){
+			this->pos.push_back(r4::vector2<float>(rnd.next(2000.0f), rnd.next(2000.0f)));
+			this->vel.push_back(r4::vector2<float>(rnd.next(0.2f) - 0.1f, rnd.next(0.2f) - 0.1f));
+			this->grid.insert(r4::rectangle<float>(this->pos.back(), r4::vector2<float>(1)));
+		}
+	}
+};
+
+// benchmarks are per object
+const bench::set set([](){
+	bench::add("uniform_grid<float, 2>::update (200k moving rectangles)", [](size_t n){
+		world w;
+		for(size_t i = 0; i < n; i += num_objects){
+			for(size_t j = 0; j != num_objects; ++j){
+				w.pos[j] += w.vel[j];
+				w.grid.update(j, r4::rectangle<float>(w.pos[j], r4::vector2<float>(1)));
+			}
+		}
+		bench::do_not_optimize(w.grid);
+	});
+
+	bench::add("uniform_grid<float, 2>::for_each_pair (200k rectangles)", [](size_t n){
+		world w;
+		size_t num_pairs = 0;
+		for(size_t i = 0; i < n; i += num_objects){
+			w.grid.for_each_pair([&num_pairs](size_t, size_t){
+				++num_pairs;
+			});
+		}
+		bench::do_not_optimize(num_pairs);
+	});
+});
+}
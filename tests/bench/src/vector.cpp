@@ -0,0 +1,125 @@
+#include "../../../src/r4/vector.hpp"
+
+#include "bench.hpp"
+
+namespace{
+const size_t num_points = 4096;
+
+std::vector<r4::vector3<float>> make_points(){
+	std::vector<r4::vector3<float>> ret;
+	for(size_t i = 0; i != num_points; ++i){
+		ret.push_back(r4::vector3<float>(float(i % 13), float(i % 7) - 3, float(i % 5) * 0.5f));
+	}
+	return ret;
+}
+
+const size_t batch_size = 1024;
+
+template <typename T, size_t S> std::vector<r4::vector<T, S>> make_vectors(size_t seed){
+	std::vector<r4::vector<T, S>> ret(batch_size);
+	for(size_t i = 0; i != ret.size(); ++i){
+		for(size_t j = 0; j != S; ++j){
+			ret[i][j] = T((i * 7 + j * 3 + seed) % 17 + 1);
+		}
+	}
+	return ret;
+}
+
+// Adds benchmarks of binary vector operation applied to single pair of vectors
+// and to a batch of vector pairs, batched benchmarks are per vector pair.
+template <typename T, size_t S, typename F> void add_op_benchmarks(const std::string& name, F op){
+	bench::add(name, [op](size_t n){
+		auto a = make_vectors<T, S>(0).front();
+		auto b = make_vectors<T, S>(1).front();
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(a);
+			bench::do_not_optimize(b);
+			bench::do_not_optimize(op(a, b));
+		}
+	});
+
+	bench::add(name + " (batch)", [op](size_t n){
+		auto a = make_vectors<T, S>(0);
+		auto b = make_vectors<T, S>(1);
+		std::vector<decltype(op(a.front(), b.front()))> out(a.size());
+		for(size_t i = 0; i < n; i += batch_size){
+			for(size_t j = 0; j != out.size(); ++j){
+				out[j] = op(a[j], b[j]);
+			}
+			bench::do_not_optimize(out.front());
+		}
+	});
+}
+
+template <typename T, size_t S> void add_vector_benchmarks(const std::string& type_name){
+	std::string name = "vector" + std::to_string(S) + "<" + type_name + ">::";
+
+	add_op_benchmarks<T, S>(name + "operator+(vector)", [](const auto& a, const auto& b){return a + b;});
+	add_op_benchmarks<T, S>(name + "operator-(vector)", [](const auto& a, const auto& b){return a - b;});
+	add_op_benchmarks<T, S>(name + "operator*(number)", [](const auto& a, const auto& b){return a * b[0];});
+	add_op_benchmarks<T, S>(name + "operator*(vector)", [](const auto& a, const auto& b){return a * b;});
+	add_op_benchmarks<T, S>(name + "comp_mul()", [](const auto& a, const auto& b){return a.comp_mul(b);});
+	add_op_benchmarks<T, S>(name + "min()", [](const auto& a, const auto& b){return min(a, b);});
+	add_op_benchmarks<T, S>(name + "fma(vector, vector, vector)", [](const auto& a, const auto& b){return fma(a, b, b);});
+	add_op_benchmarks<T, S>(name + "comp_mul() + operator+(vector)", [](const auto& a, const auto& b){return a.comp_mul(b) + b;});
+	if constexpr (S >= 3){
+		add_op_benchmarks<T, S>(name + "operator%(vector)", [](const auto& a, const auto& b){return a % b;});
+	}
+	if constexpr (std::is_floating_point_v<T>){
+		add_op_benchmarks<T, S>(name + "norm()", [](const auto& a, const auto&){return a.norm();});
+		add_op_benchmarks<T, S>(name + "normed()", [](const auto& a, const auto&){return a.normed();});
+		add_op_benchmarks<T, S>(name + "normed_fast()", [](const auto& a, const auto&){return a.normed_fast();});
+
+		// per vector, vectors stay normalized after the first pass, it does not affect the speed
+		bench::add("normalize_fast(span<vector" + std::to_string(S) + "<" + type_name + ">>)", [](size_t n){
+			auto a = make_vectors<T, S>(0);
+			for(size_t i = 0; i < n; i += batch_size){
+				normalize_fast(utki::make_span(a));
+				bench::do_not_optimize(a.front());
+			}
+		});
+	}
+}
+
+const bench::set set([](){
+	add_vector_benchmarks<float, 2>("float");
+	add_vector_benchmarks<float, 3>("float");
+	add_vector_benchmarks<float, 4>("float");
+	add_vector_benchmarks<double, 2>("double");
+	add_vector_benchmarks<double, 3>("double");
+	add_vector_benchmarks<double, 4>("double");
+	add_vector_benchmarks<int, 2>("int");
+	add_vector_benchmarks<int, 3>("int");
+	add_vector_benchmarks<int, 4>("int");
+
+	bench::add("vector3<float>::rotate(quaternion)", [](size_t n){
+		r4::vector3<float> v(1, 2, 3);
+		r4::quaternion<float> q(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(v);
+			bench::do_not_optimize(q);
+			bench::do_not_optimize(r4::vector3<float>(v).rotate(q));
+		}
+	});
+
+	bench::add("vector3<float> to_matrix<3>() * vector3", [](size_t n){
+		r4::vector3<float> v(1, 2, 3);
+		r4::quaternion<float> q(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		for(size_t i = 0; i != n; ++i){
+			bench::do_not_optimize(v);
+			bench::do_not_optimize(q);
+			bench::do_not_optimize(q.to_matrix<3>() * v);
+		}
+	});
+
+	// per point
+	bench::add("rotate(span<vector3<float>>, quaternion)", [](size_t n){
+		auto points = make_points();
+		r4::quaternion<float> q(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		for(size_t i = 0; i < n; i += num_points){
+			rotate(utki::make_span(points), q);
+			bench::do_not_optimize(points.front());
+		}
+	});
+});
+}
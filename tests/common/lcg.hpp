@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+namespace r4_tests{
+
+/**
+ * @brief Simple deterministic pseudo-random number generator.
+ * Used by tests and benchmarks to make their input data reproducible.
+ */
+class lcg{
+	uint32_t state;
+
+	// 24 most significant bits of the state, lower bits of linear congruential generator are not random enough
+	uint32_t next()noexcept{
+		this->state = this->state * 1664525 + 1013904223;
+		return this->state >> 8;
+	}
+
+public:
+	lcg(uint32_t seed) : state(seed){}
+
+	/**
+	 * @brief Get next random integer.
+	 * @param max - upper bound of the number, must be greater than zero.
+	 * @return number in [0 : max).
+	 */
+	int next(int max)noexcept{
+		return int(this->next() % uint32_t(max));
+	}
+
+	/**
+	 * @brief Get next random floating point number.
+	 * @param max - upper bound of the number.
+	 * @return number in [0 : max).
+	 */
+	float next(float max)noexcept{
+		return float(this->next()) / float(1 << 24) * max;
+	}
+};
+
+}
@@ -0,0 +1,121 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <cstdint>
+
+#include "../../../src/r4/aligned.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::aligned_allocator<float>;
+template class r4::aligned_vector4<float>;
+template class r4::aligned_vector4<double>;
+template class r4::aligned_matrix4<float>;
+template class r4::aligned_matrix4<double>;
+
+namespace{
+bool is_aligned(const void* p, size_t alignment){
+	return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+template <class T> r4::matrix4<T> make_matrix(){
+	r4::matrix4<T> m;
+	m.set_identity();
+	m.translate(3, -4, 5);
+	m.rotate(r4::vector3<T>(T(0.3), T(-0.2), T(0.7)));
+	m.scale(2, 3, T(0.5));
+	return m;
+}
+
+template <class T> void check_transform(){
+	auto m = make_matrix<T>();
+
+	std::vector<r4::aligned_vector4<T>> in;
+	for(int i = 0; i != 7; ++i){
+		in.push_back(r4::vector4<T>(T(i), T(i * 2 - 5), T(3 - i), T(i % 2)));
+	}
+
+	std::vector<r4::aligned_vector4<T>> out(in.size());
+
+	r4::transform(m, utki::make_span(std::as_const(in)), utki::make_span(out));
+
+	for(size_t i = 0; i != in.size(); ++i){
+		tst::check(is_aligned(out[i].data(), sizeof(r4::vector4<T>)), SL);
+		auto diff = out[i] - m * in[i];
+		diff.snap_to_zero(T(1e-5));
+		tst::check(diff.is_zero(), SL);
+	}
+
+	// in-place
+	r4::transform(m, utki::make_span(std::as_const(in)), utki::make_span(in));
+	tst::check(in == out, SL);
+}
+
+tst::set set("aligned", [](tst::suite& suite){
+    suite.add("aligned_allocator", []{
+		std::vector<float, r4::aligned_allocator<float>> v;
+		for(unsigned i = 0; i != 100; ++i){
+			v.push_back(float(i));
+			tst::check(is_aligned(v.data(), r4::cache_line_size), SL);
+		}
+		tst::check_eq(v[99], 99.0f, SL);
+
+		std::vector<r4::vector4<double>, r4::aligned_allocator<r4::vector4<double>, 32>> vd(5, r4::vector4<double>(1, 2, 3, 4));
+		tst::check(is_aligned(vd.data(), 32), SL);
+		tst::check_eq(vd[4], r4::vector4<double>(1, 2, 3, 4), SL);
+
+		tst::check(r4::aligned_allocator<float>() == r4::aligned_allocator<double>(), SL);
+    });
+
+    suite.add("aligned_vector4_alignment", []{
+		tst::check_eq(alignof(r4::aligned_vector4<float>), size_t(16), SL);
+		tst::check_eq(alignof(r4::aligned_vector4<double>), size_t(32), SL);
+		tst::check_eq(sizeof(r4::aligned_vector4<float>), sizeof(r4::vector4<float>), SL);
+
+		std::vector<r4::aligned_vector4<double>> v(10);
+		for(const auto& e : v){
+			tst::check(is_aligned(e.data(), 32), SL);
+		}
+    });
+
+    suite.add("aligned_vector4_conversions", []{
+		r4::aligned_vector4<float> a(1, 2, 3, 4);
+		r4::vector4<float> v = a;
+		tst::check_eq(v, r4::vector4<float>(1, 2, 3, 4), SL);
+
+		const r4::vector4<float>& ref = a;
+		tst::check_eq(&ref[0], a.data(), SL);
+
+		a = v * 2;
+		tst::check_eq(a, r4::vector4<float>(2, 4, 6, 8), SL);
+
+		a += r4::aligned_vector4<float>(1, 1, 1, 1);
+		tst::check_eq(a, r4::vector4<float>(3, 5, 7, 9), SL);
+		tst::check_eq(a * a, 9.0f + 25 + 49 + 81, SL);
+    });
+
+    suite.add("aligned_matrix4", []{
+		tst::check_eq(alignof(r4::aligned_matrix4<float>), r4::cache_line_size, SL);
+		tst::check_eq(alignof(r4::aligned_matrix4<double>), r4::cache_line_size, SL);
+
+		r4::aligned_matrix4<float> a = make_matrix<float>();
+		r4::aligned_matrix4<float> b;
+		b.set_identity();
+		b.scale(2);
+
+		r4::aligned_matrix4<float> p = a * b;
+		tst::check(is_aligned(&p, r4::cache_line_size), SL);
+		tst::check(p == make_matrix<float>() * b, SL);
+
+		const r4::matrix4<float>& ref = p;
+		tst::check_eq(&ref[0][0], &p[0][0], SL);
+    });
+
+    suite.add("transform_aligned_vector4_float", []{
+		check_transform<float>();
+    });
+
+    suite.add("transform_aligned_vector4_double", []{
+		check_transform<double>();
+    });
+});
+}
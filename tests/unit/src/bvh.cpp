@@ -0,0 +1,224 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <algorithm>
+
+#include "../../../src/r4/bvh.hpp"
+
+#include "../../common/lcg.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::bvh<int>;
+template class r4::bvh<float>;
+
+namespace{
+using r4_tests::lcg;
+
+std::vector<r4::rectangle<int>> make_rects(size_t num){
+	lcg rnd(13);
+	std::vector<r4::rectangle<int>> ret;
+	for(size_t i = 0; i != num; ++i){
+		ret.push_back(r4::rectangle<int>(rnd.next(1000), rnd.next(1000), rnd.next(50), rnd.next(50)));
+	}
+	return ret;
+}
+
+// returns sorted ids of the rectangles overlapping the query
+template <class Q> std::vector<size_t> brute_force(
+		const std::vector<r4::rectangle<int>>& rects,
+		const std::vector<size_t>& ids,
+		const Q& q
+	)
+{
+	std::vector<size_t> ret;
+	for(size_t i = 0; i != rects.size(); ++i){
+		if(ids[i] != r4::bvh<int>::npos && rects[i].overlaps(q)){
+			ret.push_back(ids[i]);
+		}
+	}
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+template <class Q> std::vector<size_t> query(const r4::bvh<int>& tree, const Q& q){
+	std::vector<size_t> ret;
+	tree.query(q, [&ret](size_t id){
+		ret.push_back(id);
+	});
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+int distance_pow2(const r4::rectangle<int>& r, const r4::vector2<int>& p){
+	using std::max;
+	auto d = max(max(r.p - p, p - r.x2_y2()), r4::vector2<int>(0));
+	return d.norm_pow2();
+}
+
+tst::set set("bvh", [](tst::suite& suite){
+    suite.add("empty", []{
+        r4::bvh<int> tree;
+
+		tst::check(tree.empty(), SL);
+		tst::check_eq(tree.size(), size_t(0), SL);
+		tst::check_eq(tree.height(), size_t(0), SL);
+		tst::check(query(tree, r4::vector2<int>(1, 2)).empty(), SL);
+		tst::check_eq(tree.nearest(r4::vector2<int>(1, 2)), r4::bvh<int>::npos, SL);
+    });
+
+    suite.add("insert_and_query", []{
+		auto rects = make_rects(500);
+		std::vector<size_t> ids;
+
+        r4::bvh<int> tree;
+		for(const auto& r : rects){
+			ids.push_back(tree.insert(r));
+		}
+
+		for(size_t i = 0; i != rects.size(); ++i){
+			tst::check_eq(tree.get(ids[i]), rects[i], SL);
+		}
+
+		tst::check_eq(tree.size(), rects.size(), SL);
+
+		// tree must stay balanced
+		tst::check_le(tree.height(), size_t(20), SL);
+
+		lcg rnd(7);
+		for(size_t i = 0; i != 100; ++i){
+			r4::vector2<int> p(rnd.next(1050), rnd.next(1050));
+			tst::check(query(tree, p) == brute_force(rects, ids, p), SL);
+
+			r4::rectangle<int> r(rnd.next(1000), rnd.next(1000), rnd.next(100), rnd.next(100));
+			tst::check(query(tree, r) == brute_force(rects, ids, r), SL);
+		}
+    });
+
+    suite.add("bulk_build", []{
+		auto rects = make_rects(1000);
+
+		// ids of bulk inserted rectangles are their indices
+		std::vector<size_t> ids(rects.size());
+		for(size_t i = 0; i != ids.size(); ++i){
+			ids[i] = i;
+		}
+
+        r4::bvh<int> tree(utki::make_span(rects));
+
+		tst::check_eq(tree.size(), rects.size(), SL);
+		tst::check_le(tree.height(), size_t(10), SL);
+
+		for(size_t i = 0; i != rects.size(); ++i){
+			tst::check_eq(tree.get(i), rects[i], SL);
+		}
+
+		lcg rnd(3);
+		for(size_t i = 0; i != 100; ++i){
+			r4::vector2<int> p(rnd.next(1050), rnd.next(1050));
+			tst::check(query(tree, p) == brute_force(rects, ids, p), SL);
+
+			r4::rectangle<int> r(rnd.next(1000), rnd.next(1000), rnd.next(100), rnd.next(100));
+			tst::check(query(tree, r) == brute_force(rects, ids, r), SL);
+		}
+
+		// inserting into bulk built tree
+		r4::rectangle<int> r(2000, 2000, 10, 10);
+		size_t id = tree.insert(r);
+		tst::check(query(tree, r4::vector2<int>(2005, 2005)) == std::vector<size_t>{id}, SL);
+    });
+
+    suite.add("remove_and_update", []{
+		auto rects = make_rects(300);
+		std::vector<size_t> ids;
+
+        r4::bvh<int> tree;
+		for(const auto& r : rects){
+			ids.push_back(tree.insert(r));
+		}
+
+		lcg rnd(5);
+		for(size_t i = 0; i != rects.size(); i += 3){
+			tree.remove(ids[i]);
+			ids[i] = r4::bvh<int>::npos;
+		}
+		for(size_t i = 1; i < rects.size(); i += 3){
+			rects[i].p += r4::vector2<int>(rnd.next(100), rnd.next(100));
+			tree.update(ids[i], rects[i]);
+		}
+
+		tst::check_eq(tree.size(), rects.size() - (rects.size() + 2) / 3, SL);
+		tst::check_le(tree.height(), size_t(20), SL);
+
+		for(size_t i = 0; i != 100; ++i){
+			r4::vector2<int> p(rnd.next(1150), rnd.next(1150));
+			tst::check(query(tree, p) == brute_force(rects, ids, p), SL);
+
+			r4::rectangle<int> r(rnd.next(1000), rnd.next(1000), rnd.next(100), rnd.next(100));
+			tst::check(query(tree, r) == brute_force(rects, ids, r), SL);
+		}
+
+		// remove all
+		for(auto id : ids){
+			if(id != r4::bvh<int>::npos){
+				tree.remove(id);
+			}
+		}
+		tst::check(tree.empty(), SL);
+		tst::check(query(tree, r4::vector2<int>(500, 500)).empty(), SL);
+
+		// reuse freed nodes
+		size_t id = tree.insert(rects[0]);
+		tst::check(query(tree, rects[0].p) == std::vector<size_t>{id}, SL);
+    });
+
+    suite.add("query_stops_when_callback_returns_false", []{
+        r4::bvh<int> tree;
+		for(int i = 0; i != 10; ++i){
+			tree.insert(r4::rectangle<int>(i, i, 20, 20));
+		}
+
+		size_t num_calls = 0;
+		tree.query(r4::vector2<int>(15, 15), [&num_calls](size_t){
+			++num_calls;
+			return false;
+		});
+		tst::check_eq(num_calls, size_t(1), SL);
+    });
+
+    suite.add("nearest", []{
+		auto rects = make_rects(400);
+
+        r4::bvh<int> tree(utki::make_span(rects));
+
+		lcg rnd(11);
+		for(size_t i = 0; i != 50; ++i){
+			r4::vector2<int> p(rnd.next(1200) - 100, rnd.next(1200) - 100);
+
+			std::vector<int> dists;
+			for(const auto& r : rects){
+				dists.push_back(distance_pow2(r, p));
+			}
+			std::sort(dists.begin(), dists.end());
+
+			std::array<size_t, 5> found;
+			tst::check_eq(tree.nearest(p, utki::make_span(found)), found.size(), SL);
+
+			// there can be several rectangles at same distance, so compare distances
+			for(size_t j = 0; j != found.size(); ++j){
+				tst::check_eq(distance_pow2(rects[found[j]], p), dists[j], SL);
+			}
+
+			tst::check_eq(distance_pow2(rects[tree.nearest(p)], p), dists[0], SL);
+		}
+
+		// ask for more than there are
+		r4::bvh<int> small;
+		small.insert(r4::rectangle<int>(0, 0, 1, 1));
+		small.insert(r4::rectangle<int>(10, 0, 1, 1));
+		std::array<size_t, 3> found;
+		tst::check_eq(small.nearest(r4::vector2<int>(9, 0), utki::make_span(found)), size_t(2), SL);
+		tst::check_eq(found[0], size_t(1), SL);
+		tst::check_eq(found[1], size_t(0), SL);
+    });
+});
+}
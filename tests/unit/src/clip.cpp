@@ -0,0 +1,305 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/clip.hpp"
+
+namespace{
+template <typename T> std::vector<r4::vector2<T>> make_points(size_t n){
+	std::vector<r4::vector2<T>> ret;
+	for(size_t i = 0; i != n; ++i){
+		// grid of points around the rectangle, including the points lying on its edges
+		ret.emplace_back(T(int(i * 7) % 9 - 2), T(int(i * 5) % 11 - 3));
+	}
+	return ret;
+}
+
+template <typename T> void check_outcodes(){
+	r4::rectangle<T> rect(0, 1, 4, 3);
+
+	// various sizes to cover SIMD loop and its tail
+	for(size_t n = 0; n != 40; ++n){
+		auto points = make_points<T>(n);
+		std::vector<uint8_t> codes(n, 0xff);
+
+		r4::outcodes(utki::make_span(std::as_const(points)), rect, utki::make_span(codes));
+
+		for(size_t i = 0; i != n; ++i){
+			tst::check_eq(unsigned(codes[i]), unsigned(r4::outcode(points[i], rect)), SL);
+		}
+	}
+}
+
+template <typename T> T area(utki::span<const r4::vector2<T>> polygon){
+	T ret = 0;
+	for(size_t i = 0; i != polygon.size(); ++i){
+		const auto& a = polygon[i];
+		const auto& b = polygon[(i + 1) % polygon.size()];
+		ret += a.x() * b.y() - b.x() * a.y();
+	}
+	return ret / 2;
+}
+
+template <typename T> bool is_inside(const r4::vector2<T>& p, const r4::rectangle<T>& rect){
+	return p.x() >= rect.p.x() && p.y() >= rect.p.y() && p.x() <= rect.x2() && p.y() <= rect.y2();
+}
+
+tst::set set("clip", [](tst::suite& suite){
+    suite.add("outcode", []{
+        r4::rectangle<int> rect(0, 1, 4, 3);
+
+		tst::check_eq(unsigned(r4::outcode<int>({2, 2}, rect)), 0u, SL);
+
+		// points on the edges and corners are inside
+		tst::check_eq(unsigned(r4::outcode<int>({0, 1}, rect)), 0u, SL);
+		tst::check_eq(unsigned(r4::outcode<int>({4, 4}, rect)), 0u, SL);
+		tst::check_eq(unsigned(r4::outcode<int>({4, 2}, rect)), 0u, SL);
+
+		tst::check_eq(unsigned(r4::outcode<int>({-1, 2}, rect)), unsigned(r4::outcode_x1), SL);
+		tst::check_eq(unsigned(r4::outcode<int>({5, 2}, rect)), unsigned(r4::outcode_x2), SL);
+		tst::check_eq(unsigned(r4::outcode<int>({2, 0}, rect)), unsigned(r4::outcode_y1), SL);
+		tst::check_eq(unsigned(r4::outcode<int>({2, 5}, rect)), unsigned(r4::outcode_y2), SL);
+		tst::check_eq(unsigned(r4::outcode<int>({-1, 0}, rect)), unsigned(r4::outcode_x1 | r4::outcode_y1), SL);
+		tst::check_eq(unsigned(r4::outcode<int>({5, 5}, rect)), unsigned(r4::outcode_x2 | r4::outcode_y2), SL);
+    });
+
+    suite.add("outcodes", []{
+        check_outcodes<float>();
+		check_outcodes<double>();
+		check_outcodes<int>();
+    });
+
+    suite.add("clip_segment", []{
+        r4::rectangle<float> rect(0, 0, 4, 2);
+
+		// inside
+		{
+			r4::segment2<float> s{{1, 1}, {3, 2}};
+			tst::check(r4::clip(s, rect), SL);
+			tst::check_eq(s.p1, r4::vector2<float>(1, 1), SL);
+			tst::check_eq(s.p2, r4::vector2<float>(3, 2), SL);
+		}
+
+		// crossing the rectangle horizontally
+		{
+			r4::segment2<float> s{{-2, 1}, {6, 1}};
+			tst::check(r4::clip(s, rect), SL);
+			tst::check_eq(s.p1, r4::vector2<float>(0, 1), SL);
+			tst::check_eq(s.p2, r4::vector2<float>(4, 1), SL);
+		}
+
+		// one end inside, crossing top edge
+		{
+			r4::segment2<float> s{{1, 1}, {3, 3}};
+			tst::check(r4::clip(s, rect), SL);
+			tst::check_eq(s.p1, r4::vector2<float>(1, 1), SL);
+			tst::check_eq(s.p2, r4::vector2<float>(2, 2), SL);
+		}
+
+		// diagonal crossing two edges at once from both ends
+		{
+			r4::segment2<float> s{{-1, -1}, {5, 5}};
+			tst::check(r4::clip(s, rect), SL);
+			tst::check_eq(s.p1, r4::vector2<float>(0, 0), SL);
+			tst::check_eq(s.p2, r4::vector2<float>(2, 2), SL);
+		}
+
+		// trivially rejected
+		{
+			r4::segment2<float> s{{-2, -1}, {6, -1}};
+			tst::check(!r4::clip(s, rect), SL);
+		}
+
+		// passing by the corner, outcodes of the ends have no common bits
+		{
+			r4::segment2<float> s{{-1, 1}, {1, 3.5f}};
+			tst::check(!r4::clip(s, rect), SL);
+		}
+
+		// touching the corner
+		{
+			r4::segment2<float> s{{3, 3}, {5, 1}};
+			tst::check(r4::clip(s, rect), SL);
+			tst::check_eq(s.p1, r4::vector2<float>(4, 2), SL);
+			tst::check_eq(s.p2, r4::vector2<float>(4, 2), SL);
+		}
+    });
+
+    suite.add("clip_segment_random", []{
+        r4::rectangle<double> rect(-1, -2, 3, 2.5);
+
+		for(unsigned i = 0; i != 1000; ++i){
+			r4::segment2<double> orig{
+				{double(int(i * 37) % 101) / 10 - 5, double(int(i * 53) % 97) / 10 - 5},
+				{double(int(i * 71) % 89) / 10 - 4, double(int(i * 29) % 103) / 10 - 5}
+			};
+			auto s = orig;
+			bool res = r4::clip(s, rect);
+
+			// check against the segment intersection with rectangle edges and the ends inside
+			bool expected = is_inside(orig.p1, rect) || is_inside(orig.p2, rect);
+			for(unsigned j = 0; j != 4; ++j){
+				r4::vector2<double> corners[] = {rect.p, rect.x2_y1(), rect.x2_y2(), rect.x1_y2()};
+				expected = expected || orig.intersects(r4::segment2<double>{corners[j], corners[(j + 1) % 4]});
+			}
+			tst::check_eq(res, expected, SL);
+
+			if(res){
+				// clipped ends are inside the rectangle and lie on the original segment
+				constexpr double eps = 1e-9;
+				for(const auto& p : {s.p1, s.p2}){
+					tst::check(is_inside(p, r4::rectangle<double>(rect.p - eps, rect.d + 2 * eps)), SL);
+					auto d = orig.p2 - orig.p1;
+					tst::check_le(std::abs(d.x() * (p.y() - orig.p1.y()) - d.y() * (p.x() - orig.p1.x())), 1e-6, SL);
+				}
+			}
+		}
+    });
+
+    suite.add("clip_polyline", []{
+        r4::rectangle<float> rect(0, 0, 4, 2);
+
+		std::vector<r4::vector2<float>> polyline = {
+			{-1, 1}, // outside
+			{1, 1}, // inside
+			{3, 1}, // inside
+			{3, 3}, // outside
+			{5, 3}, // outside, edge rejected
+			{5, -1}, // outside, edge rejected
+			{2, -2}, // outside, edge rejected
+			{2, 4} // outside, edge crosses the rectangle
+		};
+
+		std::vector<r4::segment2<float>> out(polyline.size() - 1);
+
+		auto n = r4::clip_polyline(utki::make_span(std::as_const(polyline)), rect, utki::make_span(out));
+
+		tst::check_eq(n, size_t(4), SL);
+		tst::check_eq(out[0].p1, r4::vector2<float>(0, 1), SL);
+		tst::check_eq(out[0].p2, r4::vector2<float>(1, 1), SL);
+		tst::check_eq(out[1].p1, r4::vector2<float>(1, 1), SL);
+		tst::check_eq(out[1].p2, r4::vector2<float>(3, 1), SL);
+		tst::check_eq(out[2].p1, r4::vector2<float>(3, 1), SL);
+		tst::check_eq(out[2].p2, r4::vector2<float>(3, 2), SL);
+		tst::check_eq(out[3].p1, r4::vector2<float>(2, 0), SL);
+		tst::check_eq(out[3].p2, r4::vector2<float>(2, 2), SL);
+    });
+
+    suite.add("clip_polyline_long", []{
+        // longer than internal batch of outcodes
+		r4::rectangle<float> rect(-10, -10, 20, 20);
+
+		std::vector<r4::vector2<float>> polyline;
+		for(unsigned i = 0; i != 1000; ++i){
+			polyline.emplace_back(float(int(i * 7) % 31 - 15), float(int(i * 13) % 29 - 14));
+		}
+
+		std::vector<r4::segment2<float>> out(polyline.size() - 1);
+		auto n = r4::clip_polyline(utki::make_span(std::as_const(polyline)), rect, utki::make_span(out));
+
+		size_t expected = 0;
+		for(size_t i = 1; i != polyline.size(); ++i){
+			r4::segment2<float> s{polyline[i - 1], polyline[i]};
+			if(r4::clip(s, rect)){
+				tst::check_eq(out[expected].p1, s.p1, SL);
+				tst::check_eq(out[expected].p2, s.p2, SL);
+				++expected;
+			}
+		}
+		tst::check_eq(n, expected, SL);
+		tst::check_lt(n, polyline.size() - 1, SL);
+    });
+
+    suite.add("clip_polygon_capacity", []{
+        tst::check_eq(r4::clip_polygon_capacity(0), size_t(0), SL);
+		tst::check_eq(r4::clip_polygon_capacity(3), size_t(13), SL);
+		tst::check_eq(r4::clip_polygon_capacity(4), size_t(19), SL);
+    });
+
+    suite.add("clip_polygon", []{
+        r4::rectangle<float> rect(-1, -1, 2, 2);
+
+		auto clip = [&rect](const std::vector<r4::vector2<float>>& polygon){
+			std::vector<r4::vector2<float>> out(r4::clip_polygon_capacity(polygon.size()));
+			std::vector<r4::vector2<float>> buffer(out.size());
+			auto n = r4::clip_polygon(utki::make_span(polygon), rect, utki::make_span(out), utki::make_span(buffer));
+			out.resize(n);
+			return out;
+		};
+
+		// inside, copied as is
+		{
+			std::vector<r4::vector2<float>> polygon = {{0, 0}, {1, 0}, {0, 1}};
+			auto res = clip(polygon);
+			tst::check(res == polygon, SL);
+		}
+
+		// outside
+		{
+			auto res = clip({{2, 0}, {3, 0}, {2, 1}});
+			tst::check(res.empty(), SL);
+		}
+
+		// outside, but not trivially rejected by outcodes
+		{
+			auto res = clip({{0.5f, 2}, {2, 0.5f}, {2, 2}});
+			tst::check(res.empty(), SL);
+		}
+
+		// rectangle is inside of the polygon
+		{
+			auto res = clip({{-2, -2}, {2, -2}, {2, 2}, {-2, 2}});
+			tst::check_eq(res.size(), size_t(4), SL);
+			tst::check_eq(area<float>(utki::make_span(res)), 4.0f, SL);
+			for(const auto& p : res){
+				tst::check_eq(std::abs(p.x()), 1.0f, SL);
+				tst::check_eq(std::abs(p.y()), 1.0f, SL);
+			}
+		}
+
+		// diamond with corners cut off
+		{
+			auto res = clip({{0, -1.5f}, {1.5f, 0}, {0, 1.5f}, {-1.5f, 0}});
+			tst::check_eq(res.size(), size_t(8), SL);
+			tst::check_eq(area<float>(utki::make_span(res)), 3.5f, SL);
+			for(const auto& p : res){
+				tst::check(is_inside(p, rect), SL);
+			}
+		}
+
+		// concave polygon, U-shape with the bottom part cut off
+		{
+			auto res = clip({{-2, -2}, {2, -2}, {2, 2}, {0.5f, 2}, {0.5f, -0.5f}, {-0.5f, -0.5f}, {-0.5f, 2}, {-2, 2}});
+			tst::check_eq(area<float>(utki::make_span(res)), 4.0f - 1.5f, SL);
+			for(const auto& p : res){
+				tst::check(is_inside(p, rect), SL);
+			}
+		}
+    });
+
+    suite.add("clip_polygon_shared_edge", []{
+        // edge shared by two polygons is clipped to the same points regardless of its direction
+		r4::rectangle<double> rect(0, 0, 1, 1);
+
+		std::vector<r4::vector2<double>> a = {{-0.3, 0.1}, {1.7, 0.9}, {-0.3, 0.9}};
+		std::vector<r4::vector2<double>> b = {{-0.3, 0.1}, {1.7, 0.1}, {1.7, 0.9}};
+
+		std::vector<r4::vector2<double>> out_a(r4::clip_polygon_capacity(3));
+		std::vector<r4::vector2<double>> out_b(out_a.size());
+		std::vector<r4::vector2<double>> buffer(out_a.size());
+
+		auto na = r4::clip_polygon(utki::make_span(std::as_const(a)), rect, utki::make_span(out_a), utki::make_span(buffer));
+		auto nb = r4::clip_polygon(utki::make_span(std::as_const(b)), rect, utki::make_span(out_b), utki::make_span(buffer));
+
+		size_t num_shared = 0;
+		for(size_t i = 0; i != na; ++i){
+			for(size_t j = 0; j != nb; ++j){
+				if(out_a[i] == out_b[j]){
+					++num_shared;
+				}
+			}
+		}
+		tst::check_eq(num_shared, size_t(2), SL);
+		tst::check_eq(area<double>(utki::make_span(out_a.data(), na)) + area<double>(utki::make_span(out_b.data(), nb)), 0.8, SL);
+    });
+});
+}
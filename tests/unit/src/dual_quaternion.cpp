@@ -0,0 +1,228 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/dual_quaternion.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::dual_quaternion<float>;
+template class r4::dual_quaternion<double>;
+
+namespace{
+bool is_near(const r4::vector3<float>& a, const r4::vector3<float>& b, float eps = 1e-5f){
+	for(size_t i = 0; i != 3; ++i){
+		if(std::abs(a[i] - b[i]) > eps){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool is_near(const r4::matrix4<float>& a, const r4::matrix4<float>& b, float eps = 1e-5f){
+	for(size_t r = 0; r != 4; ++r){
+		for(size_t c = 0; c != 4; ++c){
+			if(std::abs(a[r][c] - b[r][c]) > eps){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+r4::quaternion<float> make_rotation(size_t i){
+	return r4::quaternion<float>(r4::vector3<float>(0.3f * float(i % 7), 0.2f, -0.1f * float(i)));
+}
+
+r4::vector3<float> make_translation(size_t i){
+	return {float(i % 5), float(i % 3) - 1, 0.5f * float(i)};
+}
+
+r4::dual_quaternion<float> make_dq(size_t i){
+	return {make_rotation(i), make_translation(i)};
+}
+
+const std::vector<r4::vector3<float>> points = {
+	{0, 0, 0},
+	{1, 2, 3},
+	{-4, 0.5f, 2},
+	{10, -10, 0.1f}
+};
+
+tst::set set("dual_quaternion", [](tst::suite& suite){
+    suite.add("set_identity", []{
+        auto q = make_dq(3);
+		q.set_identity();
+
+		for(const auto& p : points){
+			tst::check(is_near(q * p, p), SL);
+		}
+    });
+
+    suite.add("constructor_rotation_translation", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto r = make_rotation(i);
+			auto t = make_translation(i);
+			r4::dual_quaternion<float> q(r, t);
+
+			tst::check(q.rotation() == r, SL);
+			tst::check(is_near(q.translation(), t), SL);
+			for(const auto& p : points){
+				tst::check(is_near(q * p, r4::vector3<float>(p).rotate(r) + t, 1e-4f), SL);
+			}
+		}
+    });
+
+    suite.add("to_matrix", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto q = make_dq(i);
+
+			r4::matrix4<float> m;
+			m.set_identity();
+			m.translate(make_translation(i));
+			m.rotate(make_rotation(i));
+
+			tst::check(is_near(q.to_matrix(), m, 1e-4f), SL);
+		}
+    });
+
+    suite.add("constructor_matrix4", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto q = make_dq(i);
+			r4::dual_quaternion<float> d(q.to_matrix());
+
+			tst::check(is_near(d.to_matrix(), q.to_matrix(), 1e-4f), SL);
+		}
+    });
+
+    suite.add("operator_percent", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto a = make_dq(i);
+			auto b = make_dq(i + 4);
+
+			auto c = a % b;
+			tst::check(is_near(c.to_matrix(), a.to_matrix() * b.to_matrix(), 1e-4f), SL);
+			for(const auto& p : points){
+				tst::check(is_near(c * p, a * (b * p), 1e-4f), SL);
+			}
+
+			a %= b;
+			tst::check(a.real == c.real, SL);
+			tst::check(a.dual == c.dual, SL);
+		}
+    });
+
+    suite.add("conjugate", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto q = make_dq(i);
+			auto inv = !q;
+
+			for(const auto& p : points){
+				tst::check(is_near(inv * (q * p), p, 1e-4f), SL);
+			}
+
+			q.conjugate();
+			tst::check(q.real == inv.real, SL);
+			tst::check(q.dual == inv.dual, SL);
+		}
+    });
+
+    suite.add("arithmetic", []{
+        r4::dual_quaternion<float> a(r4::quaternion<float>(1, 2, 3, 4), r4::quaternion<float>(5, 6, 7, 8));
+		r4::dual_quaternion<float> b(r4::quaternion<float>(1, 1, 1, 1), r4::quaternion<float>(2, 2, 2, 2));
+
+		auto s = a + b;
+		tst::check(s.real == r4::quaternion<float>(2, 3, 4, 5), SL);
+		tst::check(s.dual == r4::quaternion<float>(7, 8, 9, 10), SL);
+
+		auto m = 2.0f * a;
+		tst::check(m.real == r4::quaternion<float>(2, 4, 6, 8), SL);
+		tst::check(m.dual == r4::quaternion<float>(10, 12, 14, 16), SL);
+
+		a.mul_add(b, 3);
+		tst::check(a.real == r4::quaternion<float>(4, 5, 6, 7), SL);
+		tst::check(a.dual == r4::quaternion<float>(11, 12, 13, 14), SL);
+    });
+
+    suite.add("normalize", []{
+        auto q = make_dq(5) * 3.0f;
+		q.normalize();
+
+		tst::check(std::abs(q.real.norm() - 1) < 1e-6f, SL);
+		tst::check(is_near(q * points[1], make_dq(5) * points[1], 1e-4f), SL);
+    });
+
+    suite.add("skin_single_bone", []{
+        std::vector<r4::dual_quaternion<float>> bones;
+		for(size_t i = 0; i != 5; ++i){
+			bones.push_back(make_dq(i));
+		}
+
+		// all weight is given to one bone, the rest of the influences are 0
+		std::vector<r4::bone_influences<float, 4>> influences;
+		for(size_t i = 0; i != points.size(); ++i){
+			influences.push_back({{uint32_t(i), 0, 1, 2}, {1, 0, 0, 0}});
+		}
+
+		std::vector<r4::vector3<float>> out(points.size());
+		r4::skin(utki::make_span(bones), utki::make_span(influences), utki::make_span(points), utki::make_span(out));
+
+		for(size_t i = 0; i != points.size(); ++i){
+			tst::check(is_near(out[i], bones[i] * points[i], 1e-4f), SL);
+		}
+
+		// in-place, spans of non-const vector
+		auto in_place = points;
+		r4::skin(utki::make_span(bones), utki::make_span(influences), utki::make_span(in_place), utki::make_span(in_place));
+		tst::check(in_place == out, SL);
+    });
+
+    suite.add("skin_blend", []{
+        std::vector<r4::dual_quaternion<float>> bones;
+		for(size_t i = 0; i != 8; ++i){
+			bones.push_back(make_dq(i));
+		}
+
+		std::vector<r4::bone_influences<float, 8>> influences;
+		for(size_t i = 0; i != points.size(); ++i){
+			r4::bone_influences<float, 8> inf{};
+			for(size_t j = 0; j != 8; ++j){
+				inf.bones[j] = uint32_t((i + j * 3) % bones.size());
+				inf.weights[j] = float(j + 1) / 36;
+			}
+			influences.push_back(inf);
+		}
+
+		std::vector<r4::vector3<float>> out(points.size());
+		r4::skin(utki::make_span(std::as_const(bones)), utki::make_span(std::as_const(influences)), utki::make_span(points), utki::make_span(out));
+
+		for(size_t i = 0; i != points.size(); ++i){
+			const auto& inf = influences[i];
+			auto b = bones[inf.bones[0]] * inf.weights[0];
+			for(size_t j = 1; j != 8; ++j){
+				const auto& bone = bones[inf.bones[j]];
+				b += bone * (bone.real * bones[inf.bones[0]].real < 0 ? -inf.weights[j] : inf.weights[j]);
+			}
+			b.normalize();
+			tst::check(is_near(out[i], b * points[i], 1e-4f), SL);
+		}
+    });
+
+    suite.add("skin_antipodal_bones", []{
+        // q and -q represent the same transformation, blending must not depend on the sign
+		std::vector<r4::dual_quaternion<float>> bones = {make_dq(1), make_dq(2)};
+		auto negated = bones;
+		negated[1] *= -1;
+
+		std::vector<r4::bone_influences<float, 2>> influences(points.size(), {{0, 1}, {0.25f, 0.75f}});
+
+		std::vector<r4::vector3<float>> out(points.size());
+		r4::skin(utki::make_span(std::as_const(bones)), utki::make_span(std::as_const(influences)), utki::make_span(points), utki::make_span(out));
+
+		std::vector<r4::vector3<float>> out_negated(points.size());
+		r4::skin(utki::make_span(std::as_const(negated)), utki::make_span(std::as_const(influences)), utki::make_span(points), utki::make_span(out_negated));
+
+		for(size_t i = 0; i != points.size(); ++i){
+			tst::check(is_near(out[i], out_negated[i], 1e-4f), SL);
+		}
+    });
+});
+}
@@ -0,0 +1,99 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/expr.hpp"
+
+using r4::expr::lazy;
+
+namespace{
+tst::set set("expr", [](tst::suite& suite){
+    suite.add("vector_expression_equals_eager_evaluation", []{
+        r4::vector4<float> a{1, -2, 3.5f, 4};
+		r4::vector4<float> b{-5, 6, 7, 0.25f};
+		r4::vector4<float> c{9, 10, -11, 12};
+
+		r4::vector4<float> r = lazy(a) + lazy(b) * 2.0f - c / 4.0f;
+		tst::check_eq(r, a + b * 2.0f - c / 4.0f, SL);
+
+		r = -lazy(a) + b - 3.0f * lazy(c);
+		tst::check_eq(r, -a + b - c * 3.0f, SL);
+
+		// vector can be the left operand
+		r = a - lazy(b);
+		tst::check_eq(r, a - b, SL);
+
+		r = comp_mul(lazy(a), b) + comp_div(lazy(c), b);
+		tst::check_eq(r, a.comp_mul(b) + c.comp_div(b), SL);
+    });
+
+    suite.add("vector_expression_int", []{
+        r4::vector3<int> a{1, 2, 3};
+		r4::vector3<int> b{4, 5, 6};
+
+		auto r = eval(lazy(a) * 3 - b / 2);
+
+		tst::check_eq(r, r4::vector3<int>{1, 4, 6}, SL);
+    });
+
+    suite.add("dot_product", []{
+        r4::vector3<float> a{1, 2, 3};
+		r4::vector3<float> b{4, 5, 6};
+		r4::vector3<float> c{-1, 0, 2};
+
+		float d = (lazy(a) + b) * c;
+		tst::check_eq(d, (a + b) * c, SL);
+
+		d = c * (lazy(a) - b);
+		tst::check_eq(d, c * (a - b), SL);
+    });
+
+    suite.add("compound_assignment", []{
+        r4::vector2<double> a{1, 2};
+		r4::vector2<double> b{3, 5};
+
+		r4::vector2<double> r{10, 20};
+		r += lazy(a) * 2.0 + b;
+		tst::check_eq(r, r4::vector2<double>{15, 29}, SL);
+
+		r -= lazy(b) - a;
+		tst::check_eq(r, r4::vector2<double>{13, 26}, SL);
+    });
+
+    suite.add("matrix_expression", []{
+        r4::matrix3<float> a{
+			{1, 2, 3},
+			{4, 5, 6},
+			{7, 8, 9}
+		};
+		r4::matrix3<float> b;
+		b.set_identity();
+
+		r4::matrix3<float> r = lazy(a) * 2.0f - b + a / 2.0f;
+
+		r4::matrix3<float> expected = a;
+		expected *= 2.0f;
+		expected = expected - b;
+		for(size_t i = 0; i != expected.size(); ++i){
+			expected[i] += a[i] / 2.0f;
+		}
+		tst::check_eq(r, expected, SL);
+
+		r += comp_mul(lazy(a), b);
+		expected[0][0] += 1;
+		expected[1][1] += 5;
+		expected[2][2] += 9;
+		tst::check_eq(r, expected, SL);
+    });
+
+    suite.add("constexpr_evaluation", []{
+        constexpr r4::vector2<int> a{1, 2};
+		constexpr r4::vector2<int> b{3, 4};
+		constexpr auto r = eval(lazy(a) * 2 + b);
+		constexpr auto d = (lazy(a) + b) * b;
+
+		static_assert(r[0] == 5, "");
+		static_assert(r[1] == 8, "");
+		static_assert(d == 36, "");
+    });
+});
+}
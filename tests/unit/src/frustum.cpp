@@ -0,0 +1,160 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/frustum.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::frustum<float>;
+template class r4::frustum<double>;
+
+namespace{
+// perspective projection of camera at (0, 0, 50) looking towards negative z
+template <typename T> constexpr r4::matrix4<T> make_view_projection(){
+	r4::matrix4<T> m{};
+	m.set_frustum(-1, 1, -1, 1, 1, 100);
+	m.translate(0, 0, -50);
+	return m;
+}
+
+template <typename T> std::vector<r4::vector4<T>> make_spheres(size_t n){
+	std::vector<r4::vector4<T>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.push_back(r4::vector4<T>(
+				T(int(i * 7) % 161 - 80),
+				T(int(i * 3) % 41 - 20),
+				T(int(i * 11) % 200 - 120),
+				T(i % 4) * T(1.5)
+			));
+	}
+	return ret;
+}
+
+template <typename T> void check_batch_culling(size_t n){
+	r4::frustum<T> f(make_view_projection<T>());
+
+	auto spheres = make_spheres<T>(n);
+
+	std::vector<uint32_t> mask(r4::frustum<T>::mask_size(n), 0xffffffff);
+	size_t num_visible = f.cull(utki::make_span(spheres), utki::make_span(mask));
+
+	size_t expected_num_visible = 0;
+	for(size_t i = 0; i != n; ++i){
+		bool v = f.overlaps(r4::vector3<T>(spheres[i]), spheres[i].w());
+		tst::check_eq(bool((mask[i / 32] >> (i % 32)) & 1), v, SL);
+		if(v){
+			++expected_num_visible;
+		}
+	}
+	tst::check_eq(num_visible, expected_num_visible, SL);
+	tst::check(n < 32 || (num_visible != 0 && num_visible != n), SL);
+
+	std::vector<r4::vector3<T>> min;
+	std::vector<r4::vector3<T>> max;
+	for(const auto& s : spheres){
+		r4::vector3<T> c(s);
+		r4::vector3<T> e(s.w(), s.w() * 2, s.w() / 2);
+		min.push_back(c - e);
+		max.push_back(c + e);
+	}
+
+	std::fill(mask.begin(), mask.end(), 0xffffffff);
+	num_visible = f.cull(utki::make_span(min), utki::make_span(max), utki::make_span(mask));
+
+	expected_num_visible = 0;
+	for(size_t i = 0; i != n; ++i){
+		bool v = f.overlaps(min[i], max[i]);
+		tst::check_eq(bool((mask[i / 32] >> (i % 32)) & 1), v, SL);
+		if(v){
+			++expected_num_visible;
+		}
+	}
+	tst::check_eq(num_visible, expected_num_visible, SL);
+	tst::check(n < 32 || (num_visible != 0 && num_visible != n), SL);
+
+	// bits past the last object are cleared
+	if(n % 32 != 0){
+		tst::check_eq(mask.back() >> (n % 32), uint32_t(0), SL);
+	}
+}
+}
+
+namespace{
+tst::set set("frustum", [](tst::suite& suite){
+    suite.add("planes_from_matrix", []{
+        r4::matrix4<double> m;
+		m.set_frustum(-1, 1, -1, 1, 1, 100);
+
+		r4::frustum<double> f(m);
+
+		const double s = std::sqrt(0.5);
+
+		// left, right, bottom, top
+		tst::check_lt((f.planes[0] - r4::vector4<double>(s, 0, -s, 0)).norm(), 1e-12, SL);
+		tst::check_lt((f.planes[1] - r4::vector4<double>(-s, 0, -s, 0)).norm(), 1e-12, SL);
+		tst::check_lt((f.planes[2] - r4::vector4<double>(0, s, -s, 0)).norm(), 1e-12, SL);
+		tst::check_lt((f.planes[3] - r4::vector4<double>(0, -s, -s, 0)).norm(), 1e-12, SL);
+
+		// near plane is z = -1, far plane is z = -100
+		tst::check_lt((f.planes[4] - r4::vector4<double>(0, 0, -1, -1)).norm(), 1e-12, SL);
+		tst::check_lt((f.planes[5] - r4::vector4<double>(0, 0, 1, 100)).norm(), 1e-9, SL);
+
+		tst::check_lt(std::abs(f.distance(4, r4::vector3<double>(3, 4, -11)) - 10), 1e-12, SL);
+    });
+
+    suite.add("contains", []{
+        r4::frustum<float> f(make_view_projection<float>());
+
+		tst::check(f.contains(r4::vector3<float>(0, 0, 0)), SL);
+		tst::check(f.contains(r4::vector3<float>(4, -4, 40)), SL);
+		tst::check(!f.contains(r4::vector3<float>(0, 0, 49.5f)), SL);
+		tst::check(!f.contains(r4::vector3<float>(0, 0, 60)), SL);
+		tst::check(!f.contains(r4::vector3<float>(0, 0, -60)), SL);
+		tst::check(f.contains(r4::vector3<float>(30, 0, 0)), SL);
+		tst::check(!f.contains(r4::vector3<float>(60, 0, 0)), SL);
+		tst::check(!f.contains(r4::vector3<float>(0, -60, 0)), SL);
+    });
+
+    suite.add("overlaps_sphere", []{
+        r4::frustum<float> f(make_view_projection<float>());
+
+		tst::check(f.overlaps(r4::vector3<float>(0, 0, 0), 1), SL);
+		tst::check(!f.overlaps(r4::vector3<float>(0, 0, 55), 1), SL);
+		tst::check(f.overlaps(r4::vector3<float>(0, 0, 55), 7), SL);
+		tst::check(!f.overlaps(r4::vector3<float>(80, 0, 0), 10), SL);
+		tst::check(f.overlaps(r4::vector3<float>(80, 0, 0), 30), SL);
+		tst::check(!f.overlaps(r4::vector3<float>(0, 0, -60), 5), SL);
+		tst::check(f.overlaps(r4::vector3<float>(0, 0, -60), 15), SL);
+    });
+
+    suite.add("overlaps_box", []{
+        r4::frustum<float> f(make_view_projection<float>());
+
+		tst::check(f.overlaps(r4::vector3<float>(-1, -1, -1), r4::vector3<float>(1, 1, 1)), SL);
+		tst::check(!f.overlaps(r4::vector3<float>(-1, -1, 52), r4::vector3<float>(1, 1, 60)), SL);
+		tst::check(f.overlaps(r4::vector3<float>(-1, -1, 40), r4::vector3<float>(1, 1, 60)), SL);
+		tst::check(!f.overlaps(r4::vector3<float>(70, -1, -1), r4::vector3<float>(80, 1, 1)), SL);
+
+		// box containing the whole frustum
+		tst::check(f.overlaps(r4::vector3<float>(-1000, -1000, -1000), r4::vector3<float>(1000, 1000, 1000)), SL);
+    });
+
+    suite.add("cull_float", []{
+        check_batch_culling<float>(0);
+		check_batch_culling<float>(3);
+		check_batch_culling<float>(32);
+		check_batch_culling<float>(101);
+    });
+
+    suite.add("cull_double", []{
+        check_batch_culling<double>(4);
+		check_batch_culling<double>(65);
+    });
+
+    suite.add("constexpr_construction", []{
+        constexpr r4::frustum<double> f(make_view_projection<double>());
+
+		static_assert(f.contains(r4::vector3<double>(0, 0, 0)), "");
+		static_assert(!f.contains(r4::vector3<double>(0, 0, 60)), "");
+    });
+});
+}
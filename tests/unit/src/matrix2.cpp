@@ -120,6 +120,59 @@ tst::set set("matrix2", [](tst::suite& suite){
         tst::check_eq(m[1][0], 42, SL); tst::check_eq(m[1][1], 51, SL); tst::check_eq(m[1][2], 66, SL);
     });
 
+    suite.add("multiply_matrix2_float_double", []{
+        // checks SIMD implementation against integer one, which is exact
+		r4::matrix2<int> a{
+		 	{1, 2, 3},
+			{5, -6, 7}
+		};
+
+		r4::matrix2<int> b{
+		 	{17, 18, -19},
+			{-21, 22, 23}
+		};
+
+		auto ab = a * b;
+		auto ba = b * a;
+		auto aa = a * a;
+
+		auto fa = a.to<float>();
+		auto fb = b.to<float>();
+		auto da = a.to<double>();
+		auto db = b.to<double>();
+
+		auto check_rows = [](auto m, const auto& cmp){
+			auto mi = m.template to<int>();
+			for(size_t i = 0; i != cmp.size(); ++i){
+				tst::check_eq(mi[i], cmp[i], SL);
+			}
+		};
+
+		check_rows(fa * fb, ab);
+		check_rows(da * db, ab);
+
+		auto r = fa;
+		r *= fb;
+		check_rows(r, ab);
+
+		r = fa;
+		r.left_mul(fb);
+		check_rows(r, ba);
+
+		// multiplying matrix by itself in place
+		r = fa;
+		r *= r;
+		check_rows(r, aa);
+
+		r = fa;
+		r.left_mul(r);
+		check_rows(r, aa);
+
+		auto rd = db;
+		rd.left_mul(da);
+		check_rows(rd, ab);
+    });
+
     suite.add("left_multiply_matrix2", []{
         r4::matrix2<int> m1{
             {1, 2, 3},
@@ -261,5 +314,53 @@ tst::set set("matrix2", [](tst::suite& suite){
 
 		tst::check_eq(diff, decltype(m)().set(0), SL);
     });
+
+    suite.add("inv_affine", []{
+        r4::matrix2<float> m{
+		 	{1.0f, 3.0f, 5.0f},
+			{2.0f, 3.0f, 1.0f},
+		};
+
+		auto inv = m.inv_affine();
+
+		tst::check_eq(inv, m.inv(), SL);
+
+		auto i = m * inv;
+
+		const float epsilon = 1e-6f;
+
+		auto diff = decltype(m)().set_identity() - i;
+
+		diff.snap_to_zero(epsilon);
+
+		tst::check_eq(diff, decltype(m)().set(0), SL);
+    });
+
+    suite.add("transform_span_vector2", []{
+        r4::matrix2<float> m;
+		m.set_identity();
+		m.translate(3, -4);
+		m.rotate(0.3f);
+		m.scale(2, 0.5f);
+
+		std::vector<r4::vector2<float>> in;
+		for(int i = 0; i != 5; ++i){
+			in.push_back(r4::vector2<float>(float(i), float(i * 2 - 5)));
+		}
+
+		std::vector<r4::vector2<float>> out(in.size());
+
+		r4::transform(m, utki::make_span(in), utki::make_span(out));
+
+		for(size_t i = 0; i != in.size(); ++i){
+			auto diff = out[i] - m * in[i];
+			diff.snap_to_zero(1e-5f);
+			tst::check(diff.is_zero(), SL);
+		}
+
+		// in-place
+		r4::transform(m, utki::make_span(in), utki::make_span(in));
+		tst::check(in == out, SL);
+    });
 });
 }
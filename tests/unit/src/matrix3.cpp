@@ -195,6 +195,61 @@ tst::set set("matrix3", [](tst::suite& suite){
         tst::check_eq(m1, r, SL);
     });
 
+    suite.add("multiply_matrix3_float_double", []{
+        // checks SIMD implementation against integer one, which is exact
+		r4::matrix3<int> a{
+		 	{1, 2, 3},
+			{5, -6, 7},
+			{9, 10, -11}
+		};
+
+		r4::matrix3<int> b{
+		 	{17, 18, 19},
+			{21, -22, 23},
+			{-25, 26, 27}
+		};
+
+		auto ab = a * b;
+		auto ba = b * a;
+		auto aa = a * a;
+
+		auto fa = a.to<float>();
+		auto fb = b.to<float>();
+		auto da = a.to<double>();
+		auto db = b.to<double>();
+
+		auto check_rows = [](auto m, const auto& cmp){
+			auto mi = m.template to<int>();
+			for(size_t i = 0; i != cmp.size(); ++i){
+				tst::check_eq(mi[i], cmp[i], SL);
+			}
+		};
+
+		check_rows(fa * fb, ab);
+		check_rows(da * db, ab);
+
+		auto r = fa;
+		r *= fb;
+		check_rows(r, ab);
+
+		r = fa;
+		r.left_mul(fb);
+		check_rows(r, ba);
+
+		// multiplying matrix by itself in place
+		r = fa;
+		r *= r;
+		check_rows(r, aa);
+
+		r = fa;
+		r.left_mul(r);
+		check_rows(r, aa);
+
+		auto rd = db;
+		rd.left_mul(da);
+		check_rows(rd, ab);
+    });
+
     suite.add("left_mul_matrix3", []{
         r4::matrix3<int> m1{
                 { 1, 2, 3 },
@@ -399,5 +454,23 @@ tst::set set("matrix3", [](tst::suite& suite){
 
 		tst::check_eq(diff, decltype(m)().set(0), SL);
     });
+
+    suite.add("inv_int", []{
+        r4::matrix3<int> m{
+		 	{0, 1, 0},
+			{-1, 0, 0},
+			{0, 0, 1},
+		};
+
+		auto inv = m.inv();
+
+		r4::matrix3<int> cmp{
+		 	{0, -1, 0},
+			{1, 0, 0},
+			{0, 0, 1},
+		};
+
+		tst::check_eq(inv, cmp, SL);
+    });
 });
 }
@@ -9,6 +9,27 @@ using namespace std::string_literals;
 template class r4::matrix<int, 4, 4>;
 
 namespace{
+// builds transformation matrix, used to compare results of constant evaluation with run time ones
+template <class T> constexpr r4::matrix4<T> make_transform(){
+	r4::matrix4<T> m{};
+	m.set_identity();
+	m.translate(1, 2, 3);
+	m.scale(2, 3, 4);
+	m.rotate(r4::vector3<T>(T(0.1), T(0.2), T(0.3)));
+	return m;
+}
+
+bool is_near(const r4::matrix4<float>& a, const r4::matrix4<float>& b){
+	for(size_t r = 0; r != 4; ++r){
+		for(size_t c = 0; c != 4; ++c){
+			if(std::abs(a[r][c] - b[r][c]) > 1e-5f){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 tst::set set("matrix4", [](tst::suite& suite){
     suite.add("constructor_4x_vector4", []{
         r4::matrix4<int> m{
@@ -226,6 +247,63 @@ tst::set set("matrix4", [](tst::suite& suite){
 		tst::check_eq(str, cmp, SL);
     });
 
+    suite.add("multiply_matrix4_float_double", []{
+        // checks SIMD implementation against integer one, which is exact
+		r4::matrix4<int> a{
+		 	{1, 2, 3, 4},
+			{5, -6, 7, 8},
+			{9, 10, -11, 12},
+			{13, 14, 15, 16}
+		};
+
+		r4::matrix4<int> b{
+		 	{17, 18, 19, -20},
+			{21, 22, 23, 24},
+			{-25, 26, 27, 28},
+			{29, 30, 31, 32}
+		};
+
+		auto ab = a * b;
+		auto ba = b * a;
+		auto aa = a * a;
+
+		auto fa = a.to<float>();
+		auto fb = b.to<float>();
+		auto da = a.to<double>();
+		auto db = b.to<double>();
+
+		auto check_rows = [](auto m, const auto& cmp){
+			auto mi = m.template to<int>();
+			for(size_t i = 0; i != cmp.size(); ++i){
+				tst::check_eq(mi[i], cmp[i], SL);
+			}
+		};
+
+		check_rows(fa * fb, ab);
+		check_rows(da * db, ab);
+
+		auto r = fa;
+		r *= fb;
+		check_rows(r, ab);
+
+		r = fa;
+		r.left_mul(fb);
+		check_rows(r, ba);
+
+		// multiplying matrix by itself in place
+		r = fa;
+		r *= r;
+		check_rows(r, aa);
+
+		r = fa;
+		r.left_mul(r);
+		check_rows(r, aa);
+
+		auto rd = db;
+		rd.left_mul(da);
+		check_rows(rd, ab);
+    });
+
     suite.add("left_mul_matrix4", []{
         r4::matrix4<int> m2{
 		 	{1, 2, 3, 4},
@@ -779,5 +857,188 @@ tst::set set("matrix4", [](tst::suite& suite){
 
 		tst::check_eq(ss.str(), cmp, SL);
     });
+
+    suite.add("det_equals_laplace_expansion_by_minors", []{
+        r4::matrix4<int> m{
+		 	{2, -3, 5, 9},
+			{1, 3, 1, -7},
+			{4, 0, 9, 7},
+			{-5, 2, 6, 9}
+		};
+
+		int cmp = 0;
+		int sign = 1;
+		for(size_t i = 0; i != 4; ++i, sign = -sign){
+			cmp += sign * m[0][i] * m.minor(0, i);
+		}
+
+		tst::check_eq(m.det(), cmp, SL);
+    });
+
+    suite.add("inv_int", []{
+        r4::matrix4<int> m{
+		 	{0, 1, 0, 0},
+			{0, 0, -1, 0},
+			{1, 0, 0, 0},
+			{0, 0, 0, 1}
+		};
+
+		auto inv = m.inv();
+
+		tst::check_eq(inv, m.tposed(), SL);
+    });
+
+    suite.add("inv_affine", []{
+        r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(3, -4, 5);
+		m.rotate(r4::vector3<float>(0.3f, -0.2f, 0.7f));
+		m.scale(2, 3, 0.5f);
+
+		auto inv = m.inv_affine();
+
+		auto i = m * inv;
+
+		const float epsilon = 1e-6f;
+
+		auto diff = decltype(m)().set_identity() - i;
+
+		diff.snap_to_zero(epsilon);
+
+		tst::check_eq(diff, decltype(m)().set(0), SL);
+
+		auto diff_inv = m.inv() - inv;
+
+		diff_inv.snap_to_zero(1e-5f);
+
+		tst::check_eq(diff_inv, decltype(m)().set(0), SL);
+
+		m.invert_affine();
+
+		auto diff_inplace = m - inv;
+
+		diff_inplace.snap_to_zero(epsilon);
+
+		tst::check_eq(diff_inplace, decltype(m)().set(0), SL);
+    });
+
+    suite.add("transform_span_vector3", []{
+        r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(3, -4, 5);
+		m.rotate(r4::vector3<float>(0.3f, -0.2f, 0.7f));
+		m.scale(2, 3, 0.5f);
+
+		std::vector<r4::vector3<float>> in;
+		for(int i = 0; i != 7; ++i){
+			in.push_back(r4::vector3<float>(float(i), float(i * 2 - 5), float(3 - i)));
+		}
+
+		std::vector<r4::vector3<float>> out(in.size());
+
+		r4::transform(m, utki::make_span(in), utki::make_span(out));
+
+		for(size_t i = 0; i != in.size(); ++i){
+			auto expected = r4::vector3<float>(m * r4::vector4<float>(in[i]));
+			auto diff = out[i] - expected;
+			diff.snap_to_zero(1e-5f);
+			tst::check(diff.is_zero(), SL);
+		}
+
+		// in-place
+		r4::transform(m, utki::make_span(in), utki::make_span(in));
+		tst::check(in == out, SL);
+    });
+
+    suite.add("transform_span_vector4_int", []{
+        r4::matrix4<int> m{
+			{1, 2, 3, 4},
+			{5, 6, 7, 8},
+			{9, 10, 11, 12},
+			{13, 14, 15, 16}
+		};
+
+		std::vector<r4::vector4<int>> in = {
+			r4::vector4<int>(1, 0, 0, 0),
+			r4::vector4<int>(0, 1, 0, 0),
+			r4::vector4<int>(1, -2, 3, -4)
+		};
+
+		std::vector<r4::vector4<int>> out(in.size());
+
+		r4::transform(m, utki::make_span(in), utki::make_span(out));
+
+		tst::check_eq(out[0], r4::vector4<int>(1, 5, 9, 13), SL);
+		tst::check_eq(out[1], r4::vector4<int>(2, 6, 10, 14), SL);
+		tst::check_eq(out[2], r4::vector4<int>(-10, -18, -26, -34), SL);
+    });
+
+    suite.add("transform_span_vector4_double", []{
+        r4::matrix4<double> m;
+		m.set_frustum(-2, 2, -1.5, 1.5, 2, 100);
+
+		std::vector<r4::vector4<double>> in = {
+			r4::vector4<double>(1, 2, -3, 1),
+			r4::vector4<double>(-4, 5, -6, 0),
+			r4::vector4<double>(0.5, -0.25, -10, 2)
+		};
+
+		std::vector<r4::vector4<double>> out(in.size());
+
+		r4::transform(m, utki::make_span(in), utki::make_span(out));
+
+		for(size_t i = 0; i != in.size(); ++i){
+			auto diff = out[i] - m * in[i];
+			diff.snap_to_zero(1e-12);
+			tst::check(diff.is_zero(), SL);
+		}
+    });
+
+    suite.add("project_span_vector3", []{
+        r4::matrix4<float> m;
+		m.set_frustum(-2, 2, -1.5, 1.5, 2, 100);
+
+		std::vector<r4::vector3<float>> in = {
+			r4::vector3<float>(1, 2, -3),
+			r4::vector3<float>(-4, 5, -6),
+			r4::vector3<float>(0.5f, -0.25f, -10),
+			r4::vector3<float>(0, 0, -100),
+			r4::vector3<float>(-1, 1, -2)
+		};
+
+		std::vector<r4::vector3<float>> out(in.size());
+
+		r4::project(m, utki::make_span(in), utki::make_span(out));
+
+		for(size_t i = 0; i != in.size(); ++i){
+			auto h = m * r4::vector4<float>(in[i]);
+			auto expected = r4::vector3<float>(h) / h.w();
+			auto diff = out[i] - expected;
+			diff.snap_to_zero(1e-5f);
+			tst::check(diff.is_zero(), SL);
+		}
+    });
+
+    suite.add("constexpr_evaluation", []{
+        constexpr auto m = make_transform<float>();
+		constexpr auto inv = m.inv();
+		constexpr auto det = m.det();
+		constexpr auto p = m * r4::vector4<float>(1, 2, 3, 1);
+
+		auto rt_m = make_transform<float>();
+
+		tst::check(is_near(m, rt_m), SL);
+		tst::check(is_near(inv, rt_m.inv()), SL);
+		tst::check(std::abs(det - rt_m.det()) < 1e-3f, SL);
+		tst::check((p - rt_m * r4::vector4<float>(1, 2, 3, 1)).snap_to_zero(1e-5f).is_zero(), SL);
+
+		constexpr auto identity = m * inv;
+		tst::check(is_near(identity, r4::matrix4<float>().set_identity()), SL);
+
+		constexpr auto f = r4::matrix4<double>().set_frustum(-2, 2, -1.5, 1.5, 2, 100).tposed().tposed();
+		static_assert(f[3][2] == -1, "");
+		static_assert(f[0][0] == 1, "");
+		static_assert(f[2][3] == -400.0 / 98, "");
+    });
 });
 }
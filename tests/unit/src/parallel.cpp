@@ -0,0 +1,255 @@
+#include <stdexcept>
+
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/parallel.hpp"
+#include "../../../src/r4/rectangle.hpp"
+#include "../../../src/r4/segment2.hpp"
+
+namespace{
+std::vector<r4::vector3<float>> make_points(size_t n){
+	std::vector<r4::vector3<float>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.push_back(r4::vector3<float>(float(i % 13), float(i % 7) - 3, float(i % 1001) * 0.5f));
+	}
+	return ret;
+}
+
+const size_t thread_counts[] = {1, 2, 3, 8};
+}
+
+namespace{
+tst::set set("parallel", [](tst::suite& suite){
+    suite.add("parallel_for_visits_each_index_once", []{
+        for(auto num_threads : thread_counts){
+			for(size_t grain : {1, 7, 1000}){
+				std::vector<int> visits(5003, 0);
+				r4::parallel_for(
+						visits.size(),
+						grain,
+						[&](size_t begin, size_t end){
+							tst::check(begin < end, SL);
+							tst::check(end - begin <= grain, SL);
+							for(size_t i = begin; i != end; ++i){
+								++visits[i];
+							}
+						},
+						num_threads
+					);
+				for(auto v : visits){
+					tst::check_eq(v, 1, SL);
+				}
+			}
+		}
+    });
+
+    suite.add("parallel_for_uneven_work", []{
+        // all the work is in the first chunks, so other threads have to steal it
+		std::vector<double> out(64, 0);
+		r4::parallel_for(
+				out.size(),
+				1,
+				[&](size_t begin, size_t end){
+					for(size_t i = begin; i != end; ++i){
+						size_t n = i < 8 ? 100000 : 1;
+						double s = 0;
+						for(size_t j = 0; j != n; ++j){
+							s += double(j % 3);
+						}
+						out[i] = s;
+					}
+				},
+				4
+			);
+		tst::check_eq(out[0], 99999.0, SL);
+		tst::check_eq(out[7], 99999.0, SL);
+		tst::check_eq(out[8], 0.0, SL);
+    });
+
+    suite.add("parallel_for_empty_range", []{
+        bool called = false;
+		r4::parallel_for(0, 10, [&](size_t, size_t){called = true;});
+		tst::check(!called, SL);
+    });
+
+    suite.add("parallel_for_rethrows_exception", []{
+        bool thrown = false;
+		try{
+			r4::parallel_for(
+					1000,
+					10,
+					[](size_t begin, size_t){
+						if(begin == 500){
+							throw std::runtime_error("error");
+						}
+					},
+					4
+				);
+		}catch(std::runtime_error&){
+			thrown = true;
+		}
+		tst::check(thrown, SL);
+    });
+
+    suite.add("parallel_reduce_does_not_depend_on_number_of_threads", []{
+        std::vector<float> values;
+		for(size_t i = 0; i != 10007; ++i){
+			values.push_back(1.0f / float(i + 1));
+		}
+
+		auto sum = [&](size_t num_threads){
+			return r4::parallel_reduce(
+					values.size(),
+					64,
+					0.0f,
+					[&](size_t begin, size_t end){
+						float s = 0;
+						for(size_t i = begin; i != end; ++i){
+							s += values[i];
+						}
+						return s;
+					},
+					[](float a, float b){return a + b;},
+					num_threads
+				);
+		};
+
+		float expected = sum(1);
+		tst::check(expected > 9.0f, SL);
+		for(auto num_threads : thread_counts){
+			tst::check_eq(sum(num_threads), expected, SL);
+		}
+    });
+
+    suite.add("parallel_reduce_unite_rectangles", []{
+        std::vector<r4::rectangle<int>> rects;
+		for(int i = 0; i != 1000; ++i){
+			rects.push_back(r4::rectangle<int>{i % 17 - 5, i % 23 - 50, i % 5 + 1, i % 11 + 1});
+		}
+
+		r4::rectangle<int> expected = rects.front();
+		for(const auto& r : rects){
+			expected.unite(r);
+		}
+
+		for(auto num_threads : thread_counts){
+			auto united = r4::parallel_reduce(
+					rects.size(),
+					r4::parallel_grain<r4::rectangle<int>>() / 64,
+					rects.front(),
+					[&](size_t begin, size_t end){
+						auto u = rects[begin];
+						for(size_t i = begin + 1; i != end; ++i){
+							u.unite(rects[i]);
+						}
+						return u;
+					},
+					[](r4::rectangle<int> a, const r4::rectangle<int>& b){return a.unite(b);},
+					num_threads
+				);
+			tst::check_eq(united, expected, SL);
+		}
+    });
+
+    suite.add("parallel_reduce_unite_segment2", []{
+        std::vector<r4::vector2<int>> points;
+		for(int i = 0; i != 1000; ++i){
+			points.push_back(r4::vector2<int>{i % 17 - 5, i % 23 - 50});
+		}
+
+		auto united = r4::parallel_reduce(
+				points.size(),
+				10,
+				r4::segment2<int>{points.front(), points.front()},
+				[&](size_t begin, size_t end){
+					r4::segment2<int> s{points[begin], points[begin]};
+					for(size_t i = begin + 1; i != end; ++i){
+						s.unite(r4::segment2<int>{points[i], points[i]});
+					}
+					return s;
+				},
+				[](r4::segment2<int> a, const r4::segment2<int>& b){return a.unite(b);},
+				4
+			);
+		tst::check_eq(united.p1, r4::vector2<int>(-5, -50), SL);
+		tst::check_eq(united.p2, r4::vector2<int>(11, -28), SL);
+    });
+
+    suite.add("parallel_min_max", []{
+        auto points = make_points(100003);
+
+		for(auto num_threads : thread_counts){
+			auto bounds = r4::parallel_min_max(utki::make_span(points), num_threads);
+			tst::check_eq(bounds.first, r4::vector3<float>(0, -3, 0), SL);
+			tst::check_eq(bounds.second, r4::vector3<float>(12, 3, 500), SL);
+		}
+    });
+
+    suite.add("parallel_transform", []{
+        r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		m.rotate(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+
+		auto points = make_points(30011);
+		std::vector<r4::vector3<float>> expected(points.size());
+		r4::transform(m, utki::make_span(points), utki::make_span(expected));
+
+		for(auto num_threads : thread_counts){
+			std::vector<r4::vector3<float>> out(points.size());
+			r4::parallel_transform(m, utki::make_span(points), utki::make_span(out), num_threads);
+			tst::check(out == expected, SL);
+		}
+
+		std::vector<r4::vector4<float>> in4;
+		for(const auto& p : points){
+			in4.push_back(r4::vector4<float>(p));
+		}
+		std::vector<r4::vector4<float>> expected4(in4.size());
+		r4::transform(m, utki::make_span(in4), utki::make_span(expected4));
+		std::vector<r4::vector4<float>> out4(in4.size());
+		r4::parallel_transform(m, utki::make_span(in4), utki::make_span(out4), 3);
+		tst::check(out4 == expected4, SL);
+    });
+
+    suite.add("parallel_rotate", []{
+        r4::quaternion<double> q(r4::vector3<double>(0.1, 0.2, 0.3));
+
+		std::vector<r4::vector3<double>> expected;
+		for(const auto& p : make_points(30011)){
+			expected.push_back(p.to<double>());
+		}
+		auto points = expected;
+		r4::rotate(utki::make_span(expected), q);
+
+		r4::parallel_rotate(utki::make_span(points), q, 3);
+		tst::check(points == expected, SL);
+    });
+
+    suite.add("parallel_bounding_box", []{
+        std::vector<r4::vector2<float>> points;
+		for(size_t i = 0; i != 50021; ++i){
+			points.push_back(r4::vector2<float>(float(int(i * 7) % 1023) - 500, float(int(i * 5) % 517) * 0.5f));
+		}
+
+		auto expected = r4::segment2<float>::from_points(utki::make_span(points));
+		tst::check_eq(expected.p1, r4::vector2<float>(-500, 0), SL);
+		tst::check_eq(expected.p2, r4::vector2<float>(522, 258), SL);
+
+		for(auto num_threads : thread_counts){
+			auto bb = r4::parallel_bounding_box(utki::make_span(points), num_threads);
+			tst::check_eq(bb.p1, expected.p1, SL);
+			tst::check_eq(bb.p2, expected.p2, SL);
+
+			auto r = r4::parallel_bounding_rectangle(utki::make_span(points), num_threads);
+			tst::check_eq(r, r4::rectangle<float>::from_points(utki::make_span(points)), SL);
+		}
+
+		points.clear();
+		auto bb = r4::parallel_bounding_box(utki::make_span(points));
+		tst::check_eq(bb.p1, r4::vector2<float>(std::numeric_limits<float>::max()), SL);
+		tst::check_eq(r4::parallel_bounding_rectangle(utki::make_span(points)), r4::rectangle<float>(0, 0, 0, 0), SL);
+    });
+});
+}
@@ -7,6 +7,15 @@
 template class r4::quaternion<int>;
 
 namespace{
+bool is_near(const r4::quaternion<float>& a, const r4::quaternion<float>& b){
+	for(size_t i = 0; i != 4; ++i){
+		if(std::abs(a[i] - b[i]) > 1e-6f){
+			return false;
+		}
+	}
+	return true;
+}
+
 tst::set set("quaternion", [](tst::suite& suite){
     suite.add("constructor_x_y_z_w", []{
         r4::quaternion<int> a{3, 4, 5, 6};
@@ -225,6 +234,32 @@ tst::set set("quaternion", [](tst::suite& suite){
 		tst::check_eq(r[3], 646, SL);
     });
 
+    suite.add("normalize_fast", []{
+        r4::quaternion<float> a{3, 4, 5, 6};
+		auto cmp = a;
+
+		a.normalize_fast();
+		cmp.normalize();
+
+		tst::check(is_near(a, cmp), SL);
+		tst::check_le(std::abs(a.norm() - 1), 1e-6f, SL);
+    });
+
+    suite.add("normalize_fast_span", []{
+        std::vector<r4::quaternion<float>> a;
+		for(int i = 0; i != 10; ++i){
+			a.push_back(r4::quaternion<float>(float(i % 5) - 2, float(i % 3), float(i * i) / 7, 1) * float(i + 1));
+		}
+		auto cmp = a;
+
+		normalize_fast(utki::make_span(a));
+
+		for(size_t i = 0; i != a.size(); ++i){
+			cmp[i].normalize();
+			tst::check(is_near(a[i], cmp[i]), SL);
+		}
+    });
+
     suite.add("set_rotation_x_y_z_a", []{
         r4::quaternion<float> a{3, 4, 5, 6};
 
@@ -259,8 +294,202 @@ tst::set set("quaternion", [](tst::suite& suite){
         // TODO: test to_matrix4()
     });
 
-    suite.add_disabled("slerp_quaternion_t", []{
-        // TODO: test slerp(quaternion, t)
+    suite.add("slerp_quaternion_t", []{
+		r4::vector3<double> axis{1, 2, 3};
+		axis.normalize();
+
+		r4::quaternion<double> a;
+		a.set_rotation(axis, 0.2);
+
+		// test large and small angles, as well as angles crossing the 180 degrees rotation
+		for(double angle : {0.2001, 0.25, 1.0, 2.5, 4.0, 6.0}){
+			r4::quaternion<double> b;
+			b.set_rotation(axis, angle);
+
+			for(double t : {0.0, 0.1, 0.5, 0.75, 1.0}){
+				auto r = a.slerp(b, t);
+
+				// slerp should go along the shortest arc
+				double delta = angle - 0.2;
+				if(delta > utki::pi<double>()){
+					delta -= 2 * utki::pi<double>();
+				}
+
+				r4::quaternion<double> expected;
+				expected.set_rotation(axis, 0.2 + delta * t);
+
+				// q and -q represent the same rotation
+				if(r * expected < 0){
+					expected.negate();
+				}
+
+				auto diff = r + expected * -1.0;
+				for(auto c : diff){
+					tst::check_lt(std::abs(c), 1e-9, SL);
+				}
+				tst::check_lt(std::abs(r.norm() - 1), 1e-12, SL);
+			}
+		}
+    });
+
+    suite.add("nlerp_quaternion_t", []{
+		r4::quaternion<float> a;
+		a.set_rotation(r4::vector3<float>{0, 0, 1}, 0.5f);
+		r4::quaternion<float> b;
+		b.set_rotation(r4::vector3<float>{0, 1, 0}, -1.5f);
+
+		auto r0 = a.nlerp(b, 0);
+		auto r1 = a.nlerp(b, 1);
+		auto rh = a.nlerp(b, 0.5f);
+
+		for(size_t i = 0; i != 4; ++i){
+			tst::check_lt(std::abs(r0[i] - a[i]), 1e-6f, SL);
+			tst::check_lt(std::abs(r1[i] - b[i]), 1e-6f, SL);
+
+			// at t = 0.5 nlerp and slerp give same result
+			tst::check_lt(std::abs(rh[i] - a.slerp(b, 0.5f)[i]), 1e-6f, SL);
+		}
+		tst::check_lt(std::abs(rh.norm() - 1), 1e-6f, SL);
+
+		// interpolation goes along the shortest arc
+		auto rn = a.nlerp(b * -1.0f, 0.5f);
+		for(size_t i = 0; i != 4; ++i){
+			tst::check_lt(std::abs(rn[i] - rh[i]), 1e-6f, SL);
+		}
+    });
+
+    suite.add("slerp_fast_quaternion_t", []{
+		r4::quaternion<double> a;
+		a.set_rotation(r4::vector3<double>{0, 0, 1}, 0.3);
+
+		double max_error = 0;
+		for(double angle = 0; angle < 2 * utki::pi<double>(); angle += 0.05){
+			r4::quaternion<double> b;
+			b.set_rotation(r4::vector3<double>{0, 0.6, 0.8}, angle);
+
+			for(double t = 0; t <= 1; t += 0.05){
+				auto r = a.slerp_fast(b, t);
+				auto e = a.slerp(b, t);
+
+				tst::check_lt(std::abs(r.norm() - 1), 1e-12, SL);
+
+				using std::min;
+				using std::acos;
+				max_error = std::max(max_error, acos(min(std::abs(r * e), 1.0)));
+			}
+		}
+
+		tst::check_lt(max_error, 1e-3, SL);
+    });
+
+    suite.add("batch_interpolation", []{
+		std::vector<r4::quaternion<float>> from;
+		std::vector<r4::quaternion<float>> to;
+		std::vector<float> t;
+		for(int i = 0; i != 9; ++i){
+			from.push_back(r4::quaternion<float>().set_rotation(1, 0, 0, float(i) * 0.3f));
+			to.push_back(r4::quaternion<float>().set_rotation(0, 0.6f, 0.8f, 2.0f - float(i) * 0.4f));
+			t.push_back(float(i) / 8);
+		}
+
+		std::vector<r4::quaternion<float>> out(from.size());
+
+		r4::slerp(utki::make_span(from), utki::make_span(to), 0.3f, utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check_eq(out[i], from[i].slerp(to[i], 0.3f), SL);
+		}
+
+		r4::slerp(utki::make_span(from), utki::make_span(to), utki::make_span(t), utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check_eq(out[i], from[i].slerp(to[i], t[i]), SL);
+		}
+
+		r4::nlerp(utki::make_span(from), utki::make_span(to), 0.3f, utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check(is_near(out[i], from[i].nlerp(to[i], 0.3f)), SL);
+		}
+
+		r4::nlerp(utki::make_span(from), utki::make_span(to), utki::make_span(t), utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check(is_near(out[i], from[i].nlerp(to[i], t[i])), SL);
+		}
+
+		r4::slerp_fast(utki::make_span(from), utki::make_span(to), 0.3f, utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check(is_near(out[i], from[i].slerp_fast(to[i], 0.3f)), SL);
+		}
+
+		// in-place
+		out = from;
+		r4::slerp_fast(utki::make_span(out), utki::make_span(to), utki::make_span(t), utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			tst::check(is_near(out[i], from[i].slerp_fast(to[i], t[i])), SL);
+		}
+    });
+
+    suite.add("batch_interpolation_double", []{
+		std::vector<r4::quaternion<double>> from;
+		std::vector<r4::quaternion<double>> to;
+		for(int i = 0; i != 6; ++i){
+			from.push_back(r4::quaternion<double>().set_rotation(0.6, 0, 0.8, double(i) * 0.7));
+			to.push_back(r4::quaternion<double>().set_rotation(0, 1, 0, 3.0 - double(i) * 0.5));
+		}
+
+		std::vector<r4::quaternion<double>> out(from.size());
+
+		r4::slerp_fast(utki::make_span(from), utki::make_span(to), 0.7, utki::make_span(out));
+		for(size_t i = 0; i != out.size(); ++i){
+			auto expected = from[i].slerp_fast(to[i], 0.7);
+			for(size_t c = 0; c != 4; ++c){
+				tst::check_lt(std::abs(out[i][c] - expected[c]), 1e-12, SL);
+			}
+		}
+    });
+
+    suite.add("constexpr_evaluation", []{
+        constexpr r4::quaternion<float> a(r4::vector3<float>(0.3f, -0.2f, 0.5f));
+		constexpr r4::quaternion<float> b = r4::quaternion<float>().set_rotation(0, 1, 0, 1.5f);
+		constexpr auto product = a % b;
+		constexpr auto interpolated = a.slerp_fast(b, 0.3f);
+
+		r4::quaternion<float> rt_a(r4::vector3<float>(0.3f, -0.2f, 0.5f));
+		r4::quaternion<float> rt_b;
+		rt_b.set_rotation(0, 1, 0, 1.5f);
+
+		tst::check(is_near(a, rt_a), SL);
+		tst::check(is_near(b, rt_b), SL);
+		tst::check(is_near(product, rt_a % rt_b), SL);
+		tst::check(is_near(interpolated, rt_a.slerp_fast(rt_b, 0.3f)), SL);
+    });
+
+    suite.add("mul_add_quaternion_number", []{
+        r4::quaternion<int> a{3, 4, 5, 6};
+
+		a.mul_add(r4::quaternion<int>{1, 2, 3, 4}, 2);
+
+		tst::check_eq(a, r4::quaternion<int>{5, 8, 11, 14}, SL);
+    });
+
+    suite.add("fma_quaternion", []{
+        r4::quaternion<float> a{1, 2, 3, 4};
+		r4::quaternion<float> c{0.5f, 0, -1, 1};
+
+		auto r = fma(a, -0.5f, c);
+
+		tst::check_eq(r, r4::quaternion<float>{0, -1, -2.5f, -1}, SL);
+    });
+
+    suite.add("operator_percent_quaternion_float", []{
+        r4::quaternion<float> a{0.5f, -1, 2, 0.25f};
+		r4::quaternion<float> b{-2, 0.5f, 1, 4};
+
+		// Hamilton product
+		auto r = a % b;
+
+		tst::check_eq(r[0], 0.25f * -2 + 0.5f * 4 + -1 * 1 - 2 * 0.5f, SL);
+		tst::check_eq(r[1], 0.25f * 0.5f + -1 * 4 + 2 * -2 - 0.5f * 1, SL);
+		tst::check_eq(r[2], 0.25f * 1 + 2 * 4 + 0.5f * 0.5f - -1 * -2, SL);
+		tst::check_eq(r[3], 0.25f * 4 - 0.5f * -2 - -1 * 0.5f - 2 * 1, SL);
     });
 });
 }
@@ -0,0 +1,192 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/ray2.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::ray2<float>;
+template class r4::ray2<double>;
+
+namespace{
+template <typename T> std::vector<r4::rectangle<T>> make_rectangles(size_t n){
+	std::vector<r4::rectangle<T>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.emplace_back(T(int(i * 7) % 23 - 11), T(int(i * 5) % 17 - 8), T(i % 4), T(i % 3));
+	}
+	return ret;
+}
+
+template <typename T> std::vector<r4::ray2<T>> make_rays(size_t n){
+	std::vector<r4::ray2<T>> ret;
+	for(size_t i = 0; i != n; ++i){
+		// some of the rays are axis-parallel
+		ret.emplace_back(
+				r4::vector2<T>(T(int(i * 3) % 13 - 6), T(int(i * 11) % 7 - 3)),
+				r4::vector2<T>(T(int(i % 5) - 2), T(int(i * 7) % 5 - 2))
+			);
+	}
+	return ret;
+}
+
+template <typename T> bool get_bit(const std::vector<uint32_t>& mask, size_t i){
+	return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+template <typename T> void check_intersects_rectangles(){
+	auto rays = make_rays<T>(20);
+
+	// various sizes to cover SIMD loop and its tail
+	for(size_t n = 0; n != 40; ++n){
+		auto rects = make_rectangles<T>(n);
+		for(const auto& r : rays){
+			for(T t_max : {T(1), std::numeric_limits<T>::infinity()}){
+				std::vector<uint32_t> mask(r4::ray2<T>::mask_size(n), 0xffffffff);
+				size_t num_hits = r.intersects(utki::make_span(std::as_const(rects)), utki::make_span(mask), t_max);
+
+				size_t expected_num_hits = 0;
+				for(size_t i = 0; i != n; ++i){
+					bool hit = r.intersects(rects[i], t_max);
+					tst::check_eq(get_bit<T>(mask, i), hit, SL);
+					if(hit){
+						++expected_num_hits;
+					}
+				}
+				tst::check_eq(num_hits, expected_num_hits, SL);
+				if(n % 32 != 0){
+					tst::check_eq(mask.back() >> (n % 32), uint32_t(0), SL);
+				}
+			}
+		}
+	}
+}
+
+template <typename T> void check_rays_intersect_rectangle(){
+	auto rects = make_rectangles<T>(10);
+
+	// packets of 4, 8 and 16 rays, and other sizes to cover SIMD loop and its tail
+	for(size_t n = 0; n != 40; ++n){
+		auto rays = make_rays<T>(n);
+		for(const auto& rect : rects){
+			for(T t_max : {T(1), std::numeric_limits<T>::infinity()}){
+				std::vector<uint32_t> mask(r4::ray2<T>::mask_size(n), 0xffffffff);
+				size_t num_hits = r4::intersects(utki::make_span(rays), rect, utki::make_span(mask), t_max);
+
+				size_t expected_num_hits = 0;
+				for(size_t i = 0; i != n; ++i){
+					bool hit = rays[i].intersects(rect, t_max);
+					tst::check_eq(get_bit<T>(mask, i), hit, SL);
+					if(hit){
+						++expected_num_hits;
+					}
+				}
+				tst::check_eq(num_hits, expected_num_hits, SL);
+			}
+		}
+	}
+}
+
+// Reference test of segment against closed rectangle: the segment intersects the rectangle
+// if one of its end points is inside the rectangle or it intersects one of the rectangle's edges.
+template <typename T> bool segment_intersects_rectangle(const r4::segment2<T>& s, const r4::rectangle<T>& r){
+	auto inside = [&r](const r4::vector2<T>& p){
+		return p.x() >= r.p.x() && p.x() <= r.x2() && p.y() >= r.p.y() && p.y() <= r.y2();
+	};
+	return inside(s.p1) || inside(s.p2) ||
+			s.intersects(r4::segment2<T>{r.p, r.x2_y1()}) ||
+			s.intersects(r4::segment2<T>{r.x2_y1(), r.x2_y2()}) ||
+			s.intersects(r4::segment2<T>{r.x2_y2(), r.x1_y2()}) ||
+			s.intersects(r4::segment2<T>{r.x1_y2(), r.p});
+}
+
+template <typename T> void check_segment_intersects_rectangle(){
+	auto rects = make_rectangles<T>(30);
+	for(size_t i = 0; i != 30; ++i){
+		r4::vector2<T> p(T(int(i * 3) % 13 - 6), T(int(i * 11) % 7 - 3));
+		r4::segment2<T> s{p, p + r4::vector2<T>(T(int(i % 5) - 2), T(int(i * 7) % 5 - 2)) * T(3)};
+		for(const auto& r : rects){
+			tst::check_eq(r4::intersects(s, r), segment_intersects_rectangle(s, r), SL);
+		}
+	}
+}
+}
+
+namespace{
+tst::set set("ray2", [](tst::suite& suite){
+    suite.add("point_at", []{
+        r4::ray2<float> r({1, 2}, {3, -1});
+
+		tst::check_eq(r.point_at(0), r4::vector2<float>(1, 2), SL);
+		tst::check_eq(r.point_at(2), r4::vector2<float>(7, 0), SL);
+    });
+
+    suite.add("constructor_segment", []{
+        r4::ray2<float> r(r4::segment2<float>{{1, 2}, {4, 1}});
+
+		tst::check_eq(r.origin, r4::vector2<float>(1, 2), SL);
+		tst::check_eq(r.direction, r4::vector2<float>(3, -1), SL);
+    });
+
+    suite.add("intersect_rectangle", []{
+        r4::rectangle<float> rect(2, 1, 2, 2);
+		constexpr auto none = std::numeric_limits<float>::infinity();
+
+		// hit from the left
+		tst::check_eq(r4::ray2<float>({0, 2}, {1, 0}).intersect(rect), 2.0f, SL);
+
+		// hit, but too far
+		tst::check_eq(r4::ray2<float>({0, 2}, {1, 0}).intersect(rect, 1.5f), none, SL);
+
+		// diagonal hit to the corner
+		tst::check_eq(r4::ray2<float>({0, -1}, {1, 1}).intersect(rect), 2.0f, SL);
+
+		// diagonal miss
+		tst::check_eq(r4::ray2<float>({0, -3.5f}, {1, 1}).intersect(rect), none, SL);
+
+		// pointing away
+		tst::check_eq(r4::ray2<float>({0, 2}, {-1, 0}).intersect(rect), none, SL);
+
+		// origin inside
+		tst::check_eq(r4::ray2<float>({3, 2}, {-1, 0}).intersect(rect), 0.0f, SL);
+
+		// axis-parallel rays along the edges
+		tst::check_eq(r4::ray2<float>({0, 1}, {1, 0}).intersect(rect), 2.0f, SL);
+		tst::check_eq(r4::ray2<float>({0, 3}, {1, 0}).intersect(rect), 2.0f, SL);
+		tst::check_eq(r4::ray2<float>({2, 5}, {0, -1}).intersect(rect), 2.0f, SL);
+		tst::check_eq(r4::ray2<float>({4, 5}, {0, -1}).intersect(rect), 2.0f, SL);
+
+		// axis-parallel ray missing the rectangle
+		tst::check_eq(r4::ray2<float>({0, 3.5f}, {1, 0}).intersect(rect), none, SL);
+
+		// zero direction
+		tst::check_eq(r4::ray2<float>({3, 2}, {0, 0}).intersect(rect), 0.0f, SL);
+		tst::check_eq(r4::ray2<float>({5, 2}, {0, 0}).intersect(rect), none, SL);
+
+		tst::check(r4::ray2<float>({0, 2}, {1, 0}).intersects(rect), SL);
+		tst::check(!r4::ray2<float>({0, 2}, {1, 0}).intersects(rect, 1.5f), SL);
+    });
+
+    suite.add("intersects_rectangles", []{
+        check_intersects_rectangles<float>();
+		check_intersects_rectangles<double>();
+    });
+
+    suite.add("rays_intersect_rectangle", []{
+        check_rays_intersect_rectangle<float>();
+		check_rays_intersect_rectangle<double>();
+    });
+
+    suite.add("segment_intersects_rectangle", []{
+        check_segment_intersects_rectangle<int>();
+		check_segment_intersects_rectangle<float>();
+		check_segment_intersects_rectangle<double>();
+
+		// segment crossing the rectangle without end points inside
+		tst::check(r4::intersects(r4::segment2<int>{{0, 2}, {5, 2}}, r4::rectangle<int>(2, 1, 2, 2)), SL);
+		tst::check(r4::intersects(r4::segment2<float>{{0, 2}, {5, 2}}, r4::rectangle<float>(2, 1, 2, 2)), SL);
+
+		// segment ending before the rectangle
+		tst::check(!r4::intersects(r4::segment2<int>{{0, 2}, {1, 2}}, r4::rectangle<int>(2, 1, 2, 2)), SL);
+		tst::check(!r4::intersects(r4::segment2<float>{{0, 2}, {1, 2}}, r4::rectangle<float>(2, 1, 2, 2)), SL);
+    });
+});
+}
@@ -62,6 +62,43 @@ tst::set set("rectangle", [](tst::suite& suite){
 		tst::check(!r.overlaps(p[8]), SL);
     });
 
+    suite.add("overlaps_rectangle", []{
+        r4::rectangle<int> r{ {3, 4}, {6, 8} };
+
+		tst::check(r.overlaps(r4::rectangle<int>{ {5, 6}, {1, 1} }), SL);
+		tst::check(r.overlaps(r4::rectangle<int>{ {0, 0}, {20, 20} }), SL);
+		tst::check(r.overlaps(r4::rectangle<int>{ {8, 11}, {5, 5} }), SL);
+		tst::check(r.overlaps(r4::rectangle<int>{ {0, 0}, {4, 5} }), SL);
+
+		// touching by edges
+		tst::check(!r.overlaps(r4::rectangle<int>{ {9, 4}, {2, 2} }), SL);
+		tst::check(!r.overlaps(r4::rectangle<int>{ {3, 0}, {2, 4} }), SL);
+
+		tst::check(!r.overlaps(r4::rectangle<int>{ {10, 13}, {2, 2} }), SL);
+
+		// zero size rectangle overlaps only if it lies strictly inside
+		tst::check(r.overlaps(r4::rectangle<int>{ {5, 6}, {0, 0} }), SL);
+		tst::check(!r.overlaps(r4::rectangle<int>{ {9, 6}, {0, 0} }), SL);
+
+		// unlike a point, zero size rectangle on the minimum corner or edges does not overlap
+		tst::check(r.overlaps(r4::vector2<int>{3, 4}), SL);
+		tst::check(!r.overlaps(r4::rectangle<int>{ {3, 4}, {0, 0} }), SL);
+		tst::check(!r.overlaps(r4::rectangle<int>{ {3, 6}, {0, 0} }), SL);
+    });
+
+    suite.add("contains_rectangle", []{
+        r4::rectangle<int> r{ {3, 4}, {6, 8} };
+
+		tst::check(r.contains(r4::rectangle<int>{ {5, 6}, {1, 1} }), SL);
+		tst::check(r.contains(r), SL);
+		tst::check(r.contains(r4::rectangle<int>{ {3, 4}, {6, 1} }), SL);
+		tst::check(r.contains(r4::rectangle<int>{ {9, 12}, {0, 0} }), SL);
+
+		tst::check(!r.contains(r4::rectangle<int>{ {0, 0}, {20, 20} }), SL);
+		tst::check(!r.contains(r4::rectangle<int>{ {8, 11}, {2, 1} }), SL);
+		tst::check(!r.contains(r4::rectangle<int>{ {10, 13}, {2, 2} }), SL);
+    });
+
     suite.add("intersect_rectangle", []{
         r4::rectangle<int> r{ {3, 4}, {6, 8} };
 		r4::rectangle<int> r1{ {5, 6}, {6, 8} };
@@ -145,5 +182,21 @@ tst::set set("rectangle", [](tst::suite& suite){
 
 		tst::check_eq(r, r2, SL);
     });
+
+    suite.add("from_points", []{
+        std::vector<r4::vector2<float>> points = {
+			{3, 4},
+			{-1, 7},
+			{2, -5},
+			{8, 0},
+			{0, 1}
+		};
+
+		auto r = r4::rectangle<float>::from_points(utki::make_span(points));
+
+		tst::check_eq(r, r4::rectangle<float>{-1, -5, 9, 12}, SL);
+
+		tst::check_eq(r4::rectangle<int>::from_points(utki::span<const r4::vector2<int>>()), r4::rectangle<int>{0, 0, 0, 0}, SL);
+    });
 });
 }
@@ -0,0 +1,243 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/rectangle_packer.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::skyline_packer<int>;
+template class r4::max_rects_packer<int>;
+
+namespace{
+std::vector<r4::vector2<int>> make_dims(size_t n){
+	std::vector<r4::vector2<int>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.emplace_back(int(i * 7) % 13 + 1, int(i * 5) % 11 + 1);
+	}
+	return ret;
+}
+
+void check_placements(const std::vector<r4::rectangle<int>>& rects, const r4::vector2<int>& bin_dims){
+	r4::rectangle<int> bin(r4::vector2<int>(0), bin_dims);
+	for(size_t i = 0; i != rects.size(); ++i){
+		tst::check(bin.contains(rects[i]), SL);
+		for(size_t j = 0; j != i; ++j){
+			tst::check(!rects[i].overlaps(rects[j]), SL);
+		}
+	}
+}
+
+template <class P> void check_insert_until_full(){
+	r4::vector2<int> bin_dims(64, 48);
+	P packer(bin_dims);
+
+	std::vector<r4::rectangle<int>> rects;
+	int area = 0;
+	for(const auto& d : make_dims(1000)){
+		auto r = packer.insert(d);
+		if(!r){
+			continue;
+		}
+		tst::check_eq(r.value().d, d, SL);
+		rects.push_back(r.value());
+		area += d.x() * d.y();
+	}
+
+	check_placements(rects, bin_dims);
+	tst::check_eq(packer.used_area(), area, SL);
+
+	// bin is filled by more than 3/4
+	tst::check_lt(bin_dims.x() * bin_dims.y() * 3, area * 4, SL);
+}
+
+template <class P> void check_pack(){
+	r4::vector2<int> bin_dims(128, 128);
+	P packer(bin_dims);
+
+	auto dims = make_dims(200);
+	std::vector<r4::rectangle<int>> out(dims.size());
+
+	auto n = r4::pack(packer, utki::make_span(std::as_const(dims)), utki::make_span(out));
+	tst::check_eq(n, dims.size(), SL);
+
+	for(size_t i = 0; i != dims.size(); ++i){
+		tst::check_eq(out[i].d, dims[i], SL);
+	}
+	check_placements(out, bin_dims);
+
+	// not all fit
+	std::vector<r4::vector2<int>> big = {{100, 100}, {20, 20}, {200, 10}, {25, 25}};
+	std::vector<r4::rectangle<int>> big_out(big.size());
+	packer.clear();
+	n = r4::pack(packer, utki::make_span(std::as_const(big)), utki::make_span(big_out));
+	tst::check_eq(n, size_t(3), SL);
+	tst::check_eq(big_out[0].d, big[0], SL);
+	tst::check_eq(big_out[1].d, big[1], SL);
+	tst::check_eq(big_out[2].d, r4::vector2<int>(-1), SL);
+	tst::check_eq(big_out[3].d, big[3], SL);
+}
+
+tst::set set("rectangle_packer", [](tst::suite& suite){
+    suite.add("skyline_insert", []{
+        r4::skyline_packer<int> packer({10, 10});
+
+		tst::check_eq(packer.insert({4, 3}).value(), r4::rectangle<int>(0, 0, 4, 3), SL);
+		tst::check_eq(packer.insert({6, 2}).value(), r4::rectangle<int>(4, 0, 6, 2), SL);
+
+		// lowest position wins
+		tst::check_eq(packer.insert({3, 3}).value(), r4::rectangle<int>(4, 2, 3, 3), SL);
+
+		// spans several skyline segments
+		tst::check_eq(packer.insert({8, 2}).value(), r4::rectangle<int>(0, 5, 8, 2), SL);
+
+		tst::check(!packer.insert({11, 1}).has_value(), SL);
+		tst::check(!packer.insert({1, 9}).has_value(), SL);
+
+		// zero size always fits
+		tst::check_eq(packer.insert({0, 5}).value(), r4::rectangle<int>(0, 0, 0, 5), SL);
+
+		tst::check_eq(packer.used_area(), 12 + 12 + 9 + 16, SL);
+
+		packer.clear();
+		tst::check_eq(packer.used_area(), 0, SL);
+		tst::check(packer.insert({10, 10}).has_value(), SL);
+    });
+
+    suite.add("skyline_free", []{
+        r4::skyline_packer<int> packer({10, 10});
+
+		auto a = packer.insert({4, 3}).value();
+		auto b = packer.insert({6, 2}).value();
+		auto c = packer.insert({2, 2}).value();
+
+		tst::check_eq(c, r4::rectangle<int>(4, 2, 2, 2), SL);
+
+		// b is below c, cannot be freed
+		tst::check(!packer.free(b), SL);
+
+		tst::check(packer.free(c), SL);
+
+		// the space of c is reused
+		tst::check_eq(packer.insert({3, 1}).value(), r4::rectangle<int>(4, 2, 3, 1), SL);
+
+		// a is not below of the new rectangle
+		tst::check(packer.free(a), SL);
+		tst::check_eq(packer.insert({4, 8}).value(), r4::rectangle<int>(0, 0, 4, 8), SL);
+    });
+
+    suite.add("skyline_insert_until_full", []{
+        check_insert_until_full<r4::skyline_packer<int>>();
+    });
+
+    suite.add("skyline_pack", []{
+        check_pack<r4::skyline_packer<int>>();
+    });
+
+    suite.add("max_rects_insert", []{
+        r4::max_rects_packer<int> packer({10, 10});
+
+		tst::check_eq(packer.insert({4, 3}).value(), r4::rectangle<int>(0, 0, 4, 3), SL);
+		tst::check_eq(packer.free_rectangles().size(), size_t(2), SL);
+
+		// best short side fit, exactly fits to the right of the first rectangle
+		tst::check_eq(packer.insert({6, 5}).value(), r4::rectangle<int>(4, 0, 6, 5), SL);
+
+		tst::check(!packer.insert({11, 1}).has_value(), SL);
+		tst::check(!packer.insert({5, 8}).has_value(), SL);
+
+		tst::check_eq(packer.insert({10, 5}).value(), r4::rectangle<int>(0, 5, 10, 5), SL);
+		tst::check_eq(packer.insert({4, 2}).value(), r4::rectangle<int>(0, 3, 4, 2), SL);
+
+		// bin is full
+		tst::check(packer.free_rectangles().empty(), SL);
+		tst::check(!packer.insert({1, 1}).has_value(), SL);
+		tst::check_eq(packer.used_area(), 100, SL);
+    });
+
+    suite.add("max_rects_free", []{
+        r4::max_rects_packer<int> packer({10, 10});
+
+		std::vector<r4::rectangle<int>> quarters;
+		for(unsigned i = 0; i != 4; ++i){
+			quarters.push_back(packer.insert({5, 5}).value());
+		}
+		tst::check(packer.free_rectangles().empty(), SL);
+
+		packer.free(quarters[1]);
+		tst::check_eq(packer.insert({5, 5}).value(), quarters[1], SL);
+		packer.free(quarters[1]);
+
+		// freed neighbour rectangles are merged
+		for(unsigned i : {0, 2, 3}){
+			packer.free(quarters[i]);
+		}
+		tst::check_eq(packer.free_rectangles().size(), size_t(1), SL);
+		tst::check_eq(packer.insert({10, 10}).value(), r4::rectangle<int>(0, 0, 10, 10), SL);
+    });
+
+    suite.add("max_rects_insert_until_full", []{
+        check_insert_until_full<r4::max_rects_packer<int>>();
+    });
+
+    suite.add("max_rects_free_rectangles_do_not_overlap_packed", []{
+        r4::vector2<int> bin_dims(40, 40);
+		r4::max_rects_packer<int> packer(bin_dims);
+
+		std::vector<r4::rectangle<int>> rects;
+		for(const auto& d : make_dims(100)){
+			auto r = packer.insert(d);
+			if(r){
+				rects.push_back(r.value());
+			}
+		}
+
+		auto free_rects = packer.free_rectangles();
+		for(size_t i = 0; i != free_rects.size(); ++i){
+			for(const auto& r : rects){
+				tst::check(!free_rects[i].overlaps(r), SL);
+			}
+			for(size_t j = 0; j != free_rects.size(); ++j){
+				tst::check(i == j || !free_rects[j].contains(free_rects[i]), SL);
+			}
+		}
+    });
+
+    suite.add("max_rects_free_all", []{
+        r4::vector2<int> bin_dims(32, 32);
+		r4::max_rects_packer<int> packer(bin_dims);
+
+		std::vector<r4::rectangle<int>> rects;
+		for(const auto& d : make_dims(20)){
+			auto r = packer.insert(d);
+			tst::check(r.has_value(), SL);
+			rects.push_back(r.value());
+		}
+
+		for(size_t i = 0; i != rects.size(); ++i){
+			// free in mixed order
+			packer.free(rects[(i * 7) % rects.size()]);
+		}
+		tst::check_eq(packer.used_area(), 0, SL);
+
+		// all space of the bin is covered by free rectangles
+		for(int y = 0; y != bin_dims.y(); ++y){
+			for(int x = 0; x != bin_dims.x(); ++x){
+				auto free_rects = packer.free_rectangles();
+				tst::check(
+						std::any_of(
+								free_rects.begin(),
+								free_rects.end(),
+								[&](const auto& f){
+									return f.overlaps(r4::vector2<int>(x, y));
+								}
+							),
+						SL
+					);
+			}
+		}
+    });
+
+    suite.add("max_rects_pack", []{
+        check_pack<r4::max_rects_packer<int>>();
+    });
+});
+}
@@ -0,0 +1,234 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <algorithm>
+
+#include "../../../src/r4/region.hpp"
+
+#include "../../common/lcg.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::region<int>;
+template class r4::region<float>;
+
+namespace{
+using r4_tests::lcg;
+
+void check_disjoint(const r4::region<int>& reg){
+	auto rects = reg.rectangles();
+	for(size_t i = 0; i != rects.size(); ++i){
+		tst::check_lt(0, rects[i].d.x(), SL);
+		tst::check_lt(0, rects[i].d.y(), SL);
+		tst::check(reg.bounding_rectangle().contains(rects[i]), SL);
+		for(size_t j = 0; j != i; ++j){
+			tst::check(!rects[i].overlaps(rects[j]), SL);
+		}
+	}
+}
+
+tst::set set("region", [](tst::suite& suite){
+    suite.add("add_disjoint", []{
+        r4::region<int> reg;
+		tst::check(reg.empty(), SL);
+		tst::check_eq(reg.bounding_rectangle(), r4::rectangle<int>(0, 0, 0, 0), SL);
+
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+		reg.add(r4::rectangle<int>(90, 90, 10, 10));
+
+		tst::check_eq(reg.size(), size_t(2), SL);
+		tst::check_eq(reg.area(), 200, SL);
+		tst::check_eq(reg.bounding_rectangle(), r4::rectangle<int>(0, 0, 100, 100), SL);
+
+		// empty rectangles are ignored
+		reg.add(r4::rectangle<int>(50, 50, 0, 10));
+		reg.add(r4::rectangle<int>(50, 50, 10, -1));
+		tst::check_eq(reg.size(), size_t(2), SL);
+
+		reg.clear();
+		tst::check(reg.empty(), SL);
+    });
+
+    suite.add("add_overlapping", []{
+        r4::region<int> reg;
+
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+
+		// contained
+		reg.add(r4::rectangle<int>(2, 2, 3, 3));
+		tst::check_eq(reg.size(), size_t(1), SL);
+		tst::check_eq(reg.area(), 100, SL);
+
+		// only the part outside of the region is added
+		reg.add(r4::rectangle<int>(5, 5, 10, 10));
+		tst::check_eq(reg.area(), 175, SL);
+		check_disjoint(reg);
+
+		// same column, merged without adding area
+		r4::region<int> col;
+		col.add(r4::rectangle<int>(0, 0, 10, 10));
+		col.add(r4::rectangle<int>(0, 5, 10, 10));
+		tst::check_eq(col.size(), size_t(1), SL);
+		tst::check_eq(col.rectangles()[0], r4::rectangle<int>(0, 0, 10, 15), SL);
+    });
+
+    suite.add("add_merges_when_limit_exceeded", []{
+        r4::region<int> reg(2);
+		tst::check_eq(reg.max_size(), size_t(2), SL);
+
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+		reg.add(r4::rectangle<int>(100, 100, 10, 10));
+		reg.add(r4::rectangle<int>(12, 0, 10, 10));
+
+		// the two close rectangles are merged, the far one is kept separate
+		tst::check_eq(reg.size(), size_t(2), SL);
+		tst::check_eq(reg.area(), 100 + 220, SL);
+		tst::check(reg.overlaps(r4::vector2<int>(11, 5)), SL);
+		tst::check(!reg.overlaps(r4::vector2<int>(50, 50)), SL);
+		check_disjoint(reg);
+
+		// merged rectangle swallows the rectangles it overlaps
+		r4::region<int> one(1);
+		one.add(r4::rectangle<int>(0, 0, 10, 10));
+		one.add(r4::rectangle<int>(20, 20, 10, 10));
+		tst::check_eq(one.size(), size_t(1), SL);
+		tst::check_eq(one.rectangles()[0], r4::rectangle<int>(0, 0, 30, 30), SL);
+    });
+
+    suite.add("subtract", []{
+        r4::region<int> reg;
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+		reg.add(r4::rectangle<int>(20, 0, 10, 10));
+
+		// hole in the middle of the first rectangle
+		reg.subtract(r4::rectangle<int>(3, 3, 4, 4));
+		tst::check_eq(reg.area(), 200 - 16, SL);
+		tst::check(!reg.overlaps(r4::vector2<int>(5, 5)), SL);
+		tst::check(reg.overlaps(r4::vector2<int>(2, 5)), SL);
+		check_disjoint(reg);
+
+		// whole second rectangle
+		reg.subtract(r4::rectangle<int>(15, -5, 20, 20));
+		tst::check_eq(reg.area(), 100 - 16, SL);
+		tst::check_eq(reg.bounding_rectangle(), r4::rectangle<int>(0, 0, 10, 10), SL);
+
+		reg.subtract(r4::rectangle<int>(-1, -1, 12, 12));
+		tst::check(reg.empty(), SL);
+    });
+
+    suite.add("add_after_subtract_brings_size_within_limit", []{
+        // subtraction makes more rectangles than the limit, any following add() merges them,
+		// also in case nothing is added
+		for(auto added : {r4::rectangle<int>(1, 1, 1, 1), r4::rectangle<int>(50, 50, 0, 0), r4::rectangle<int>(50, 50, 5, 5)}){
+			r4::region<int> reg(1);
+			reg.add(r4::rectangle<int>(0, 0, 10, 10));
+
+			reg.subtract(r4::rectangle<int>(3, 3, 4, 4));
+			tst::check_lt(size_t(1), reg.size(), SL);
+
+			reg.add(added);
+			tst::check_eq(reg.size(), size_t(1), SL);
+			tst::check(reg.overlaps(r4::vector2<int>(1, 1)), SL);
+		}
+    });
+
+    suite.add("intersect", []{
+        r4::region<int> reg;
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+		reg.add(r4::rectangle<int>(20, 0, 10, 10));
+		reg.add(r4::rectangle<int>(40, 0, 10, 10));
+
+		reg.intersect(r4::rectangle<int>(5, 5, 20, 20));
+		tst::check_eq(reg.size(), size_t(2), SL);
+		tst::check_eq(reg.area(), 25 + 25, SL);
+		tst::check_eq(reg.bounding_rectangle(), r4::rectangle<int>(5, 5, 20, 5), SL);
+
+		reg.intersect(r4::rectangle<int>(7, 7, 0, 0));
+		tst::check(reg.empty(), SL);
+    });
+
+    suite.add("overlaps", []{
+        r4::region<int> reg;
+		tst::check(!reg.overlaps(r4::rectangle<int>(0, 0, 10, 10)), SL);
+
+		reg.add(r4::rectangle<int>(0, 0, 10, 10));
+		reg.add(r4::rectangle<int>(90, 90, 10, 10));
+
+		tst::check(reg.overlaps(r4::rectangle<int>(5, 5, 10, 10)), SL);
+		tst::check(reg.overlaps(r4::rectangle<int>(80, 80, 20, 20)), SL);
+		tst::check(!reg.overlaps(r4::rectangle<int>(20, 20, 50, 50)), SL);
+
+		// touching is not overlapping
+		tst::check(!reg.overlaps(r4::rectangle<int>(10, 0, 10, 10)), SL);
+    });
+
+    suite.add("random_add_covers_added_rectangles", []{
+        lcg rnd(7);
+		for(size_t max_rects : {1, 3, 8, 32}){
+			r4::region<int> reg(max_rects);
+			std::vector<r4::rectangle<int>> added;
+			for(unsigned i = 0; i != 100; ++i){
+				r4::rectangle<int> r(rnd.next(60), rnd.next(60), rnd.next(10) + 1, rnd.next(10) + 1);
+				reg.add(r);
+				added.push_back(r);
+
+				tst::check_le(reg.size(), max_rects, SL);
+				check_disjoint(reg);
+			}
+
+			for(int y = 0; y != 70; ++y){
+				for(int x = 0; x != 70; ++x){
+					r4::vector2<int> p(x, y);
+					bool in_added = std::any_of(
+							added.begin(),
+							added.end(),
+							[&p](const auto& r){
+								return r.overlaps(p);
+							}
+						);
+					// region is never smaller than the union of the added rectangles
+					tst::check(!in_added || reg.overlaps(p), SL);
+				}
+			}
+		}
+    });
+
+    suite.add("random_add_and_subtract_is_exact", []{
+        // the limit is never reached, so only merges which add no area happen and the region is exact
+		auto make_rect = [](lcg& rnd){
+			return r4::rectangle<int>(rnd.next(60), rnd.next(60), rnd.next(10) + 1, rnd.next(10) + 1);
+		};
+		const unsigned num_ops = 50;
+		auto is_subtraction = [](unsigned i){
+			return i % 3 == 2;
+		};
+
+		r4::region<int> reg(1000);
+		lcg rnd(13);
+		for(unsigned i = 0; i != num_ops; ++i){
+			auto r = make_rect(rnd);
+			if(is_subtraction(i)){
+				reg.subtract(r);
+			}else{
+				reg.add(r);
+			}
+			check_disjoint(reg);
+		}
+
+		for(int y = 0; y != 70; ++y){
+			for(int x = 0; x != 70; ++x){
+				r4::vector2<int> p(x, y);
+
+				// the last operation touching the point decides if the point is in the region
+				bool expected = false;
+				lcg replay(13);
+				for(unsigned i = 0; i != num_ops; ++i){
+					if(make_rect(replay).overlaps(p)){
+						expected = !is_subtraction(i);
+					}
+				}
+				tst::check_eq(reg.overlaps(p), expected, SL);
+			}
+		}
+    });
+});
+}
@@ -5,9 +5,170 @@
 
 // declare templates to instantiate all template methods to include all methods to gcov coverage
 template class r4::segment2<int>;
+template class r4::segment2<float>;
+
+namespace{
+template <typename T> std::vector<r4::vector2<T>> make_points(size_t n){
+	std::vector<r4::vector2<T>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.push_back(r4::vector2<T>(T(int(i * 7) % 23 - 11), T(int(i * 5) % 17 - 20)));
+	}
+	return ret;
+}
+
+template <typename T> r4::segment2<T> united(const std::vector<r4::vector2<T>>& points){
+	r4::segment2<T> ret;
+	ret.set_empty_bounding_box();
+	for(const auto& p : points){
+		ret.unite(r4::segment2<T>{p, p});
+	}
+	return ret;
+}
+
+template <typename T> void check_intersects_segment(){
+	typedef r4::segment2<T> segment;
+
+	auto check = [](const segment& a, const segment& b, bool expected){
+		// result must not depend on order of the segments and on direction of the segments
+		segment ra{a.p2, a.p1};
+		segment rb{b.p2, b.p1};
+		tst::check_eq(a.intersects(b), expected, SL);
+		tst::check_eq(b.intersects(a), expected, SL);
+		tst::check_eq(ra.intersects(rb), expected, SL);
+		tst::check_eq(rb.intersects(a), expected, SL);
+	};
+
+	// crossing
+	check(segment{{0, 0}, {4, 4}}, segment{{0, 4}, {4, 0}}, true);
+
+	// not crossing
+	check(segment{{0, 0}, {4, 4}}, segment{{0, 4}, {1, 3}}, false);
+
+	// end point on the other segment
+	check(segment{{0, 0}, {4, 4}}, segment{{2, 2}, {4, 0}}, true);
+
+	// touching end points
+	check(segment{{0, 0}, {4, 4}}, segment{{4, 4}, {5, 0}}, true);
+
+	// parallel
+	check(segment{{0, 0}, {4, 4}}, segment{{1, 0}, {5, 4}}, false);
+
+	// collinear overlapping
+	check(segment{{0, 0}, {4, 4}}, segment{{3, 3}, {6, 6}}, true);
+
+	// collinear disjoint
+	check(segment{{0, 0}, {4, 4}}, segment{{5, 5}, {6, 6}}, false);
+
+	// degenerate
+	check(segment{{2, 2}, {2, 2}}, segment{{0, 0}, {4, 4}}, true);
+	check(segment{{2, 3}, {2, 3}}, segment{{0, 0}, {4, 4}}, false);
+	check(segment{{2, 3}, {2, 3}}, segment{{2, 3}, {2, 3}}, true);
+}
+
+template <typename T> void check_from_points(){
+	// various sizes to cover SIMD loop and its tail
+	for(size_t n = 1; n != 20; ++n){
+		auto points = make_points<T>(n);
+		auto expected = united(points);
+
+		auto bb = r4::segment2<T>::from_points(utki::make_span(points));
+
+		tst::check_eq(bb.p1, expected.p1, SL);
+		tst::check_eq(bb.p2, expected.p2, SL);
+	}
+}
+}
 
 namespace{
 tst::set set("segment2", [](tst::suite& suite){
-	// TODO: add tests
+    suite.add("set_empty_bounding_box", []{
+        r4::segment2<float> s;
+
+		s.set_empty_bounding_box();
+
+		tst::check_eq(s.p1, r4::vector2<float>(std::numeric_limits<float>::max()), SL);
+		tst::check_eq(s.p2, r4::vector2<float>(std::numeric_limits<float>::lowest()), SL);
+    });
+
+    suite.add("unite_with_empty_bounding_box", []{
+        r4::segment2<float> s;
+		s.set_empty_bounding_box();
+
+		s.unite(r4::segment2<float>{{-3, -4}, {-1, -2}});
+
+		tst::check_eq(s.p1, r4::vector2<float>(-3, -4), SL);
+		tst::check_eq(s.p2, r4::vector2<float>(-1, -2), SL);
+    });
+
+    suite.add("from_points", []{
+        check_from_points<int>();
+		check_from_points<float>();
+		check_from_points<double>();
+
+		auto bb = r4::segment2<float>::from_points(utki::make_span(make_points<float>(100)));
+		tst::check_eq(bb.p1, r4::vector2<float>(-11, -20), SL);
+		tst::check_eq(bb.p2, r4::vector2<float>(11, -4), SL);
+    });
+
+    suite.add("from_points_empty_span", []{
+        auto bb = r4::segment2<double>::from_points(utki::span<const r4::vector2<double>>());
+
+		tst::check_eq(bb.p1, r4::vector2<double>(std::numeric_limits<double>::max()), SL);
+		tst::check_eq(bb.p2, r4::vector2<double>(std::numeric_limits<double>::lowest()), SL);
+    });
+
+    suite.add("intersects_segment", []{
+        check_intersects_segment<int>();
+		check_intersects_segment<float>();
+		check_intersects_segment<double>();
+    });
+
+    suite.add("intersects_segment_int_exact", []{
+        const int big = 1 << 30;
+
+		// nearly parallel long segments, the second one passes 1 unit away from the first one's end point
+		r4::segment2<int> a{{-big, -big}, {big, big - 1}};
+		r4::segment2<int> b{{big - 1, big}, {big, big + 0}};
+		tst::check(!a.intersects(b), SL);
+
+		// same, but touching the end point
+		r4::segment2<int> c{{big - 1, big}, {big, big - 1}};
+		tst::check(a.intersects(c), SL);
+		tst::check(c.intersects(a), SL);
+
+		// collinear points far apart
+		r4::segment2<int> d{{-big, -big}, {-big + 2, -big + 2}};
+		r4::segment2<int> e{{-big + 1, -big + 1}, {big, big}};
+		tst::check(d.intersects(e), SL);
+    });
+
+    suite.add("intersect_segment", []{
+        r4::segment2<float> a{{0, 0}, {4, 0}};
+
+		// crossing
+		tst::check_eq(a.intersect(r4::segment2<float>{{1, -1}, {1, 1}}), 0.25f, SL);
+
+		// touching by end point
+		tst::check_eq(a.intersect(r4::segment2<float>{{4, 0}, {5, 1}}), 1.0f, SL);
+
+		// not crossing
+		tst::check_eq(a.intersect(r4::segment2<float>{{5, -1}, {5, 1}}), std::numeric_limits<float>::infinity(), SL);
+
+		// parallel
+		tst::check_eq(a.intersect(r4::segment2<float>{{0, 1}, {4, 1}}), std::numeric_limits<float>::infinity(), SL);
+
+		// collinear overlapping, the first common point is returned
+		tst::check_eq(a.intersect(r4::segment2<float>{{3, 0}, {2, 0}}), 0.5f, SL);
+		tst::check_eq(a.intersect(r4::segment2<float>{{-1, 0}, {1, 0}}), 0.0f, SL);
+
+		// collinear not overlapping
+		tst::check_eq(a.intersect(r4::segment2<float>{{5, 0}, {6, 0}}), std::numeric_limits<float>::infinity(), SL);
+
+		// degenerate segments
+		r4::segment2<float> p{{2, 0}, {2, 0}};
+		tst::check_eq(p.intersect(a), 0.0f, SL);
+		tst::check_eq(a.intersect(p), 0.5f, SL);
+		tst::check_eq(p.intersect(r4::segment2<float>{{2, 1}, {2, 1}}), std::numeric_limits<float>::infinity(), SL);
+    });
 });
 }
@@ -0,0 +1,200 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/soa_vector.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::soa_vector<int, 3>;
+template class r4::soa_vector<float, 3>;
+template class r4::soa_vector<double, 4>;
+
+namespace{
+std::vector<r4::vector3<float>> make_vectors(size_t n){
+	std::vector<r4::vector3<float>> ret;
+	for(size_t i = 0; i != n; ++i){
+		ret.push_back(r4::vector3<float>(float(i), float(i % 5) - 2, float(i % 3) * 0.5f));
+	}
+	return ret;
+}
+}
+
+namespace{
+tst::set set("soa_vector", [](tst::suite& suite){
+    suite.add("constructor_size", []{
+        r4::soa_vector<int, 3> v(5);
+
+		tst::check_eq(v.size(), size_t(5), SL);
+		tst::check(v.capacity() >= v.size(), SL);
+		for(size_t i = 0; i != v.size(); ++i){
+			tst::check(r4::vector3<int>(v[i]).is_zero(), SL);
+		}
+    });
+
+    suite.add("component_arrays_are_aligned", []{
+        r4::soa_vector<float, 3> v(7);
+
+		for(size_t c = 0; c != 3; ++c){
+			tst::check_eq(reinterpret_cast<uintptr_t>(v.data(c)) % v.alignment, uintptr_t(0), SL);
+		}
+    });
+
+    suite.add("push_back_and_access", []{
+        auto vecs = make_vectors(37);
+
+		r4::soa_vector<float, 3> v;
+		for(const auto& e : vecs){
+			v.push_back(e);
+		}
+
+		tst::check_eq(v.size(), vecs.size(), SL);
+		for(size_t i = 0; i != vecs.size(); ++i){
+			tst::check_eq(v[i], vecs[i], SL);
+			tst::check_eq(v.component(1)[i], vecs[i].y(), SL);
+		}
+    });
+
+    suite.add("reference_proxy", []{
+        r4::soa_vector<int, 3> v(3);
+
+		v[0] = r4::vector3<int>{1, 2, 3};
+		v[1].x() = 4;
+		v[1].y() = 5;
+		v[1].z() = 6;
+		v[2] = v[0];
+		v[2] += r4::vector3<int>{1, 1, 1};
+		v[2] *= 2;
+
+		tst::check_eq(v[0], r4::vector3<int>{1, 2, 3}, SL);
+		tst::check_eq(v[1], r4::vector3<int>{4, 5, 6}, SL);
+		tst::check_eq(v[2], r4::vector3<int>{4, 6, 8}, SL);
+		tst::check_eq(v[1].norm_pow2(), 77, SL);
+
+		const auto& cv = v;
+		r4::vector3<int> e = cv[1];
+		tst::check_eq(e, r4::vector3<int>{4, 5, 6}, SL);
+    });
+
+    suite.add("copy_and_resize", []{
+        r4::soa_vector<float, 3> v(utki::make_span(make_vectors(20)));
+
+		auto c = v;
+		c.resize(40);
+		tst::check_eq(c.size(), size_t(40), SL);
+		for(size_t i = 0; i != v.size(); ++i){
+			tst::check_eq(c[i], v[i], SL);
+		}
+		for(size_t i = v.size(); i != c.size(); ++i){
+			tst::check(r4::vector3<float>(c[i]).is_zero(), SL);
+		}
+
+		auto m = std::move(c);
+		tst::check_eq(m.size(), size_t(40), SL);
+		tst::check(c.empty(), SL);
+    });
+
+    suite.add("bulk_add_sub_scale", []{
+        auto vecs = make_vectors(21);
+		r4::soa_vector<float, 3> a(utki::make_span(vecs));
+		r4::soa_vector<float, 3> b(utki::make_span(vecs));
+
+		a += b;
+		a *= 3.0f;
+		a -= b;
+		a += r4::vector3<float>{1, 2, 3};
+		a.comp_multiply(r4::vector3<float>{2, 1, 0.5f});
+
+		for(size_t i = 0; i != vecs.size(); ++i){
+			auto cmp = ((vecs[i] + vecs[i]) * 3.0f - vecs[i] + r4::vector3<float>{1, 2, 3}).comp_mul(r4::vector3<float>{2, 1, 0.5f});
+			tst::check_eq(a[i], cmp, SL);
+		}
+    });
+
+    suite.add("grown_elements_are_zero_after_add_vector", []{
+        r4::soa_vector<float, 3> v(3);
+		v += r4::vector3<float>{1, 2, 3};
+		v.resize(5);
+
+		tst::check_eq(v[2], r4::vector3<float>{1, 2, 3}, SL);
+		tst::check_eq(v[3], r4::vector3<float>{0, 0, 0}, SL);
+		tst::check_eq(v[4], r4::vector3<float>{0, 0, 0}, SL);
+    });
+
+    suite.add("dot_and_cross", []{
+        auto va = make_vectors(13);
+		auto vb = make_vectors(13);
+		std::reverse(vb.begin(), vb.end());
+
+		r4::soa_vector<float, 3> a(utki::make_span(va));
+		r4::soa_vector<float, 3> b(utki::make_span(vb));
+
+		std::vector<float> d(va.size());
+		dot(a, b, utki::make_span(d));
+
+		auto c = cross(a, b);
+
+		tst::check_eq(c.size(), va.size(), SL);
+		for(size_t i = 0; i != va.size(); ++i){
+			tst::check_eq(d[i], va[i] * vb[i], SL);
+			tst::check_eq(c[i], va[i] % vb[i], SL);
+		}
+    });
+
+    suite.add("normalize", []{
+        auto vecs = make_vectors(11);
+		vecs[5] = r4::vector3<float>{0, 0, 0};
+
+		r4::soa_vector<float, 3> v(utki::make_span(vecs));
+		v.normalize();
+
+		for(size_t i = 0; i != vecs.size(); ++i){
+			tst::check_eq(round(r4::vector3<float>(v[i]) * 1e5f), round(vecs[i].normed() * 1e5f), SL);
+		}
+		tst::check_eq(v[5], r4::vector3<float>{1, 0, 0}, SL);
+    });
+
+    suite.add("min_max", []{
+        auto vecs = make_vectors(23);
+
+		r4::soa_vector<float, 3> v(utki::make_span(vecs));
+
+		auto min_cmp = vecs.front();
+		auto max_cmp = vecs.front();
+		for(const auto& e : vecs){
+			min_cmp = min(min_cmp, e);
+			max_cmp = max(max_cmp, e);
+		}
+
+		tst::check_eq(v.min(), min_cmp, SL);
+		tst::check_eq(v.max(), max_cmp, SL);
+    });
+
+    suite.add("transform_matrix4", []{
+        auto vecs = make_vectors(19);
+
+		r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(1, 2, 3);
+		m.scale(2, 3, 4);
+
+		r4::soa_vector<float, 3> v(utki::make_span(vecs));
+		v.transform(m);
+
+		for(size_t i = 0; i != vecs.size(); ++i){
+			tst::check_eq(v[i], r4::vector3<float>(m * r4::vector4<float>(vecs[i])), SL);
+		}
+
+		r4::soa_vector<double, 4> v4(2);
+		v4[0] = r4::vector4<double>{1, 2, 3, 0};
+		v4[1] = r4::vector4<double>{1, 2, 3, 1};
+
+		r4::matrix4<double> m4;
+		m4.set_identity();
+		m4.translate(1, 2, 3);
+
+		v4.transform(m4);
+
+		tst::check_eq(v4[0], r4::vector4<double>{1, 2, 3, 0}, SL);
+		tst::check_eq(v4[1], r4::vector4<double>{2, 4, 6, 1}, SL);
+    });
+});
+}
@@ -0,0 +1,224 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/transform_hierarchy.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::transform_hierarchy<float>;
+template class r4::transform_hierarchy<double>;
+
+namespace{
+const auto npos = r4::transform_hierarchy<float>::npos;
+
+// parents are given in arbitrary order, i.e. children can have smaller ids than their parents
+std::vector<size_t> make_parents(size_t num_nodes){
+	std::vector<size_t> ret(num_nodes);
+	for(size_t i = 0; i != num_nodes; ++i){
+		// node ids are reversed, so that parents have bigger ids than children
+		size_t index = num_nodes - 1 - i;
+		// pseudo-random parent among preceding nodes
+		ret[i] = index < 3 ? npos : num_nodes - 1 - ((index * 2654435761u) >> 8) % index;
+	}
+	return ret;
+}
+
+r4::matrix4<float> make_local(size_t id){
+	r4::matrix4<float> m;
+	m.set_identity();
+	m.translate(float(id % 5), float(id % 3) - 1, 0.5f);
+	m.rotate(r4::quaternion<float>(r4::vector3<float>(0.1f * float(id % 7), 0.2f, 0)));
+	m.scale(1.0f + 0.01f * float(id % 3));
+	return m;
+}
+
+// calculates world transformation by walking up to the root
+r4::matrix4<float> world_of(const std::vector<size_t>& parents, const std::vector<r4::matrix4<float>>& locals, size_t id){
+	r4::matrix4<float> ret = locals[id];
+	for(size_t p = parents[id]; p != npos; p = parents[p]){
+		ret = locals[p] * ret;
+	}
+	return ret;
+}
+
+bool is_near(const r4::matrix4<float>& a, const r4::matrix4<float>& b){
+	for(size_t r = 0; r != 4; ++r){
+		for(size_t c = 0; c != 4; ++c){
+			if(std::abs(a[r][c] - b[r][c]) > 1e-4f){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool is_same(const r4::matrix4<float>& a, const r4::matrix4<float>& b){
+	for(size_t r = 0; r != 4; ++r){
+		if(a[r] != b[r]){
+			return false;
+		}
+	}
+	return true;
+}
+
+tst::set set("transform_hierarchy", [](tst::suite& suite){
+    suite.add("empty", []{
+        r4::transform_hierarchy<float> h(utki::span<const size_t>{});
+		tst::check_eq(h.size(), size_t(0), SL);
+		tst::check_eq(h.num_levels(), size_t(0), SL);
+		h.update();
+    });
+
+    suite.add("structure", []{
+        // 3 <- 1 <- 0, 3 <- 2, 4 is a separate root
+        std::vector<size_t> parents = {1, 3, 3, npos, npos};
+		r4::transform_hierarchy<float> h(utki::make_span(parents));
+
+		tst::check_eq(h.size(), size_t(5), SL);
+		tst::check_eq(h.num_levels(), size_t(3), SL);
+		for(size_t i = 0; i != parents.size(); ++i){
+			tst::check_eq(h.parent(i), parents[i], SL);
+		}
+    });
+
+    suite.add("initial_transforms_are_identity", []{
+        auto parents = make_parents(10);
+		r4::transform_hierarchy<float> h(utki::make_span(parents));
+		h.update();
+
+		r4::matrix4<float> identity;
+		identity.set_identity();
+		for(size_t i = 0; i != h.size(); ++i){
+			tst::check(is_same(h.local(i), identity), SL);
+			tst::check(is_same(h.world(i), identity), SL);
+		}
+    });
+
+    suite.add("update_calculates_world_transforms", []{
+        auto parents = make_parents(1000);
+		std::vector<r4::matrix4<float>> locals;
+		r4::transform_hierarchy<float> h(utki::make_span(parents));
+		for(size_t i = 0; i != parents.size(); ++i){
+			locals.push_back(make_local(i));
+			h.set_local(i, locals.back());
+		}
+		tst::check(h.num_levels() > 3, SL);
+
+		h.update();
+
+		for(size_t i = 0; i != parents.size(); ++i){
+			tst::check(is_near(h.world(i), world_of(parents, locals, i)), SL);
+		}
+    });
+
+    suite.add("update_recalculates_dirty_subtrees_only", []{
+        auto parents = make_parents(1000);
+		std::vector<r4::matrix4<float>> locals;
+		r4::transform_hierarchy<float> h(utki::make_span(parents));
+		for(size_t i = 0; i != parents.size(); ++i){
+			locals.push_back(make_local(i));
+			h.set_local(i, locals.back());
+		}
+		h.update();
+
+		// change a non-root node
+		size_t changed = 0;
+		while(parents[changed] == npos){
+			++changed;
+		}
+
+		std::vector<r4::matrix4<float>> before;
+		for(size_t i = 0; i != parents.size(); ++i){
+			before.push_back(h.world(i));
+		}
+
+		locals[changed] = make_local(changed + 1);
+		h.set_local(changed, locals[changed]);
+		h.update();
+
+		size_t num_changed = 0;
+		for(size_t i = 0; i != parents.size(); ++i){
+			bool in_subtree = false;
+			for(size_t p = i; p != npos; p = parents[p]){
+				if(p == changed){
+					in_subtree = true;
+					break;
+				}
+			}
+			if(in_subtree){
+				tst::check(is_near(h.world(i), world_of(parents, locals, i)), SL);
+				++num_changed;
+			}else{
+				tst::check(is_same(h.world(i), before[i]), SL);
+			}
+		}
+		tst::check(num_changed >= 1, SL);
+		tst::check(num_changed < parents.size(), SL);
+
+		// no changes, nothing to update
+		h.update();
+		for(size_t i = 0; i != parents.size(); ++i){
+			tst::check(is_near(h.world(i), world_of(parents, locals, i)), SL);
+		}
+    });
+
+    suite.add("set_local_translation_rotation_scale", []{
+        std::vector<size_t> parents = {npos};
+		r4::transform_hierarchy<float> h(utki::make_span(parents));
+
+		r4::vector3<float> t(1, 2, 3);
+		r4::quaternion<float> q(r4::vector3<float>(0.1f, 0.2f, 0.3f));
+		r4::vector3<float> s(2, 3, 4);
+
+		h.set_local(0, t, q, s);
+
+		r4::matrix4<float> expected;
+		expected.set_identity();
+		expected.translate(t);
+		expected.rotate(q);
+		expected.scale(s);
+
+		tst::check(is_near(h.local(0), expected), SL);
+
+		h.set_local(0, t, q);
+		expected.set_identity();
+		expected.translate(t);
+		expected.rotate(q);
+
+		tst::check(is_near(h.local(0), expected), SL);
+    });
+
+    suite.add("update_does_not_depend_on_number_of_threads", []{
+        // wide levels, so that those are processed in parallel
+        std::vector<size_t> parents;
+		for(size_t i = 0; i != 100; ++i){
+			parents.push_back(npos);
+		}
+		for(size_t i = 100; i != 30000; ++i){
+			parents.push_back(i < 10000 ? i % 100 : 100 + i % 9900);
+		}
+
+		r4::transform_hierarchy<float> single(utki::make_span(parents));
+		r4::transform_hierarchy<float> multi(utki::make_span(parents));
+		for(size_t i = 0; i != parents.size(); ++i){
+			single.set_local(i, make_local(i));
+			multi.set_local(i, make_local(i));
+		}
+
+		single.update(1);
+		multi.update(4);
+
+		for(size_t i = 0; i != parents.size(); ++i){
+			tst::check(is_same(single.world(i), multi.world(i)), SL);
+		}
+
+		single.set_local(150, make_local(0));
+		multi.set_local(150, make_local(0));
+		single.update(1);
+		multi.update(4);
+
+		for(size_t i = 0; i != parents.size(); ++i){
+			tst::check(is_same(single.world(i), multi.world(i)), SL);
+		}
+    });
+});
+}
@@ -0,0 +1,212 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include "../../../src/r4/trs.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::trs<float>;
+template class r4::trs<double>;
+template class r4::trs<float, r4::vector3<float>>;
+
+namespace{
+bool is_near(const r4::vector3<float>& a, const r4::vector3<float>& b, float eps = 1e-5f){
+	for(size_t i = 0; i != 3; ++i){
+		if(std::abs(a[i] - b[i]) > eps){
+			return false;
+		}
+	}
+	return true;
+}
+
+bool is_near(const r4::matrix4<float>& a, const r4::matrix4<float>& b, float eps = 1e-5f){
+	for(size_t r = 0; r != 4; ++r){
+		for(size_t c = 0; c != 4; ++c){
+			if(std::abs(a[r][c] - b[r][c]) > eps){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// transforms point by matrix
+r4::vector3<float> transform_point(const r4::matrix4<float>& m, const r4::vector3<float>& p){
+	return r4::vector3<float>(m * r4::vector4<float>(p, 1));
+}
+
+r4::trs<float> make_trs(size_t i){
+	return {
+		r4::vector3<float>(float(i % 5), float(i % 3) - 1, 0.5f * float(i)),
+		r4::quaternion<float>(r4::vector3<float>(0.3f * float(i % 7), 0.2f, -0.1f * float(i))),
+		0.5f + 0.25f * float(i % 4)
+	};
+}
+
+const std::vector<r4::vector3<float>> points = {
+	{0, 0, 0},
+	{1, 2, 3},
+	{-4, 0.5f, 2},
+	{10, -10, 0.1f}
+};
+
+tst::set set("trs", [](tst::suite& suite){
+    suite.add("size", []{
+        tst::check_eq(sizeof(r4::trs<float>), size_t(32), SL);
+		tst::check_eq(sizeof(r4::trs<float, r4::vector3<float>>), size_t(40), SL);
+    });
+
+    suite.add("set_identity", []{
+        auto t = make_trs(3);
+		t.set_identity();
+
+		for(const auto& p : points){
+			tst::check(is_near(t * p, p), SL);
+		}
+		r4::matrix4<float> i;
+		i.set_identity();
+		tst::check(is_near(t.to_matrix(), i), SL);
+    });
+
+    suite.add("transform_point_and_vector_match_matrix", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto t = make_trs(i);
+			auto m = t.to_matrix();
+			for(const auto& p : points){
+				tst::check(is_near(t * p, transform_point(m, p), 1e-4f), SL);
+				tst::check(is_near(t.transform_vector(p), r4::vector3<float>(m * r4::vector4<float>(p, 0)), 1e-4f), SL);
+			}
+		}
+    });
+
+    suite.add("transform_non_uniform_scale_matches_matrix", []{
+        r4::trs<float, r4::vector3<float>> t(
+				r4::vector3<float>(1, 2, 3),
+				r4::quaternion<float>(r4::vector3<float>(0.5f, -0.3f, 0.2f)),
+				r4::vector3<float>(2, 0.5f, 3)
+			);
+
+		r4::matrix4<float> m;
+		m.set_identity();
+		m.translate(t.translation);
+		m.rotate(t.rotation);
+		m.scale(t.scale);
+
+		tst::check(is_near(t.to_matrix(), m), SL);
+		for(const auto& p : points){
+			tst::check(is_near(t * p, transform_point(m, p), 1e-4f), SL);
+		}
+    });
+
+    suite.add("compose_matches_matrix_product", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto a = make_trs(i);
+			auto b = make_trs(i + 3);
+
+			auto c = a * b;
+			tst::check(is_near(c.to_matrix(), a.to_matrix() * b.to_matrix(), 1e-4f), SL);
+
+			a *= b;
+			tst::check(is_near(a.to_matrix(), c.to_matrix()), SL);
+		}
+    });
+
+    suite.add("inv", []{
+        for(size_t i = 0; i != 10; ++i){
+			auto t = make_trs(i);
+			auto inv = t.inv();
+
+			tst::check(is_near(inv.to_matrix(), t.to_matrix().inv(), 1e-4f), SL);
+			for(const auto& p : points){
+				tst::check(is_near(inv * (t * p), p, 1e-4f), SL);
+			}
+
+			t.invert();
+			tst::check(is_near(t.to_matrix(), inv.to_matrix()), SL);
+		}
+    });
+
+    suite.add("constructor_matrix4", []{
+        // rotations by angles close to 0 and close to 180 degrees about different axes
+        // to exercise all branches of the quaternion extraction
+		const std::vector<r4::vector3<float>> rotations = {
+			{0.3f, 0.2f, -0.1f},
+			{3.1f, 0, 0},
+			{0, 3.1f, 0},
+			{0, 0, 3.1f},
+			{2, -2, 1}
+		};
+
+		for(const auto& rot : rotations){
+			r4::trs<float> t(r4::vector3<float>(1, -2, 3), r4::quaternion<float>(rot), 1.5f);
+			r4::trs<float> d(t.to_matrix());
+
+			tst::check(is_near(d.translation, t.translation), SL);
+			tst::check(std::abs(d.scale - t.scale) < 1e-5f, SL);
+			// q and -q represent the same rotation
+			tst::check(std::abs(std::abs(d.rotation * t.rotation) - 1) < 1e-5f, SL);
+			tst::check(is_near(d.to_matrix(), t.to_matrix()), SL);
+		}
+
+		r4::trs<float, r4::vector3<float>> n(
+				r4::vector3<float>(1, 2, 3),
+				r4::quaternion<float>(r4::vector3<float>(0.5f, -0.3f, 0.2f)),
+				r4::vector3<float>(2, 0.5f, 3)
+			);
+		r4::trs<float, r4::vector3<float>> dn(n.to_matrix());
+		tst::check(is_near(dn.scale, n.scale), SL);
+		tst::check(is_near(dn.to_matrix(), n.to_matrix(), 1e-4f), SL);
+    });
+
+    suite.add("constexpr", []{
+        constexpr r4::trs<double> t(r4::vector3<double>(1, 2, 3), r4::quaternion<double>(0, 0, 0, 1), 2);
+		constexpr auto i = t.inv();
+		constexpr auto p = (t * i) * r4::vector3<double>(4, 5, 6);
+
+		static_assert(p[0] == 4 && p[1] == 5 && p[2] == 6);
+		tst::check(true, SL);
+    });
+
+    suite.add("batch_transform", []{
+        auto t = make_trs(4);
+
+		std::vector<r4::vector3<float>> out(points.size());
+		r4::transform(t, utki::make_span(points), utki::make_span(out));
+
+		for(size_t i = 0; i != points.size(); ++i){
+			tst::check(is_near(out[i], t * points[i], 1e-4f), SL);
+		}
+
+		// in-place, spans of non-const vector
+		auto in_place = points;
+		r4::transform(t, utki::make_span(in_place), utki::make_span(in_place));
+		tst::check(in_place == out, SL);
+    });
+
+    suite.add("batch_to_matrix_compose_invert", []{
+        std::vector<r4::trs<float>> a;
+		std::vector<r4::trs<float>> b;
+		for(size_t i = 0; i != 7; ++i){
+			a.push_back(make_trs(i));
+			b.push_back(make_trs(i + 5));
+		}
+
+		std::vector<r4::matrix4<float>> m(a.size());
+		r4::to_matrix(utki::make_span(a), utki::make_span(m));
+		for(size_t i = 0; i != a.size(); ++i){
+			tst::check(is_near(m[i], a[i].to_matrix()), SL);
+		}
+
+		std::vector<r4::trs<float>> c(a.size());
+		r4::compose(utki::make_span(a), utki::make_span(b), utki::make_span(c));
+		for(size_t i = 0; i != a.size(); ++i){
+			tst::check(is_near(c[i].to_matrix(), (a[i] * b[i]).to_matrix()), SL);
+		}
+
+		auto inv = a;
+		r4::invert(utki::make_span(inv));
+		for(size_t i = 0; i != a.size(); ++i){
+			tst::check(is_near(inv[i].to_matrix(), a[i].inv().to_matrix()), SL);
+		}
+    });
+});
+}
@@ -0,0 +1,217 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <algorithm>
+
+#include "../../../src/r4/uniform_grid.hpp"
+
+#include "../../common/lcg.hpp"
+
+// declare templates to instantiate all template methods to include all methods to gcov coverage
+template class r4::uniform_grid<int, 2>;
+template class r4::uniform_grid<float, 3>;
+
+namespace{
+using r4_tests::lcg;
+
+typedef std::vector<std::pair<size_t, size_t>> pairs_type;
+
+pairs_type sorted_pairs(pairs_type pairs){
+	for(auto& p : pairs){
+		if(p.second < p.first){
+			std::swap(p.first, p.second);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+template <class T, size_t D> pairs_type grid_pairs(const r4::uniform_grid<T, D>& grid){
+	pairs_type ret;
+	grid.for_each_pair([&ret](size_t a, size_t b){
+		ret.push_back(std::make_pair(a, b));
+	});
+	return sorted_pairs(ret);
+}
+
+bool overlap(const r4::rectangle<int>& a, const r4::rectangle<int>& b){
+	return !(a.x2() < b.p.x() || b.x2() < a.p.x() || a.y2() < b.p.y() || b.y2() < a.p.y());
+}
+
+// ids are indices of the rectangles, removed rectangles have zero size
+pairs_type brute_force_pairs(const std::vector<r4::rectangle<int>>& rects, const std::vector<bool>& removed){
+	pairs_type ret;
+	for(size_t i = 0; i != rects.size(); ++i){
+		for(size_t j = i + 1; j != rects.size(); ++j){
+			if(!removed[i] && !removed[j] && overlap(rects[i], rects[j])){
+				ret.push_back(std::make_pair(i, j));
+			}
+		}
+	}
+	return ret;
+}
+
+tst::set set("uniform_grid", [](tst::suite& suite){
+    suite.add("cell_of", []{
+        r4::uniform_grid<int, 2> grid(r4::vector2<int>(-100, 50), 10, {{20, 30}});
+
+		tst::check(grid.cell_of(r4::vector2<int>(-100, 50)) == std::array<size_t, 2>{{0, 0}}, SL);
+		tst::check(grid.cell_of(r4::vector2<int>(-91, 59)) == std::array<size_t, 2>{{0, 0}}, SL);
+		tst::check(grid.cell_of(r4::vector2<int>(-90, 60)) == std::array<size_t, 2>{{1, 1}}, SL);
+		tst::check(grid.cell_of(r4::vector2<int>(5, 123)) == std::array<size_t, 2>{{10, 7}}, SL);
+
+		// outside of grid
+		tst::check(grid.cell_of(r4::vector2<int>(-1000, 1000)) == std::array<size_t, 2>{{0, 29}}, SL);
+		tst::check(grid.cell_of(r4::vector2<int>(1000, -1000)) == std::array<size_t, 2>{{19, 0}}, SL);
+    });
+
+    suite.add("point_pairs", []{
+        r4::uniform_grid<float, 3> grid(r4::vector3<float>(0), 1, {{4, 4, 4}});
+
+		auto a = grid.insert(r4::vector3<float>(0.5f, 0.5f, 0.5f));
+		auto b = grid.insert(r4::vector3<float>(0.5f, 0.5f, 0.5f));
+		auto c = grid.insert(r4::vector3<float>(2.5f, 0.5f, 0.5f));
+		auto d = grid.insert(r4::vector3<float>(2.5f, 0.5f, 0.5f));
+		grid.insert(r4::vector3<float>(2.5f, 3.5f, 0.5f));
+
+		tst::check_eq(grid.size(), size_t(5), SL);
+		tst::check(grid_pairs(grid) == sorted_pairs({{a, b}, {c, d}}), SL);
+
+		// move within same cell
+		tst::check(!grid.update(b, r4::vector3<float>(0.7f, 0.5f, 0.5f)), SL);
+		tst::check(grid_pairs(grid) == sorted_pairs({{c, d}}), SL);
+
+		// move to other cell
+		tst::check(grid.update(b, r4::vector3<float>(2.5f, 0.5f, 0.5f)), SL);
+		tst::check(grid_pairs(grid) == sorted_pairs({{b, c}, {b, d}, {c, d}}), SL);
+
+		grid.remove(c);
+		tst::check(grid_pairs(grid) == sorted_pairs({{b, d}}), SL);
+		tst::check_eq(grid.size(), size_t(4), SL);
+    });
+
+    suite.add("rectangle_pairs_random", []{
+		r4::uniform_grid<int, 2> grid(r4::vector2<int>(0, 0), 16, {{32, 32}});
+
+		lcg rnd(17);
+
+		std::vector<r4::rectangle<int>> rects;
+		std::vector<bool> removed;
+		for(size_t i = 0; i != 400; ++i){
+			// some rectangles are partially outside of the grid
+			rects.push_back(r4::rectangle<int>(rnd.next(540) - 10, rnd.next(540) - 10, rnd.next(40), rnd.next(40)));
+			removed.push_back(false);
+			tst::check_eq(grid.insert(rects.back()), i, SL);
+		}
+
+		tst::check(grid_pairs(grid) == brute_force_pairs(rects, removed), SL);
+
+		// move some, remove some
+		for(size_t i = 0; i != rects.size(); ++i){
+			switch(i % 3){
+				case 0:
+					rects[i].p += r4::vector2<int>(rnd.next(11) - 5, rnd.next(11) - 5);
+					grid.update(i, rects[i]);
+					break;
+				case 1:
+					if(i % 2 == 0){
+						grid.remove(i);
+						removed[i] = true;
+					}
+					break;
+				default:
+					break;
+			}
+		}
+
+		tst::check(grid_pairs(grid) == brute_force_pairs(rects, removed), SL);
+
+		// query
+		for(size_t k = 0; k != 50; ++k){
+			r4::rectangle<int> q(rnd.next(540) - 20, rnd.next(540) - 20, rnd.next(100), rnd.next(100));
+
+			std::vector<size_t> found;
+			grid.query(q, [&found](size_t id){
+				found.push_back(id);
+			});
+			std::sort(found.begin(), found.end());
+
+			std::vector<size_t> expected;
+			for(size_t i = 0; i != rects.size(); ++i){
+				if(!removed[i] && overlap(rects[i], q)){
+					expected.push_back(i);
+				}
+			}
+
+			tst::check(found == expected, SL);
+		}
+
+		// removed ids are reused
+		auto id = grid.insert(r4::rectangle<int>(0, 0, 1, 1));
+		tst::check(removed[id], SL);
+    });
+
+    suite.add("cell_storage", []{
+        r4::uniform_grid<int, 2> grid(r4::vector2<int>(0, 0), 10, {{3, 3}});
+
+		auto a = grid.insert(r4::rectangle<int>(5, 5, 10, 10));
+		auto b = grid.insert(r4::vector2<int>(15, 15));
+
+		tst::check_eq(grid.get_cell({{0, 0}}).size(), size_t(1), SL);
+		tst::check_eq(grid.get_cell({{1, 0}}).size(), size_t(1), SL);
+		tst::check_eq(grid.get_cell({{0, 1}}).size(), size_t(1), SL);
+		tst::check_eq(grid.get_cell({{1, 1}}).size(), size_t(2), SL);
+		tst::check_eq(grid.get_cell({{2, 2}}).size(), size_t(0), SL);
+
+		grid.update(a, r4::rectangle<int>(25, 25, 1, 1));
+		tst::check_eq(grid.get_cell({{0, 0}}).size(), size_t(0), SL);
+		tst::check_eq(grid.get_cell({{1, 1}}).size(), size_t(1), SL);
+		tst::check_eq(grid.get_cell({{1, 1}})[0], b, SL);
+		tst::check_eq(grid.get_cell({{2, 2}})[0], a, SL);
+
+		grid.clear();
+		tst::check_eq(grid.size(), size_t(0), SL);
+		tst::check_eq(grid.get_cell({{2, 2}}).size(), size_t(0), SL);
+    });
+
+    suite.add("cell_storage_after_many_moves", []{
+        // cells grow and are moved and compacted many times
+		r4::uniform_grid<int, 2> grid(r4::vector2<int>(0, 0), 10, {{4, 4}});
+
+		lcg rnd(5);
+
+		std::vector<r4::vector2<int>> points;
+		for(size_t i = 0; i != 100; ++i){
+			points.push_back(r4::vector2<int>(rnd.next(40), rnd.next(40)));
+			grid.insert(points.back());
+		}
+
+		for(size_t frame = 0; frame != 50; ++frame){
+			// objects gather in one corner and then spread out
+			int max = frame % 10 < 5 ? 10 : 40;
+			for(size_t i = 0; i != points.size(); ++i){
+				points[i] = r4::vector2<int>(rnd.next(max), rnd.next(max));
+				grid.update(i, points[i]);
+			}
+
+			for(size_t y = 0; y != 4; ++y){
+				for(size_t x = 0; x != 4; ++x){
+					std::array<size_t, 2> cell = {{x, y}};
+					auto ids = grid.get_cell(cell);
+					std::vector<size_t> found(ids.begin(), ids.end());
+					std::sort(found.begin(), found.end());
+
+					std::vector<size_t> expected;
+					for(size_t i = 0; i != points.size(); ++i){
+						if(grid.cell_of(points[i]) == cell){
+							expected.push_back(i);
+						}
+					}
+
+					tst::check(found == expected, SL);
+				}
+			}
+		}
+    });
+});
+}
@@ -452,5 +452,14 @@ tst::set set("vector2", [](tst::suite& suite){
 
 		s.func(p);
     });
+
+    suite.add("constexpr_rotate", []{
+        constexpr auto v = r4::vector2<double>(3, 4).rot(utki::pi<double>() / 3);
+
+		auto rt = r4::vector2<double>(3, 4).rot(utki::pi<double>() / 3);
+
+		tst::check(std::abs(v.x() - rt.x()) < 1e-15, SL);
+		tst::check(std::abs(v.y() - rt.y()) < 1e-15, SL);
+    });
 });
 }
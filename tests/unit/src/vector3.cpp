@@ -349,6 +349,49 @@ tst::set set("vector3", [](tst::suite& suite){
 		tst::check_eq(r[2], 742, SL);
     });
 
+    suite.add("normalize_fast", []{
+        r4::vector3<float> v{2, 3, 4};
+
+		auto r = v.normed_fast();
+		auto cmp = v.normed();
+
+		for(size_t i = 0; i != 3; ++i){
+			tst::check_le(std::abs(r[i] - cmp[i]), 1e-6f, SL);
+		}
+
+		// zero vector is normalized same way as by normalize()
+		tst::check_eq(r4::vector3<float>(0).normalize_fast(), r4::vector3<float>(1, 0, 0), SL);
+
+		// norm of vector with tiny components underflows to denormal
+		auto tiny = r4::vector3<float>(3e-20f, 0, 4e-20f).normalize_fast();
+		tst::check_le(std::abs(tiny.x() - 0.6f), 1e-6f, SL);
+		tst::check_le(std::abs(tiny.z() - 0.8f), 1e-6f, SL);
+
+		auto d = r4::vector3<double>(0, 3, 4).normalize_fast() - r4::vector3<double>(0, 0.6, 0.8);
+		tst::check_le(d.norm(), 1e-15, SL);
+    });
+
+    suite.add("normalize_fast_span", []{
+        std::vector<r4::vector3<float>> a;
+		for(int i = 0; i != 13; ++i){
+			a.push_back(r4::vector3<float>(float(i % 5) - 2, float(i % 3), float(i * i) / 7) * float(i + 1));
+		}
+		a[6] = r4::vector3<float>(0);
+
+		auto cmp = a;
+
+		normalize_fast(utki::make_span(a));
+
+		for(size_t i = 0; i != a.size(); ++i){
+			tst::check_le(std::abs(a[i].norm() - 1), 1e-6f, SL);
+			cmp[i].normalize();
+			for(size_t j = 0; j != 3; ++j){
+				tst::check_le(std::abs(a[i][j] - cmp[i][j]), 1e-6f, SL);
+			}
+		}
+		tst::check_eq(a[6], r4::vector3<float>(1, 0, 0), SL);
+    });
+
     suite.add("project_vector3", []{
         r4::vector3<float> a{2, 3, 4};
 		r4::vector3<float> b{5, 6, 7};
@@ -376,6 +419,41 @@ tst::set set("vector3", [](tst::suite& suite){
 		tst::check_eq(r[2], 4672, SL);
     });
 
+    suite.add("rotate_quaternion_equals_rotation_by_matrix", []{
+        r4::vector3<double> a{2, 3, 4};
+		r4::quaternion<double> q{r4::vector3<double>{-0.3, 0.2, 0.5}};
+
+		auto r = a;
+		r.rotate(q);
+
+		auto cmp = q.to_matrix<3>() * a;
+
+		tst::check_eq(round(r * 1e6), round(cmp * 1e6), SL);
+    });
+
+    suite.add("rotate_span_quaternion", []{
+        std::vector<r4::vector3<float>> a = {
+			{2, 3, 4},
+			{-1, 0, 2},
+			{0, 0, 0}
+		};
+
+		r4::quaternion<float> q{r4::vector3<float>{1, 2, 3}};
+
+		rotate(utki::make_span(a), q);
+
+		auto r = (a[0] * 1000.0f).to<int>();
+
+		tst::check_eq(r[0], 1107, SL);
+		tst::check_eq(r[1], 2437, SL);
+		tst::check_eq(r[2], 4672, SL);
+
+		auto cmp = r4::vector3<float>{-1, 0, 2}.rotate(q);
+		tst::check_eq(round(a[1] * 1000.0f), round(cmp * 1000.0f), SL);
+
+		tst::check(a[2].is_zero(), SL);
+    });
+
     suite.add("min_vector3_vector3", []{
         r4::vector3<int> a{2, 3, 4};
 		r4::vector3<int> b{5, 1, -5};
@@ -397,5 +475,47 @@ tst::set set("vector3", [](tst::suite& suite){
 		tst::check_eq(r[1], 3, SL);
 		tst::check_eq(r[2], -4, SL);
     });
+
+    suite.add("mul_add_vector3_vector3", []{
+        r4::vector3<int> v{1, 2, 3};
+
+		v.mul_add(r4::vector3<int>{2, 3, 4}, r4::vector3<int>{5, -1, 0});
+
+		tst::check_eq(v, r4::vector3<int>{11, -1, 3}, SL);
+    });
+
+    suite.add("mul_add_vector3_number", []{
+        r4::vector3<int> v{1, 2, 3};
+
+		v.mul_add(r4::vector3<int>{2, 3, 4}, 3);
+
+		tst::check_eq(v, r4::vector3<int>{7, 11, 15}, SL);
+    });
+
+    suite.add("fma_vector3", []{
+        r4::vector3<int> a{2, 3, 4};
+		r4::vector3<int> c{1, 2, 3};
+
+		tst::check_eq(fma(a, r4::vector3<int>{5, -1, 0}, c), r4::vector3<int>{11, -1, 3}, SL);
+		tst::check_eq(fma(a, -2, c), r4::vector3<int>{-3, -4, -5}, SL);
+    });
+
+    suite.add("fma_vector3_single_rounding", []{
+        // (1 + e) * (1 - e) - 1 = -e^2, while the product rounded before the addition gives exactly 1
+		const double e = std::ldexp(1.0, -30);
+		r4::vector3<double> a{1 + e, 1, 2};
+		r4::vector3<double> b{1 - e, 1, 3};
+		r4::vector3<double> c{-1, -1, 1};
+
+		auto r = fma(a, b, c);
+
+		if(r4::internal::has_fast_fma<double>()){
+			tst::check_eq(r[0], -e * e, SL);
+		}else{
+			tst::check_eq(r[0], 0.0, SL);
+		}
+		tst::check_eq(r[1], 0.0, SL);
+		tst::check_eq(r[2], 7.0, SL);
+    });
 });
 }
@@ -5,8 +5,20 @@
 
 // declare templates to instantiate all template methods to include all methods to gcov coverage
 template class r4::vector<int, 4>;
+template class r4::vector<float, 4>;
+template class r4::vector<double, 4>;
 
 namespace{
+// std::array::operator==() is not constexpr in C++17
+template <typename T> constexpr bool is_equal(const r4::vector4<T>& a, const r4::vector4<T>& b){
+	for(size_t i = 0; i != 4; ++i){
+		if(a[i] != b[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
 tst::set set("vector4", [](tst::suite& suite){
     suite.add("constructor_x_y_z_w", []{
         r4::vector4<int> v{3, 4, 5, 6};
@@ -434,6 +446,44 @@ tst::set set("vector4", [](tst::suite& suite){
 		tst::check_eq(r[3], 646, SL);
     });
 
+    suite.add("normalize_fast", []{
+        r4::vector4<float> v4{3, 4, 5, 6};
+
+		auto r = v4.normed_fast();
+		auto cmp = v4.normed();
+
+		for(size_t i = 0; i != 4; ++i){
+			tst::check_le(std::abs(r[i] - cmp[i]), 1e-6f, SL);
+		}
+
+		tst::check_eq(r4::vector4<float>(0).normalize_fast(), r4::vector4<float>(1, 0, 0, 0), SL);
+
+		constexpr auto ct = r4::vector4<double>(0, 0, 2, 0).normed_fast();
+		static_assert(is_equal(ct, r4::vector4<double>(0, 0, 1, 0)), "");
+    });
+
+    suite.add("normalize_fast_span", []{
+        std::vector<r4::vector4<float>> a;
+		for(int i = 0; i != 11; ++i){
+			a.push_back(r4::vector4<float>(float(i % 5) - 2, float(i % 3), float(i * i) / 7, 1) * float(i + 1));
+		}
+		// zero vector in the middle of group of 4 vectors
+		a[5] = r4::vector4<float>(0);
+
+		auto cmp = a;
+
+		normalize_fast(utki::make_span(a));
+
+		for(size_t i = 0; i != a.size(); ++i){
+			tst::check_le(std::abs(a[i].norm() - 1), 1e-6f, SL);
+			cmp[i].normalize();
+			for(size_t j = 0; j != 4; ++j){
+				tst::check_le(std::abs(a[i][j] - cmp[i][j]), 1e-6f, SL);
+			}
+		}
+		tst::check_eq(a[5], r4::vector4<float>(1, 0, 0, 0), SL);
+    });
+
     suite.add("min_vector4_vector4", []{
         r4::vector4<int> a{2, 3, 4, -6};
 		r4::vector4<int> b{5, 1, -5, -7};
@@ -457,5 +507,119 @@ tst::set set("vector4", [](tst::suite& suite){
 		tst::check_eq(r[2], -4, SL);
 		tst::check_eq(r[3], -6, SL);
     });
+
+    suite.add("simd_float_arithmetic", []{
+        r4::vector4<float> a{1.5f, -2, 3, -4};
+		r4::vector4<float> b{2, 4, -0.5f, 8};
+
+		tst::check_eq(a + b, r4::vector4<float>{3.5f, 2, 2.5f, 4}, SL);
+		tst::check_eq(a - b, r4::vector4<float>{-0.5f, -6, 3.5f, -12}, SL);
+		tst::check_eq(a * 2.0f, r4::vector4<float>{3, -4, 6, -8}, SL);
+		tst::check_eq(a / 2.0f, r4::vector4<float>{0.75f, -1, 1.5f, -2}, SL);
+		tst::check_eq(a * b, -38.5f, SL);
+		tst::check_eq(a.comp_mul(b), r4::vector4<float>{3, -8, -1.5f, -32}, SL);
+		tst::check_eq(a.comp_div(b), r4::vector4<float>{0.75f, -0.5f, -6, -0.5f}, SL);
+		tst::check_eq(-a, r4::vector4<float>{-1.5f, 2, -3, 4}, SL);
+		tst::check_eq(abs(a), r4::vector4<float>{1.5f, 2, 3, 4}, SL);
+		tst::check_eq(min(a, b), r4::vector4<float>{1.5f, -2, -0.5f, -4}, SL);
+		tst::check_eq(max(a, b), r4::vector4<float>{2, 4, 3, 8}, SL);
+		tst::check_eq(a.norm_pow2(), 31.25f, SL);
+    });
+
+    suite.add("simd_double_arithmetic", []{
+        r4::vector4<double> a{1.5, -2, 3, -4};
+		r4::vector4<double> b{2, 4, -0.5, 8};
+
+		tst::check_eq(a + b, r4::vector4<double>{3.5, 2, 2.5, 4}, SL);
+		tst::check_eq(a - b, r4::vector4<double>{-0.5, -6, 3.5, -12}, SL);
+		tst::check_eq(a * 2.0, r4::vector4<double>{3, -4, 6, -8}, SL);
+		tst::check_eq(a / 2.0, r4::vector4<double>{0.75, -1, 1.5, -2}, SL);
+		tst::check_eq(a * b, -38.5, SL);
+		tst::check_eq(a.comp_mul(b), r4::vector4<double>{3, -8, -1.5, -32}, SL);
+		tst::check_eq(a.comp_div(b), r4::vector4<double>{0.75, -0.5, -6, -0.5}, SL);
+		tst::check_eq(-a, r4::vector4<double>{-1.5, 2, -3, 4}, SL);
+		tst::check_eq(abs(a), r4::vector4<double>{1.5, 2, 3, 4}, SL);
+		tst::check_eq(min(a, b), r4::vector4<double>{1.5, -2, -0.5, -4}, SL);
+		tst::check_eq(max(a, b), r4::vector4<double>{2, 4, 3, 8}, SL);
+		tst::check_eq(a.norm_pow2(), 31.25, SL);
+    });
+
+    suite.add("simd_in_place_arithmetic", []{
+        r4::vector4<float> v{1, 2, 3, 4};
+
+		v += r4::vector4<float>{1, 1, 1, 1};
+		v -= 0.5f;
+		v *= 2.0f;
+		v += 1.0f;
+		v /= 2.0f;
+		v -= r4::vector4<float>{0.5f, 0.5f, 0.5f, 0.5f};
+		v.comp_multiply(r4::vector4<float>{2, 2, 2, 2});
+		v.comp_divide(r4::vector4<float>{1, 2, 4, 8});
+		v.negate();
+
+		tst::check_eq(v, r4::vector4<float>{-3, -2.5f, -1.75f, -1.125f}, SL);
+    });
+
+    suite.add("rotate_quaternion", []{
+        r4::vector4<float> a{2, 3, 4, 5};
+
+		a.rotate(r4::quaternion<float>{r4::vector3<float>{1, 2, 3}}) *= 1000.0f;
+
+		auto r = a.to<int>();
+
+		tst::check_eq(r[0], 1107, SL);
+		tst::check_eq(r[1], 2437, SL);
+		tst::check_eq(r[2], 4672, SL);
+		tst::check_eq(r[3], 5000, SL);
+    });
+
+    suite.add("constexpr_evaluation", []{
+        // the SIMD implementation is bypassed during constant evaluation
+		constexpr r4::vector4<float> a{1, -2, 3, -4};
+		constexpr r4::vector4<float> b{5, 6, -7, 8};
+
+		constexpr auto sum = a + b;
+		static_assert(is_equal(sum, r4::vector4<float>(6, 4, -4, 4)), "");
+
+		constexpr auto dot = a * b;
+		static_assert(dot == 5 - 12 - 21 - 32, "");
+
+		constexpr auto scaled = (a - b) * 2.0f / 4.0f;
+		static_assert(is_equal(scaled, r4::vector4<float>(-2, -4, 5, -6)), "");
+
+		constexpr auto cmp = max(abs(a), min(a, b).comp_mul(b));
+		static_assert(is_equal(cmp, r4::vector4<float>(5, 2, 49, 4)), "");
+
+		constexpr auto n = r4::vector4<double>(1, 2, 2, 4).norm();
+		static_assert(n == 5, "");
+
+		// compile time results are same as run time ones
+		auto rt_a = a;
+		tst::check_eq(rt_a + b, sum, SL);
+		tst::check_eq(rt_a * b, dot, SL);
+		tst::check_eq((rt_a - b) * 2.0f / 4.0f, scaled, SL);
+		tst::check_eq(max(abs(rt_a), min(rt_a, b).comp_mul(b)), cmp, SL);
+    });
+
+    suite.add("mul_add_vector4", []{
+        r4::vector4<float> v{1, 2, 3, 4};
+
+		v.mul_add(r4::vector4<float>{2, 3, 4, 5}, r4::vector4<float>{5, -1, 0, 2});
+		tst::check_eq(v, r4::vector4<float>{11, -1, 3, 14}, SL);
+
+		v.mul_add(r4::vector4<float>{1, 2, 3, 4}, 0.5f);
+		tst::check_eq(v, r4::vector4<float>{11.5f, 0, 4.5f, 16}, SL);
+    });
+
+    suite.add("fma_vector4", []{
+        r4::vector4<double> a{2, 3, 4, 5};
+		r4::vector4<double> c{1, 2, 3, 4};
+
+		tst::check_eq(fma(a, r4::vector4<double>{5, -1, 0, 2}, c), r4::vector4<double>{11, -1, 3, 14}, SL);
+		tst::check_eq(fma(a, -2.0, c), r4::vector4<double>{-3, -4, -5, -6}, SL);
+
+		constexpr auto ct = fma(r4::vector4<int>{2, 3, 4, 5}, 3, r4::vector4<int>{1, 1, 1, 1});
+		static_assert(is_equal(ct, r4::vector4<int>(7, 10, 13, 16)), "");
+    });
 });
 }